@@ -0,0 +1,101 @@
+#include <Arduino.h>
+#include "prism/prism.h"
+#include "prism/prism_dsp.h"
+
+// Measures the throughput of the DSP kernels on the connected coprocessor and
+// prints samples per second for every kernel. The figures depend on the link
+// (P²Link, SPI or I²C), its clock and the host, so run the sketch on the
+// target hardware instead of relying on published numbers.
+
+#define SAMPLES 64
+#define TIMEOUT 1000
+
+prdev_t device;
+
+si32 input[SAMPLES + 8];
+si32 output[SAMPLES];
+
+// 8-tap low-pass filter in Q15
+const si32 taps[8] = {1310, 3277, 5571, 6226, 6226, 5571, 3277, 1310};
+
+static void report(const char *name, prism_err err, unsigned long start,
+                   size_t samples) {
+    unsigned long elapsed = micros() - start;
+
+    Serial.print(name);
+    if (err != PR_OK) {
+        Serial.print(": error ");
+        Serial.println(err);
+        return;
+    }
+    Serial.print(": ");
+    Serial.print(samples);
+    Serial.print(" samples in ");
+    Serial.print(elapsed);
+    Serial.print(" us, ");
+    Serial.print(elapsed ? (float)samples * 1000000.0f / elapsed : 0.0f);
+    Serial.println(" samples/s");
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        ; // wait for serial port to connect. Needed for native USB port only
+    }
+    Serial.println("Prism DSP benchmark");
+
+    prism_err err = prism_device_create(0x52, true, NULL, &device);
+    if (err != PR_OK) {
+        Serial.print("Error creating Prism device: ");
+        Serial.println(err);
+        while (true) {
+        }
+    }
+
+    // A Q15 test tone
+    for (int i = 0; i < SAMPLES + 8; i++) {
+        input[i] = (si32)(16384.0f * sin(i * 0.2f));
+    }
+}
+
+void loop() {
+    prism_err err;
+    unsigned long start;
+
+    // FIR: coefficients resident in bank B, every output one MUL
+    prism_fir_t fir;
+    err = prism_fir_init(&fir, &device, taps, 8, 15, TIMEOUT);
+    start = micros();
+    if (err == PR_OK) {
+        err = prism_fir_process(&fir, input, output, SAMPLES);
+    }
+    report("FIR 8 taps", err, start, SAMPLES);
+
+    // Dot product of the tone with itself
+    int64_t dot = 0;
+    start = micros();
+    err = prism_dot_si32(&device, input, input, SAMPLES, &dot, TIMEOUT);
+    report("Dot product", err, start, SAMPLES);
+
+    // MAC: eight lanes accumulate scaled vectors on the device
+    prism_mac_t mac;
+    si32 acc[8];
+    start = micros();
+    err = prism_mac_begin_si32(&mac, &device, 0, TIMEOUT);
+    for (int i = 0; err == PR_OK && i + 8 <= SAMPLES; i += 8) {
+        err = prism_mac_push_si32(&mac, &input[i], 3);
+    }
+    if (err == PR_OK) {
+        err = prism_mac_end_si32(&mac, acc);
+    }
+    report("MAC", err, start, SAMPLES);
+
+    // Moving average over 8 samples
+    start = micros();
+    err = prism_moving_average_si32(&device, input, SAMPLES + 7, 8, output,
+                                    TIMEOUT);
+    report("Moving average 8", err, start, SAMPLES);
+
+    Serial.println();
+    delay(5000);
+}
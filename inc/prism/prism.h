@@ -58,6 +58,56 @@
 #define PRISM_OPCODE_ARCH_RESET                                                \
   (0x05)                             // Get the full version of the Prism device
 #define PRISM_OPCODE_ARCH_END (0x06) // Get the architecture of the Prism device
+#define PRISM_OPCODE_ARCH_DESCRIBE                                             \
+  (0x07) // Version, flank and capabilities in one read
+#define PRISM_OPCODE_ARCH_LINK_CRC                                             \
+  (0x08) // Bank data carries a CRC-16, arg 1 to enable, 0 to disable
+#define PRISM_OPCODE_ARCH_PEEK                                                 \
+  (0x09) // One nibble of a bank as the status byte, arg bank << 6 | nibble
+
+// Status byte of PRISM_OPCODE_ARCH_PEEK: the tag in the high nibble, the
+// nibble of the bank in the low one
+#define PRISM_PEEK_TAG (0x40)
+
+// Protocol version reported by PRISM_OPCODE_ARCH_DESCRIBE, 0 for devices that
+// do not know the opcode
+#define PRISM_PROTOCOL_VERSION (1)
+// Bytes of the descriptor read after PRISM_OPCODE_ARCH_DESCRIBE
+#define PRISM_DESCRIBE_SIZE (12)
+
+// Lane types of prism_describe_t.lane_types
+#define PRISM_LANE_UI32 (1U << 0)
+#define PRISM_LANE_SI32 (1U << 1)
+#define PRISM_LANE_UI16 (1U << 2)
+#define PRISM_LANE_SI16 (1U << 3)
+#define PRISM_LANE_UI8 (1U << 4)
+#define PRISM_LANE_SI8 (1U << 5)
+#define PRISM_LANE_UI4 (1U << 6)
+#define PRISM_LANE_SI4 (1U << 7)
+#define PRISM_LANE_UI64 (1U << 8)
+#define PRISM_LANE_UI128 (1U << 9)
+#define PRISM_LANE_UI256 (1U << 10)
+#define PRISM_LANE_FL (1U << 11)
+#define PRISM_LANE_HF (1U << 12)
+
+// Features of prism_describe_t.features
+#define PRISM_FEATURE_SCALAR (1UL << 0)   // PRISM_OPCODE_*_S immediates
+#define PRISM_FEATURE_SPLAT (1UL << 1)    // PRISM_OPCODE_SPLAT_A/B
+#define PRISM_FEATURE_COMPARE (1UL << 2)  // PRISM_OPCODE_CMP_* and CPL2
+#define PRISM_FEATURE_SHIFT (1UL << 3)    // PRISM_OPCODE_SHIFT_L/R
+#define PRISM_FEATURE_NOCLEAR (1UL << 4)  // PRISM_OPCODE_NOCLEAR_AFTEROP
+#define PRISM_FEATURE_EXCHANGE (1UL << 5) // PRISM_OPCODE_EXCHANGE
+#define PRISM_FEATURE_CRC (1UL << 6)      // PRISM_OPCODE_ARCH_LINK_CRC
+#define PRISM_FEATURE_PEEK (1UL << 7)     // PRISM_OPCODE_ARCH_PEEK
+
+// What a device without PRISM_OPCODE_ARCH_DESCRIBE is assumed to support:
+// the opcodes of the firmware from before the describe query. Immediates and
+// splats came later and are emulated there.
+#define PRISM_LANES_BASE                                                       \
+  (PRISM_LANE_UI32 | PRISM_LANE_SI32 | PRISM_LANE_UI16 | PRISM_LANE_SI16 |     \
+   PRISM_LANE_UI8 | PRISM_LANE_SI8)
+#define PRISM_FEATURES_BASE                                                    \
+  (PRISM_FEATURE_COMPARE | PRISM_FEATURE_SHIFT | PRISM_FEATURE_NOCLEAR)
 
 // opcodes for PRISM SIMD
 #define PRISM_OPCODE_TYPE_UI32 (0xD0)
@@ -103,6 +153,7 @@
 #define PRISM_OPCODE_LOAD_D (0x5B)  // bank d to vector
 #define PRISM_OPCODE_LOAD_A (0x5C)  // bank a to vector
 #define PRISM_OPCODE_LOAD_B (0x5D)  // bank b to vector
+#define PRISM_OPCODE_EXCHANGE (0x5E) // bank to vector while vector to bank
 
 #define PRISM_OPCODE_END                                                       \
   (0x5F) // End of opcode sequence -- internal use only, not for public use
@@ -124,19 +175,32 @@
 #define PRISM_OPCODE_SHIFT_L (0x77) // Shift left
 #define PRISM_OPCODE_SHIFT_R (0x78) // Shift right
 
+// Scalar-immediate opcodes: bank C = bank A op imm, the 32-bit immediate
+// travels in the command frame instead of a bank B upload
+#define PRISM_OPCODE_ADD_S (0x31)
+#define PRISM_OPCODE_SUB_S (0x32)
+#define PRISM_OPCODE_MUL_S (0x33)
+#define PRISM_OPCODE_DIV_S (0x34)
+#define PRISM_OPCODE_AND_S (0x35)
+#define PRISM_OPCODE_NAND_S (0x36)
+#define PRISM_OPCODE_OR_S (0x37)
+#define PRISM_OPCODE_XOR_S (0x38)
+#define PRISM_OPCODE_NOR_S (0x39)
+
+#define PRISM_OPCODE_CMP_EQ_S (0x79) // Compare equal with immediate
+#define PRISM_OPCODE_CMP_NE_S (0x7A) // Compare not equal with immediate
+#define PRISM_OPCODE_CMP_GT_S (0x7B) // Compare greater than immediate
+#define PRISM_OPCODE_CMP_GE_S (0x7C) // Compare greater or equal immediate
+#define PRISM_OPCODE_CMP_LT_S (0x7D) // Compare less than immediate
+#define PRISM_OPCODE_CMP_LE_S (0x7E) // Compare less or equal immediate
+
+#define PRISM_OPCODE_SPLAT_A (0x56) // immediate to every lane of bank a
+#define PRISM_OPCODE_SPLAT_B (0x57) // immediate to every lane of bank b
+
 #if __cplusplus
 extern "C" {
 #endif // __cplusplus
 
-#if PRISM_ENABLE_64BIT_EXT == 1
-typedef uint64_t ui64;
-typedef int64_t si64;
-#if PRISM_ENABLE_LONGTYPES == 1
-typedef uint128_t ui128;
-typedef int128_t si128;
-#endif // PRISM_ENABLE_LONGTYPES
-#endif // PRISM_ENABLE_64BIT_EXT
-
 typedef uint8_t ui8;
 typedef uint16_t ui16;
 typedef uint32_t ui32;
@@ -145,6 +209,21 @@ typedef int8_t si8;
 typedef int16_t si16;
 typedef int32_t si32;
 
+#if PRISM_ENABLE_64BIT_EXT == 1
+typedef uint64_t ui64;
+typedef int64_t si64;
+#if PRISM_ENABLE_LONGTYPES == 1
+// No supported compiler has 128- or 256-bit integers. The long types are
+// arrays of 32-bit limbs, limb 0 is the least significant one.
+typedef struct prism_ui128 {
+  ui32 limb[4];
+} ui128;
+typedef struct prism_ui256 {
+  ui32 limb[8];
+} ui256;
+#endif // PRISM_ENABLE_LONGTYPES
+#endif // PRISM_ENABLE_64BIT_EXT
+
 typedef ui32 timeout_t;
 
 typedef enum {
@@ -152,7 +231,9 @@ typedef enum {
   PR_ERR_INVALID_ARGUMENT,
   PR_ERR_OUT_OF_MEMORY,
   PR_ERR_UNSUPPORTED_OPERATION,
-  PR_ERR_UNKNOWN
+  PR_ERR_UNKNOWN,
+  PR_ERR_LINK, // Bank data failed its CRC on every attempt
+  PR_ERR_STALE // The bank of a lazy load was written before it was read
 } prism_err;
 
 /**
@@ -169,7 +250,9 @@ typedef enum {
  * array of 16 signed 16-bit integers. The `uib` field is an array of 32
  * unsigned 8-bit integers, and `sib` is an array of 32 signed 8-bit integers.
  * This structure is used in the Prism architecture for SIMD operations and can
- * be extended for additional types.
+ * be extended for additional types. With PRISM_ENABLE_IEE754 the `fl` field
+ * holds 8 single-precision floats and `hf` 16 half-precision floats, see
+ * prism/prism_float.h for the conversions.
  * @note The structure is designed to be compatible with SIMD operations and
  * allows for efficient data manipulation.
  */
@@ -181,6 +264,10 @@ typedef struct prism256i_type {
     si16 six[16];
     ui8 uib[32]; // 4x8-bit unsigned integers
     si8 sib[32]; // 4x8-bit signed integers
+#ifdef PRISM_ENABLE_IEE754
+    float fl[8]; // IEEE754 binary32, PRISM_OPCODE_TYPE_FL lanes
+    ui16 hf[16]; // IEEE754 binary16 bit patterns, PRISM_OPCODE_TYPE_HF
+#endif
   };
 } _v256i;
 
@@ -221,6 +308,20 @@ typedef enum prism_bank_enum {
 #define PRISM_PIN_9HIGH_DEFAULT 10  // D10
 #define PRISM_PIN_10HIGH_DEFAULT 11 // D11
 
+// Link used for command frames and bank data
+#define PRISM_MODE_P2LINK (0x00) // I2C commands, P²Link bank data
+#define PRISM_MODE_SPI (0x01)    // Commands and bank data over hardware SPI
+#define PRISM_MODE_I2C (0x02)    // Commands and bank data over I2C only
+
+// Chip select and clock of the SPI link
+#define PRISM_PIN_CS_DEFAULT SS
+#define PRISM_SPI_CLOCK_DEFAULT 8000000UL // 8 MHz
+
+// I2C bus clocks for prism_dev_config_t.i2cClock
+#define PRISM_I2C_CLOCK_STANDARD 100000UL   // Standard-mode, Wire default
+#define PRISM_I2C_CLOCK_FAST 400000UL       // Fast-mode
+#define PRISM_I2C_CLOCK_FAST_PLUS 1000000UL // Fast-mode Plus
+
 typedef struct prism_dev_config {
   uint8_t pin1low;   // Pin 1 configuration
   uint8_t pin2low;   // Pin 2 configuration
@@ -232,8 +333,76 @@ typedef struct prism_dev_config {
   uint8_t pin8high;  // Pin 8 configuration
   uint8_t pin9high;  // Pin 9 configuration
   uint8_t pin10high; // Pin 10 configuration
+  uint8_t mode;      // PRISM_MODE_*, anything else selects P2LINK
+  uint8_t spiCs;     // SPI chip select pin
+  uint32_t spiClock; // SPI clock in Hz, 0 selects PRISM_SPI_CLOCK_DEFAULT
+  uint32_t i2cClock; // PRISM_I2C_CLOCK_*, anything else keeps the Wire
+                     // default
 } prism_dev_config_t;
 
+/**
+ * @brief Fills a configuration with the values prism_device_create uses when
+ * it gets none: the default P²Link pins, PRISM_MODE_P2LINK and the default
+ * SPI chip select and clock. Start from it and change only the fields the
+ * sketch needs; a configuration filled field by field on the stack leaves
+ * the others undefined.
+ * @param config The configuration to fill.
+ */
+extern void prism_dev_config_default(prism_dev_config_t *config);
+
+struct prism_dev_type;
+
+/**
+ * @brief Transport backend of a Prism device.
+ * A backend carries the command frames and the bank data between host and
+ * coprocessor. The library only talks to the device through these four
+ * functions, so links can be swapped without touching the _v256_* API.
+ * Bank data is a sequence of 32-bit little-endian entries.
+ */
+typedef struct prism_transport {
+  const char *name; // Human readable name of the backend
+  // Writes one command frame
+  prism_err (*send_command)(const struct prism_dev_type *device,
+                            const uint8_t *frame, size_t len);
+  // Waits for the device to process the last frame and reads its status
+  prism_err (*read_status)(const struct prism_dev_type *device,
+                           uint8_t *status);
+  // Writes len bytes of bank data
+  prism_err (*write_block)(const struct prism_dev_type *device,
+                           const uint8_t *data, size_t len);
+  // Reads len bytes of bank data
+  prism_err (*read_block)(const struct prism_dev_type *device, uint8_t *data,
+                          size_t len);
+  // Optional: writes and reads len bytes of bank data at the same time, 0 for
+  // half-duplex links
+  prism_err (*exchange_block)(const struct prism_dev_type *device,
+                              const uint8_t *out, uint8_t *in, size_t len);
+  // Optional: brings up the link before the first frame, 0 if not needed
+  prism_err (*begin)(const struct prism_dev_type *device);
+  // Optional: reads the status without waiting, PRISM_STATUS_BUSY while the
+  // device is still processing. 0 if the link can only wait.
+  prism_err (*poll_status)(const struct prism_dev_type *device,
+                           uint8_t *status);
+} prism_transport_t;
+
+// Attempts after the first one for a bank transfer that fails its CRC
+#ifndef PRISM_LINK_RETRIES
+#define PRISM_LINK_RETRIES (3)
+#endif
+
+/**
+ * @brief Integrity counters of the bank transfers of a device.
+ * A block is the 32 bytes of one bank in one direction. With the link CRC
+ * enabled every block is followed by a CRC-16 that the receiver checks, and
+ * only the block that failed is sent again.
+ */
+typedef struct prism_link_stats {
+  uint32_t blocks;     // Blocks transferred, retransmissions included
+  uint32_t crc_errors; // Blocks that failed their CRC
+  uint32_t retries;    // Blocks sent again after a CRC error
+  uint32_t failures;   // Blocks given up after PRISM_LINK_RETRIES
+} prism_link_stats_t;
+
 typedef struct prism_dev_type {
   uint8_t address;           // I2C address of the device
   prism_dev_config_t config; // Device configuration
@@ -241,18 +410,171 @@ typedef struct prism_dev_type {
   uint8_t major;
   uint8_t minor;
   uint8_t patch;
+  uint8_t protocol;    // PRISM_PROTOCOL_VERSION of the device, 0 if older
+  uint16_t lane_types; // Lane types the device computes, PRISM_LANE_* bits
+  uint32_t features;   // Optional opcodes the device knows, PRISM_FEATURE_*
+  uint8_t link_crc;    // Bank data carries a CRC-16, see prism_link_crc
+  uint8_t clears_ab;   // The device clears A and B after every operation
+  prism_link_stats_t link;             // Bank transfer counters
+  uint32_t bank_epoch[PRISM_BANK_MAX]; // Writes per bank, see prism_lazy_t
+  const prism_transport_t *transport; // Transport backend
+  void *transport_ctx;                // Backend state, owned by the caller
 } prdev_t;
 
+/**
+ * @brief Identity and capabilities of a Prism device.
+ * Read with one PRISM_OPCODE_ARCH_DESCRIBE frame. On the wire the fields are
+ * PRISM_DESCRIBE_SIZE bytes in this order, multi-byte fields little-endian.
+ */
+typedef struct prism_describe {
+  uint8_t major;
+  uint8_t minor;
+  uint8_t patch;
+  uint8_t flank;       // Flank speed variable
+  uint8_t protocol;    // PRISM_PROTOCOL_VERSION, 0 for older devices
+  uint8_t banks;       // Number of banks
+  uint16_t lane_types; // PRISM_LANE_* bits
+  uint32_t features;   // PRISM_FEATURE_* bits
+} prism_describe_t;
+
+// Range of I²C addresses that are not reserved
+#define PRISM_BUS_FIRST (0x08)
+#define PRISM_BUS_LAST (0x77)
+
+/**
+ * @brief A device found by prism_bus_scan.
+ */
+typedef struct prism_bus_entry {
+  uint8_t address;
+  prism_describe_t describe;
+} prism_bus_entry_t;
+
 //============================
 // Stop ARDUINO Änderungen
 //============================
 
+/**
+ * @brief Creates a Prism device and reads its capabilities.
+ * @param address The I²C address of the device.
+ * @param wireInit true to start Wire first.
+ * @param config The link and pins, or 0 for the prism_dev_config_default
+ * values. Fill it with prism_dev_config_default before changing fields: the
+ * library cannot tell a stray value in an unset field from a real setting
+ * when it is a valid one, such as PRISM_MODE_SPI.
+ * @param device The device to initialize.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
 prism_err prism_device_create(const uint8_t address, bool wireInit,
                               const prism_dev_config_t *config,
                               prdev_t *device);
+
+/**
+ * @brief Creates a Prism device on a custom transport backend.
+ * Works like prism_device_create, but the device is reached through the given
+ * backend instead of I²C and P²Link, e.g. prism_transport_loopback.
+ * @param address The address of the device on the backend.
+ * @param transport The transport backend.
+ * @param ctx Backend state, passed to the backend through the device.
+ * @param device The device to initialize.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+prism_err prism_device_create_with(const uint8_t address,
+                                   const prism_transport_t *transport,
+                                   void *ctx, prdev_t *device);
 prism_err prism_device_stop(const prdev_t *device);
 prism_err prism_device_reset(const prdev_t *device);
 
+/**
+ * @brief Enables or disables the CRC-16 on bank data.
+ * prism_device_create enables it for every device that reports
+ * PRISM_FEATURE_CRC. A block whose CRC does not match is sent again up to
+ * PRISM_LINK_RETRIES times before the transfer fails with PR_ERR_LINK.
+ * @param device Pointer to the Prism device structure.
+ * @param enable true to check every block, false for the plain protocol.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, PR_ERR_UNSUPPORTED_OPERATION if the device has no
+ * PRISM_FEATURE_CRC.
+ */
+prism_err prism_link_crc(prdev_t *device, const bool enable,
+                         timeout_t timeout);
+
+/**
+ * @brief Reads the bank transfer counters of a device.
+ * @param device Pointer to the Prism device structure.
+ * @param stats Receives the counters.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+prism_err prism_link_stats(const prdev_t *device, prism_link_stats_t *stats);
+
+/**
+ * @brief Clears the bank transfer counters of a device.
+ */
+void prism_link_stats_reset(prdev_t *device);
+
+/**
+ * @brief Reads version, flank and capabilities of a device in one command.
+ * @param device Pointer to the Prism device structure.
+ * @param out Receives the descriptor.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, PR_ERR_UNSUPPORTED_OPERATION if the device does
+ * not know PRISM_OPCODE_ARCH_DESCRIBE, or another error code.
+ */
+prism_err prism_device_describe(const prdev_t *device, prism_describe_t *out,
+                                timeout_t timeout);
+
+/**
+ * @brief Checks whether a device can run an opcode on a lane type.
+ * The capabilities are read once by prism_device_create. Every frame is
+ * checked before it is sent; unsupported frames fail with
+ * PR_ERR_UNSUPPORTED_OPERATION. Scalar immediates and splats are emulated with
+ * a bank transfer where the device lacks them, exchanges fall back to a load
+ * and a store.
+ * @param device Pointer to the Prism device structure.
+ * @param op The opcode.
+ * @param type The lane type, only checked for lane operations.
+ * @return true if the device knows the opcode and the lane type.
+ */
+bool prism_device_supports(const prdev_t *device, const uint16_t op,
+                           const ui8 type);
+
+/**
+ * @brief Finds the Prism devices on the I²C bus.
+ * Scans with prism_transport_p2link, the link prism_device_create uses without
+ * a configuration, see prism_bus_scan_with.
+ * @param first, last Address range, e.g. PRISM_BUS_FIRST to PRISM_BUS_LAST.
+ * @param found Receives up to max devices, ordered by address.
+ * @param max Room in found.
+ * @param count Receives the number of devices found.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+prism_err prism_bus_scan(const uint8_t first, const uint8_t last,
+                         prism_bus_entry_t *found, const uint8_t max,
+                         uint8_t *count);
+
+/**
+ * @brief Finds the Prism devices reachable through a transport backend.
+ * Every address gets a PRISM_OPCODE_ARCH_DESCRIBE frame, and the descriptor
+ * is read back over the transport, just as prism_device_create_with reads
+ * it. So scan with the transport the devices will be created with. Devices
+ * that do not know the opcode are listed with a descriptor read one variable
+ * at a time. On backends that send frames over I²C, an address-only
+ * transaction skips the addresses that do not acknowledge, without sending a
+ * command and without waiting. Wire must be started.
+ * @note The describe frame is written to every acknowledging address, so keep
+ * the range clear of other I²C devices such as EEPROMs.
+ * @param transport The transport backend, e.g. prism_transport_i2c.
+ * @param ctx Backend state, as for prism_device_create_with.
+ * @param first, last Address range, e.g. PRISM_BUS_FIRST to PRISM_BUS_LAST.
+ * @param found Receives up to max devices, ordered by address.
+ * @param max Room in found.
+ * @param count Receives the number of devices found.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+prism_err prism_bus_scan_with(const prism_transport_t *transport, void *ctx,
+                              const uint8_t first, const uint8_t last,
+                              prism_bus_entry_t *found, const uint8_t max,
+                              uint8_t *count);
+
 /**
  * @brief Sends an opcode to the Prism device.
  * This function is used to send a specific operation code (opcode) to the Prism
@@ -308,6 +630,40 @@ extern prism_err _prism_arch_send_opcode_arg1(const prdev_t *device,
                                               const uint16_t op, const ui8 type,
                                               const ui8 arg, timeout_t timeout);
 
+/**
+ * @brief Reads a single 8-bit variable from the Prism device.
+ * The opcode selects the variable, e.g. PRISM_OPCODE_ARCH_GET_FLANK or one of
+ * the PRISM_OPCODE_ARCH_GET_VERSION_* opcodes.
+ * @param device Pointer to the Prism device structure.
+ * @param op The opcode of the variable to read.
+ * @return The value of the variable, or 0 if the device did not respond.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern uint8_t _prism_arch_get_variable(const prdev_t *device,
+                                        const uint16_t op);
+
+/**
+ * @brief Sends an opcode with an argument and a 32-bit immediate to the Prism
+ * device.
+ * The frame has the layout of the _prism_arch_send_opcode_arg1 frame followed
+ * by the immediate. It is used by the scalar-immediate (PRISM_OPCODE_*_S) and
+ * splat opcodes.
+ * @param device Pointer to the Prism device structure.
+ * @param op The operation code to be sent to the device.
+ * @param type The lane type the immediate is interpreted as.
+ * @param arg The 8-bit argument, e.g. the vector length.
+ * @param imm The 32-bit immediate.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_arch_send_opcode_imm(const prdev_t *device,
+                                             const uint16_t op, const ui8 type,
+                                             const ui8 arg, const ui32 imm,
+                                             timeout_t timeout);
+
 /**
  * @brief Sends a 256-bit vector to the specified bank of the Prism device.
  * This function is used to send a 256-bit vector to either bank A or bank B of
@@ -358,6 +714,69 @@ extern prism_err _prism_send_bank_x(const prdev_t *dev, const _v256i vec,
 extern prism_err _prism_load_bank_x(const prdev_t *dev, const bank_t bank,
                                     _v256i *out, timeout_t timeout);
 
+/**
+ * @brief Sends 8 entries of 32-bit unsigned integers from caller memory to
+ * bank A or B of the Prism device.
+ * Unlike _prism_send_bank_x the entries are clocked onto P²Link straight from
+ * the caller memory, so no 32-byte copy of the vector is made.
+ * @param src Pointer to 8 consecutive 32-bit entries in RAM.
+ * @param bank PRISM_BANK_A or PRISM_BANK_B.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_send_bank_ptr(const prdev_t *dev, const ui32 *src,
+                                      const bank_t bank, timeout_t timeout);
+
+/**
+ * @brief Sends 8 entries of 32-bit unsigned integers from program memory to
+ * bank A or B of the Prism device.
+ * The entries are read with pgm_read_dword while they are clocked onto P²Link,
+ * so constant tables declared with PROGMEM never occupy SRAM. On ESP32 and
+ * other targets with memory-mapped flash PROGMEM is a plain const and the
+ * entries are read directly.
+ * @param src Pointer to 8 consecutive 32-bit entries declared PROGMEM.
+ * @param bank PRISM_BANK_A or PRISM_BANK_B.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_send_bank_pgm(const prdev_t *dev, const ui32 *src,
+                                      const bank_t bank, timeout_t timeout);
+
+/**
+ * @brief Loads 8 entries of 32-bit unsigned integers from the specified bank
+ * of the Prism device straight into caller memory.
+ * @param bank PRISM_BANK_A, PRISM_BANK_B, PRISM_BANK_C or PRISM_BANK_D.
+ * @param out Pointer to 8 consecutive 32-bit entries in RAM.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_load_bank_ptr(const prdev_t *dev, const bank_t bank,
+                                      ui32 *out, timeout_t timeout);
+
+/**
+ * @brief Loads one bank into caller memory while the next 8 entries are stored
+ * into another bank. Full-duplex links do both in a single transfer, other
+ * links fall back to a load followed by a store.
+ * @param load_bank PRISM_BANK_A, PRISM_BANK_B, PRISM_BANK_C or PRISM_BANK_D.
+ * @param out Receives the 8 entries of load_bank.
+ * @param store_bank PRISM_BANK_A or PRISM_BANK_B.
+ * @param src The 8 entries stored into store_bank.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_exchange_bank_ptr(const prdev_t *dev,
+                                          const bank_t load_bank, ui32 *out,
+                                          const bank_t store_bank,
+                                          const ui32 *src, timeout_t timeout);
+
 /**
  * @brief Sets a 256-bit vector with 8 entries of 32-bit unsigned integers.
  * This function initializes a 256-bit vector with the specified 8 entries of
@@ -393,43 +812,33 @@ static inline _v256i _v256_set8_uiv(const ui32 a, const ui32 b, const ui32 c,
 #define _v256_set1_uiv(a) _v256_set8_uiv(a, 0, 0, 0, 0, 0, 0, 0)
 
 #if PRISM_ENABLE_64BIT_EXT == 1
-inline static inline _v256i _v256_set_uiv64(const ui64 a, const ui64 b,
-                                            const ui64 c, const ui64 d) {
-  union {
-    ui64 x;
-    ui32 hl[2];
-  } _a _b _c _d;
-  _a.x = a;
-  _b.x = b;
-  _c.x = c;
-  _d.x = d;
-  return _v256_set8_uiv(_a.hl[0], _a.hl[1], _b.hl[0], _b.hl[1], _c.hl[0],
-                        _c.hl[1], _d.hl[0], _d.hl[1]);
+/**
+ * @brief Sets a 256-bit vector with 4 entries of 64-bit unsigned integers,
+ * each one split into two 32-bit lanes, low half first.
+ */
+static inline _v256i _v256_set_uiv64(const ui64 a, const ui64 b, const ui64 c,
+                                     const ui64 d) {
+  return _v256_set8_uiv((ui32)a, (ui32)(a >> 32), (ui32)b, (ui32)(b >> 32),
+                        (ui32)c, (ui32)(c >> 32), (ui32)d, (ui32)(d >> 32));
 }
 #endif // PRISM_ENABLE_64BIT_EXT
 
-#if PRISM_ENABLE_LONGTYPES == 1
-
-inline static inline _v256i _v256_set_uiv128(const ui128 a, const ui128 b) {
-  union {
-    ui128 x;
-    ui32 hl[4];
-  } _a _b;
-  _a.x = a;
-  _b.x = b;
-  return _v256_set8_uiv(_a.hl[0], _a.hl[1], _a.hl[2], _a.hl[3], _b.hl[0],
-                        _b.hl[1], _b.hl[2], _b.hl[3]);
+#if PRISM_ENABLE_64BIT_EXT == 1 && PRISM_ENABLE_LONGTYPES == 1
+/**
+ * @brief Sets a 256-bit vector with 2 entries of 128-bit unsigned integers,
+ * 4 lanes each.
+ */
+static inline _v256i _v256_set_uiv128(const ui128 a, const ui128 b) {
+  return _v256_set8_uiv(a.limb[0], a.limb[1], a.limb[2], a.limb[3], b.limb[0],
+                        b.limb[1], b.limb[2], b.limb[3]);
 }
 
-inline static inline _v256i _v256_set_uiv128(const ui256 a) {
-  union {
-    ui256 x;
-    ui32 hl[8];
-  } _a;
-  _a.x = a;
-  ;
-  return _v256_set8_uiv(_a.hl[0], _a.hl[1], _a.hl[2], _a.hl[3], _a.hl[4],
-                        _a.hl[5], _a.hl[6], _a.hl[7]);
+/**
+ * @brief Sets a 256-bit vector to one 256-bit unsigned integer.
+ */
+static inline _v256i _v256_set_uiv256(const ui256 a) {
+  return _v256_set8_uiv(a.limb[0], a.limb[1], a.limb[2], a.limb[3], a.limb[4],
+                        a.limb[5], a.limb[6], a.limb[7]);
 }
 #endif // PRISM_ENABLE_LONGTYPES
 
@@ -490,6 +899,61 @@ static inline prism_err _v256_store_bank_v(const prdev_t *device,
 #define _v256_store_bank_b(device, vec, timeout)                               \
   _v256_store_bank_v(device, PRISM_BANK_B, vec, timeout)
 
+/**
+ * @brief Stores a 256-bit vector to bank A or B of the Prism device without
+ * copying it. The vector is read from caller memory while it is sent.
+ */
+static inline prism_err _v256_store_bank_p(const prdev_t *device,
+                                           const bank_t bank,
+                                           const _v256i *vec, ui32 timeout) {
+  if (device == 0 || vec == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_send_bank_ptr(device, vec->ui, bank, timeout);
+}
+
+#define _v256_store_bank_a_p(device, vec, timeout)                             \
+  _v256_store_bank_p(device, PRISM_BANK_A, vec, timeout)
+#define _v256_store_bank_b_p(device, vec, timeout)                             \
+  _v256_store_bank_p(device, PRISM_BANK_B, vec, timeout)
+
+/**
+ * @brief Stores 8 consecutive 32-bit entries of an array to bank A or B of the
+ * Prism device without copying them into a _v256i first.
+ */
+static inline prism_err _v256_store_bank_ui32p(const prdev_t *device,
+                                               const bank_t bank,
+                                               const ui32 *src, ui32 timeout) {
+  if (device == 0 || src == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_send_bank_ptr(device, src, bank, timeout);
+}
+
+#define _v256_store_bank_a_ui32p(device, src, timeout)                         \
+  _v256_store_bank_ui32p(device, PRISM_BANK_A, src, timeout)
+#define _v256_store_bank_b_ui32p(device, src, timeout)                         \
+  _v256_store_bank_ui32p(device, PRISM_BANK_B, src, timeout)
+
+/**
+ * @brief Stores 8 consecutive 32-bit entries from a PROGMEM table to bank A or
+ * B of the Prism device. The table is read from flash while it is sent and
+ * never copied into SRAM.
+ */
+static inline prism_err _v256_store_bank_pgm(const prdev_t *device,
+                                             const bank_t bank,
+                                             const ui32 *src, ui32 timeout) {
+  if (device == 0 || src == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_send_bank_pgm(device, src, bank, timeout);
+}
+
+#define _v256_store_bank_a_pgm(device, src, timeout)                           \
+  _v256_store_bank_pgm(device, PRISM_BANK_A, src, timeout)
+#define _v256_store_bank_b_pgm(device, src, timeout)                           \
+  _v256_store_bank_pgm(device, PRISM_BANK_B, src, timeout)
+
 /**
  * @brief Loads a 256-bit vector from the specified bank (A, B, C, or D) of the
  * Prism device.
@@ -529,6 +993,125 @@ static inline ui32 _v256_extract_ui32(const _v256i v, const ui8 n) {
 #define _v256_load_bank_d(device, vec, timeout)                                \
   _v256_load_bank_x(device, PRISM_BANK_D, vec, timeout)
 
+/**
+ * @brief Loads a bank of the Prism device straight into 8 consecutive 32-bit
+ * entries of an array.
+ */
+static inline prism_err _v256_load_bank_ui32p(const prdev_t *device,
+                                              const bank_t bank, ui32 *out,
+                                              ui32 timeout) {
+  if (device == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_load_bank_ptr(device, bank, out, timeout);
+}
+
+#define _v256_load_bank_a_ui32p(device, out, timeout)                          \
+  _v256_load_bank_ui32p(device, PRISM_BANK_A, out, timeout)
+#define _v256_load_bank_b_ui32p(device, out, timeout)                          \
+  _v256_load_bank_ui32p(device, PRISM_BANK_B, out, timeout)
+#define _v256_load_bank_c_ui32p(device, out, timeout)                          \
+  _v256_load_bank_ui32p(device, PRISM_BANK_C, out, timeout)
+#define _v256_load_bank_d_ui32p(device, out, timeout)                          \
+  _v256_load_bank_ui32p(device, PRISM_BANK_D, out, timeout)
+
+// How a lazy load reads its bank
+#define PRISM_LAZY_BANK (0x00) // The first access reads the whole bank
+#define PRISM_LAZY_LANE (0x01) // Every access reads only its lane
+
+/**
+ * @brief A bank load that has not happened yet.
+ * Nothing is transferred until a lane is accessed. PRISM_LAZY_BANK then reads
+ * the whole bank over the bank data link. PRISM_LAZY_LANE reads only the
+ * bytes of the lane with PRISM_OPCODE_ARCH_PEEK, two command frames per byte
+ * and no bank transfer, which pays off for a few 8- or 16-bit lanes on I²C
+ * and SPI. P²Link waits out its processing delay on every status read, so
+ * there, and on devices without PRISM_FEATURE_PEEK, it reads the whole bank.
+ * Every frame that writes the bank cancels the load: lanes that were not read
+ * before then return PR_ERR_STALE instead of data that is gone.
+ */
+typedef struct prism_lazy {
+  const prdev_t *device;
+  uint32_t epoch; // bank_epoch of the bank when the load was made
+  uint32_t valid; // Bytes of value read from the device, one bit each
+  bank_t bank;
+  uint8_t mode; // PRISM_LAZY_BANK or PRISM_LAZY_LANE
+  ui32 timeout;
+  _v256i value;
+} prism_lazy_t;
+
+/**
+ * @brief Prepares a lazy load of a bank. Transfers nothing.
+ * @param device Pointer to the Prism device structure.
+ * @param bank PRISM_BANK_A, PRISM_BANK_B, PRISM_BANK_C or PRISM_BANK_D.
+ * @param mode PRISM_LAZY_BANK or PRISM_LAZY_LANE.
+ * @param lazy The handle.
+ * @param timeout The timeout value in milliseconds for the later read.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err _prism_load_bank_lazy(const prdev_t *device, const bank_t bank,
+                                       const uint8_t mode, prism_lazy_t *lazy,
+                                       timeout_t timeout);
+
+/**
+ * @brief Copies len bytes of the bank from offset on, reading them first if
+ * needed.
+ * @return PR_OK on success, PR_ERR_STALE if the bytes were not read before
+ * the bank was written, or the error of the transfer.
+ */
+extern prism_err _prism_lazy_read(prism_lazy_t *lazy, const uint8_t offset,
+                                  const uint8_t len, void *out);
+
+/**
+ * @brief True if the bank was written before the whole load was read.
+ */
+extern bool _prism_lazy_cancelled(const prism_lazy_t *lazy);
+
+#define _v256_load_bank_lazy(device, bank, lazy, mode, timeout)                \
+  _prism_load_bank_lazy(device, bank, mode, lazy, timeout)
+#define _v256_load_bank_lazy_a(device, lazy, timeout)                          \
+  _prism_load_bank_lazy(device, PRISM_BANK_A, PRISM_LAZY_BANK, lazy, timeout)
+#define _v256_load_bank_lazy_b(device, lazy, timeout)                          \
+  _prism_load_bank_lazy(device, PRISM_BANK_B, PRISM_LAZY_BANK, lazy, timeout)
+#define _v256_load_bank_lazy_c(device, lazy, timeout)                          \
+  _prism_load_bank_lazy(device, PRISM_BANK_C, PRISM_LAZY_BANK, lazy, timeout)
+#define _v256_load_bank_lazy_d(device, lazy, timeout)                          \
+  _prism_load_bank_lazy(device, PRISM_BANK_D, PRISM_LAZY_BANK, lazy, timeout)
+
+// Lane n of a lazy load, read on first access
+#define _v256_lazy_ui32(lazy, n, out)                                          \
+  _prism_lazy_read(lazy, (ui8)(((n) % 8) * 4), 4, (ui32 *)(out))
+#define _v256_lazy_ui16(lazy, n, out)                                          \
+  _prism_lazy_read(lazy, (ui8)(((n) % 16) * 2), 2, (ui16 *)(out))
+#define _v256_lazy_ui8(lazy, n, out)                                           \
+  _prism_lazy_read(lazy, (ui8)((n) % 32), 1, (ui8 *)(out))
+#define _v256_lazy_get(lazy, vec) _prism_lazy_read(lazy, 0, 32, (vec)->uib)
+
+/**
+ * @brief Loads a bank into an array and stores the next operand in one step.
+ * On a full-duplex link (PRISM_MODE_SPI) the upload of the next operand costs
+ * no extra transfer time while a result is downloaded.
+ */
+static inline prism_err
+_v256_exchange_bank_ui32p(const prdev_t *device, const bank_t load_bank,
+                          ui32 *out, const bank_t store_bank, const ui32 *src,
+                          ui32 timeout) {
+  if (device == 0 || out == 0 || src == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (load_bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (store_bank != PRISM_BANK_A && store_bank != PRISM_BANK_B) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_exchange_bank_ptr(device, load_bank, out, store_bank, src,
+                                  timeout);
+}
+
 static inline prism_err _v256_store_ctob(const prdev_t *device, ui32 timeout) {
   if (device == 0) {
     return PR_ERR_INVALID_ARGUMENT;
@@ -585,18 +1168,29 @@ static inline prism_err _v256_run_clear_all(const prdev_t *device,
                                  PRISM_OPCODE_TYPE_UI32, timeout);
 }
 
-static inline prism_err _v256_addN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
+/**
+ * @brief Runs a lane operation on the Prism device.
+ * Every _v256_* operation macro expands to this call, and the kernels of the
+ * library send their lane operations through it too. One table describes the
+ * opcodes: the lane types each accepts and what arg means. The argument
+ * checks therefore exist once, not at every call site.
+ * @param device Pointer to the Prism device structure.
+ * @param op A lane opcode, e.g. PRISM_OPCODE_ADD_N, PRISM_OPCODE_CMP_GT_S or
+ * PRISM_OPCODE_SPLAT_A.
+ * @param type The lane type, e.g. PRISM_OPCODE_TYPE_UI32.
+ * @param lanes Number of 32-bit units, 1 to 8.
+ * @param arg The immediate of scalar and splat opcodes, the shift count of
+ * shifts, ignored otherwise.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT for an opcode the table
+ * does not know or a type the opcode does not accept, or another error code.
+ */
+extern prism_err prism_op(const prdev_t *device, const uint16_t op,
+                          const ui8 type, const ui8 lanes, const ui32 arg,
+                          timeout_t timeout);
 
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_ADD_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_addN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_ADD_N, type, vector_len, 0, timeout)
 
 #define _v256_add8_ui32(device, timeout)                                       \
   _v256_addN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
@@ -632,18 +1226,8 @@ static inline prism_err _v256_addN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_add1_si32(device, timeout)                                       \
   _v256_addN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_subN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_SUB_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_subN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_SUB_N, type, vector_len, 0, timeout)
 #define _v256_sub8_ui32(device, timeout)                                       \
   _v256_subN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_sub7_ui32(device, timeout)                                       \
@@ -677,18 +1261,8 @@ static inline prism_err _v256_subN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_sub1_si32(device, timeout)                                       \
   _v256_subN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_mulN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_MUL_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_mulN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_MUL_N, type, vector_len, 0, timeout)
 #define _v256_mul8_ui32(device, timeout)                                       \
   _v256_mulN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_mul7_ui32(device, timeout)                                       \
@@ -722,18 +1296,8 @@ static inline prism_err _v256_mulN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_mul1_si32(device, timeout)                                       \
   _v256_mulN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_divN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_DIV_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_divN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_DIV_N, type, vector_len, 0, timeout)
 #define _v256_div8_ui32(device, timeout)                                       \
   _v256_divN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_div7_ui32(device, timeout)                                       \
@@ -767,18 +1331,8 @@ static inline prism_err _v256_divN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_div1_si32(device, timeout)                                       \
   _v256_divN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_andN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_AND_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_andN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_AND_N, type, vector_len, 0, timeout)
 #define _v256_and8_ui32(device, timeout)                                       \
   _v256_andN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_and7_ui32(device, timeout)                                       \
@@ -812,18 +1366,8 @@ static inline prism_err _v256_andN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_and1_si32(device, timeout)                                       \
   _v256_andN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_nandN_ui32(const prdev_t *device, const ui8 type,
-                                         const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_NAND_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_nandN_ui32(device, type, vector_len, timeout)                    \
+  prism_op(device, PRISM_OPCODE_NAND_N, type, vector_len, 0, timeout)
 
 #define _v256_nand8_ui32(device, timeout)                                      \
   _v256_nandN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
@@ -858,18 +1402,8 @@ static inline prism_err _v256_nandN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_nand1_si32(device, timeout)                                      \
   _v256_nandN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_orN_ui32(const prdev_t *device, const ui8 type,
-                                       const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_OR_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_orN_ui32(device, type, vector_len, timeout)                      \
+  prism_op(device, PRISM_OPCODE_OR_N, type, vector_len, 0, timeout)
 #define _v256_or8_ui32(device, timeout)                                        \
   _v256_orN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_or7_ui32(device, timeout)                                        \
@@ -903,18 +1437,8 @@ static inline prism_err _v256_orN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_or1_si32(device, timeout)                                        \
   _v256_orN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_xorN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_XOR_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_xorN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_XOR_N, type, vector_len, 0, timeout)
 #define _v256_xor8_ui32(device, timeout)                                       \
   _v256_xorN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_xor7_ui32(device, timeout)                                       \
@@ -948,18 +1472,8 @@ static inline prism_err _v256_xorN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_xor1_si32(device, timeout)                                       \
   _v256_xorN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_norN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_NOR_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_norN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_NOR_N, type, vector_len, 0, timeout)
 
 #define _v256_nor8_ui32(device, timeout)                                       \
   _v256_norN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
@@ -994,18 +1508,8 @@ static inline prism_err _v256_norN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_nor1_si32(device, timeout)                                       \
   _v256_norN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_notN_ui32(const prdev_t *device, const ui8 type,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_NOT_N, type,
-                                      (vector_len % 8), timeout);
-}
+#define _v256_notN_ui32(device, type, vector_len, timeout)                     \
+  prism_op(device, PRISM_OPCODE_NOT_N, type, vector_len, 0, timeout)
 #define _v256_not8_ui32(device, timeout)                                       \
   _v256_notN_ui32(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
 #define _v256_not7_ui32(device, timeout)                                       \
@@ -1039,17 +1543,8 @@ static inline prism_err _v256_notN_ui32(const prdev_t *device, const ui8 type,
 #define _v256_not1_si32(device, timeout)                                       \
   _v256_notN_ui32(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_notc_x(const prdev_t *device, const ui8 type,
-                                     const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_NOTC, type, timeout);
-}
+#define _v256_notc_x(device, type, vector_len, timeout)                        \
+  prism_op(device, PRISM_OPCODE_NOTC, type, vector_len, 0, timeout)
 
 #define _v256_notc8_ui32(device, timeout)                                      \
   _v256_notc_x(device, PRISM_OPCODE_TYPE_UI32, 8, timeout)
@@ -1084,18 +1579,9 @@ static inline prism_err _v256_notc_x(const prdev_t *device, const ui8 type,
 #define _v256_notc1_si32(device, timeout)                                      \
   _v256_notc_x(device, PRISM_OPCODE_TYPE_SI32, 1, timeout)
 
-static inline prism_err _v256_cpm_epN_px(const prdev_t *device,
-                                         const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_EQ,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_epN_px(device, vector_len, timeout)                          \
+  prism_op(device, PRISM_OPCODE_CMP_EQ, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 #define _v256_cpm_ep8_px(device, timeout) _v256_cpm_epN_px(device, 8, timeout)
 #define _v256_cpm_ep7_px(device, timeout) _v256_cpm_epN_px(device, 7, timeout)
 #define _v256_cpm_ep6_px(device, timeout) _v256_cpm_epN_px(device, 6, timeout)
@@ -1105,18 +1591,9 @@ static inline prism_err _v256_cpm_epN_px(const prdev_t *device,
 #define _v256_cpm_ep2_px(device, timeout) _v256_cpm_epN_px(device, 2, timeout)
 #define _v256_cpm_ep1_px(device, timeout) _v256_cpm_epN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_nepN_px(const prdev_t *device,
-                                          const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_NE,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_nepN_px(device, vector_len, timeout)                         \
+  prism_op(device, PRISM_OPCODE_CMP_NE, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 
 #define _v256_cpm_nep8_px(device, timeout) _v256_cpm_nepN_px(device, 8, timeout)
 #define _v256_cpm_nep7_px(device, timeout) _v256_cpm_nepN_px(device, 7, timeout)
@@ -1127,18 +1604,9 @@ static inline prism_err _v256_cpm_nepN_px(const prdev_t *device,
 #define _v256_cpm_nep2_px(device, timeout) _v256_cpm_nepN_px(device, 2, timeout)
 #define _v256_cpm_nep1_px(device, timeout) _v256_cpm_nepN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_gt_px(const prdev_t *device,
-                                        const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_GT,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_gt_px(device, vector_len, timeout)                           \
+  prism_op(device, PRISM_OPCODE_CMP_GT, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 
 #define _v256_cpm_gt8_px(device, timeout) _v256_cpm_gt_px(device, 8, timeout)
 #define _v256_cpm_gt7_px(device, timeout) _v256_cpm_gt_px(device, 7, timeout)
@@ -1149,18 +1617,9 @@ static inline prism_err _v256_cpm_gt_px(const prdev_t *device,
 #define _v256_cpm_gt2_px(device, timeout) _v256_cpm_gt_px(device, 2, timeout)
 #define _v256_cpm_gt1_px(device, timeout) _v256_cpm_gt_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_geN_px(const prdev_t *device,
-                                         const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_GE,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_geN_px(device, vector_len, timeout)                          \
+  prism_op(device, PRISM_OPCODE_CMP_GE, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 
 #define _v256_cpm_ge8_px(device, timeout) _v256_cpm_geN_px(device, 8, timeout)
 #define _v256_cpm_ge7_px(device, timeout) _v256_cpm_geN_px(device, 7, timeout)
@@ -1171,18 +1630,9 @@ static inline prism_err _v256_cpm_geN_px(const prdev_t *device,
 #define _v256_cpm_ge2_px(device, timeout) _v256_cpm_geN_px(device, 2, timeout)
 #define _v256_cpm_ge1_px(device, timeout) _v256_cpm_geN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_ltN_px(const prdev_t *device,
-                                         const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_LT,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_ltN_px(device, vector_len, timeout)                          \
+  prism_op(device, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 
 #define _v256_cpm_lt8_px(device, timeout) _v256_cpm_ltN_px(device, 8, timeout)
 #define _v256_cpm_lt7_px(device, timeout) _v256_cpm_ltN_px(device, 7, timeout)
@@ -1193,18 +1643,9 @@ static inline prism_err _v256_cpm_ltN_px(const prdev_t *device,
 #define _v256_cpm_lt2_px(device, timeout) _v256_cpm_ltN_px(device, 2, timeout)
 #define _v256_cpm_lt1_px(device, timeout) _v256_cpm_ltN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_leN_px(const prdev_t *device,
-                                         const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CMP_LE,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_leN_px(device, vector_len, timeout)                          \
+  prism_op(device, PRISM_OPCODE_CMP_LE, PRISM_OPCODE_TYPE_UI32, vector_len, 0, \
+           timeout)
 
 #define _v256_cpm_le8_px(device, timeout) _v256_cpm_leN_px(device, 8, timeout)
 #define _v256_cpm_le7_px(device, timeout) _v256_cpm_leN_px(device, 7, timeout)
@@ -1215,18 +1656,9 @@ static inline prism_err _v256_cpm_leN_px(const prdev_t *device,
 #define _v256_cpm_le2_px(device, timeout) _v256_cpm_leN_px(device, 2, timeout)
 #define _v256_cpm_le1_px(device, timeout) _v256_cpm_leN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_cplN_px(const prdev_t *device,
-                                          const ui8 vector_len, ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode(device, PRISM_OPCODE_CPL2,
-                                 PRISM_OPCODE_TYPE_UI32, timeout);
-}
+#define _v256_cpm_cplN_px(device, vector_len, timeout)                         \
+  prism_op(device, PRISM_OPCODE_CPL2, PRISM_OPCODE_TYPE_UI32, vector_len, 0,   \
+           timeout)
 #define _v256_cpm_cpl8_px(device, timeout) _v256_cpm_cplN_px(device, 8, timeout)
 #define _v256_cpm_cpl7_px(device, timeout) _v256_cpm_cplN_px(device, 7, timeout)
 #define _v256_cpm_cpl6_px(device, timeout) _v256_cpm_cplN_px(device, 6, timeout)
@@ -1236,19 +1668,9 @@ static inline prism_err _v256_cpm_cplN_px(const prdev_t *device,
 #define _v256_cpm_cpl2_px(device, timeout) _v256_cpm_cplN_px(device, 2, timeout)
 #define _v256_cpm_cpl1_px(device, timeout) _v256_cpm_cplN_px(device, 1, timeout)
 
-static inline prism_err _v256_cpm_shlN_pa(const prdev_t *device,
-                                          const ui8 vector_len, const ui8 num,
-                                          ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_SHIFT_L,
-                                      PRISM_OPCODE_TYPE_UI32, num, timeout);
-}
+#define _v256_cpm_shlN_pa(device, vector_len, num, timeout)                    \
+  prism_op(device, PRISM_OPCODE_SHIFT_L, PRISM_OPCODE_TYPE_UI32, vector_len,   \
+           num, timeout)
 
 #define _v256_cpm_shl8_pa(device, num, timeout)                                \
   _v256_cpm_shlN_pa(device, 8, num, timeout)
@@ -1267,19 +1689,9 @@ static inline prism_err _v256_cpm_shlN_pa(const prdev_t *device,
 #define _v256_cpm_shl1_pa(device, num, timeout)                                \
   _v256_cpm_shlN_pa(device, 1, num, timeout)
 
-static inline prism_err _v256_cpm_shrN_pa(const prdev_t *device,
-                                          const ui8 vector_len, const ui8 num,
-                                          ui32 timeout) {
-  if (device == 0) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-  if (vector_len < 1 || vector_len > 8) {
-    return PR_ERR_INVALID_ARGUMENT;
-  }
-
-  return _prism_arch_send_opcode_arg1(device, PRISM_OPCODE_SHIFT_R,
-                                      PRISM_OPCODE_TYPE_UI32, num, timeout);
-}
+#define _v256_cpm_shrN_pa(device, vector_len, num, timeout)                    \
+  prism_op(device, PRISM_OPCODE_SHIFT_R, PRISM_OPCODE_TYPE_UI32, vector_len,   \
+           num, timeout)
 
 #define _v256_cpm_shr8_pa(device, num, timeout)                                \
   _v256_cpm_shrN_pa(device, 8, num, timeout)
@@ -1298,6 +1710,129 @@ static inline prism_err _v256_cpm_shrN_pa(const prdev_t *device,
 #define _v256_cpm_shr1_pa(device, num, timeout)                                \
   _v256_cpm_shrN_pa(device, 1, num, timeout)
 
+/**
+ * @brief Fills every lane of bank A or B with the same value.
+ * Only the command frame with the immediate is sent, no 32-byte P²Link upload.
+ * For narrow lane types the low bits of the value are replicated into every
+ * 16- or 8-bit lane.
+ * @param device Pointer to the Prism device structure.
+ * @param bank PRISM_BANK_A or PRISM_BANK_B.
+ * @param type The lane type, e.g. PRISM_OPCODE_TYPE_UI32.
+ * @param value The value to replicate.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+#define _v256_splat_bank_v(device, bank, type, value, timeout)                 \
+  prism_op(device,                                                             \
+           (bank) == PRISM_BANK_A   ? PRISM_OPCODE_SPLAT_A                     \
+           : (bank) == PRISM_BANK_B ? PRISM_OPCODE_SPLAT_B                     \
+                                    : 0,                                       \
+           type, 8, value, timeout)
+
+#define _v256_splat_bank_a_ui32(device, value, timeout)                        \
+  _v256_splat_bank_v(device, PRISM_BANK_A, PRISM_OPCODE_TYPE_UI32, value,      \
+                     timeout)
+#define _v256_splat_bank_b_ui32(device, value, timeout)                        \
+  _v256_splat_bank_v(device, PRISM_BANK_B, PRISM_OPCODE_TYPE_UI32, value,      \
+                     timeout)
+#define _v256_splat_bank_a_si32(device, value, timeout)                        \
+  _v256_splat_bank_v(device, PRISM_BANK_A, PRISM_OPCODE_TYPE_SI32,             \
+                     (ui32)(value), timeout)
+#define _v256_splat_bank_b_si32(device, value, timeout)                        \
+  _v256_splat_bank_v(device, PRISM_BANK_B, PRISM_OPCODE_TYPE_SI32,             \
+                     (ui32)(value), timeout)
+
+/**
+ * @brief Runs a scalar-immediate operation: bank C = bank A op value.
+ * The value is carried in the command frame, like the shift count of
+ * _v256_cpm_shlN_pa, so a vector-by-scalar operation costs one 12-byte frame
+ * instead of a 32-byte bank B upload. Bank B is left untouched. Devices
+ * without PRISM_FEATURE_SCALAR get the value uploaded to bank B and run the
+ * PRISM_OPCODE_*_N form instead; in no-clear mode B is saved and restored
+ * around it.
+ * @param device Pointer to the Prism device structure.
+ * @param op One of the PRISM_OPCODE_*_S opcodes.
+ * @param type The lane type, e.g. PRISM_OPCODE_TYPE_UI32.
+ * @param vector_len Number of lanes, 1 to 8.
+ * @param value The scalar operand.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+#define _v256_opN_scalar(device, op, type, vector_len, value, timeout)         \
+  prism_op(device, op, type, vector_len, value, timeout)
+
+#define _v256_add_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_ADD_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_sub_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_SUB_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_mul_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_MUL_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_div_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_DIV_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_and_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_AND_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_nand_scalar_ui32(device, value, vector_len, timeout)             \
+  _v256_opN_scalar(device, PRISM_OPCODE_NAND_S, PRISM_OPCODE_TYPE_UI32,        \
+                   vector_len, value, timeout)
+#define _v256_or_scalar_ui32(device, value, vector_len, timeout)               \
+  _v256_opN_scalar(device, PRISM_OPCODE_OR_S, PRISM_OPCODE_TYPE_UI32,          \
+                   vector_len, value, timeout)
+#define _v256_xor_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_XOR_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+#define _v256_nor_scalar_ui32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_NOR_S, PRISM_OPCODE_TYPE_UI32,         \
+                   vector_len, value, timeout)
+
+#define _v256_add_scalar_si32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_ADD_S, PRISM_OPCODE_TYPE_SI32,         \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_sub_scalar_si32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_SUB_S, PRISM_OPCODE_TYPE_SI32,         \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_mul_scalar_si32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_MUL_S, PRISM_OPCODE_TYPE_SI32,         \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_div_scalar_si32(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_DIV_S, PRISM_OPCODE_TYPE_SI32,         \
+                   vector_len, (ui32)(value), timeout)
+
+#define _v256_cmpeq_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_EQ_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmpne_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_NE_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmpgt_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GT_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmpge_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GE_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmplt_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LT_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmple_scalar_ui32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LE_S, PRISM_OPCODE_TYPE_UI32,      \
+                   vector_len, value, timeout)
+#define _v256_cmpgt_scalar_si32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GT_S, PRISM_OPCODE_TYPE_SI32,      \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_cmpge_scalar_si32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GE_S, PRISM_OPCODE_TYPE_SI32,      \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_cmplt_scalar_si32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LT_S, PRISM_OPCODE_TYPE_SI32,      \
+                   vector_len, (ui32)(value), timeout)
+#define _v256_cmple_scalar_si32(device, value, vector_len, timeout)            \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LE_S, PRISM_OPCODE_TYPE_SI32,      \
+                   vector_len, (ui32)(value), timeout)
+
 #if __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,380 @@
+/**
+ * @file prism.hpp
+ * @brief Type-safe C++ front end of the Prism library.
+ * prism::device owns a Prism device and stops it when it goes out of scope.
+ * prism::vec<T, Lanes> is a _v256i with a lane type, so the opcode type
+ * follows from T and mixing lane types or exceeding the lanes of a vector
+ * fails to compile instead of on the device:
+ *
+ *   prism::device dev;
+ *   dev.open(0x10);
+ *   prism::vec<si16> a = prism::vec<si16>::splat(3), b = ...;
+ *   prism::result<prism::vec<si16> > prod = dev.eval(a * b);
+ *   if (prod) {
+ *     prism::result<prism::vec<si16> > sum = dev.eval(*prod + 1);
+ *   }
+ *
+ * An operator only builds one operation; dev.eval() sends the operands, runs
+ * it and reads the result, so a * b + 1 takes two evals. Errors come back in
+ * a prism::result instead of exceptions. The header needs no STL, so it also
+ * builds on AVR.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_HPP__
+#define __PRISM_HPP__ 1
+
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include <string.h>
+
+#ifdef PRISM_ENABLE_IEE754
+#include "prism/prism_float.h"
+#endif
+
+#ifdef __cplusplus
+
+namespace prism {
+
+/**
+ * @brief A value or the prism_err why there is none.
+ */
+template <typename T> class result {
+public:
+  result(const T &value) : m_value(value), m_err(PR_OK) {}
+  result(prism_err err) : m_value(), m_err(err) {}
+
+  bool ok() const { return m_err == PR_OK; }
+  explicit operator bool() const { return m_err == PR_OK; }
+  prism_err error() const { return m_err; }
+
+  // Only meaningful if ok()
+  const T &value() const { return m_value; }
+  const T &operator*() const { return m_value; }
+  const T *operator->() const { return &m_value; }
+  T value_or(const T &fallback) const { return ok() ? m_value : fallback; }
+
+private:
+  T m_value;
+  prism_err m_err;
+};
+
+template <> class result<void> {
+public:
+  result() : m_err(PR_OK) {}
+  result(prism_err err) : m_err(err) {}
+
+  bool ok() const { return m_err == PR_OK; }
+  explicit operator bool() const { return m_err == PR_OK; }
+  prism_err error() const { return m_err; }
+
+private:
+  prism_err m_err;
+};
+
+#ifdef PRISM_ENABLE_IEE754
+/**
+ * @brief An IEEE754 binary16 lane.
+ */
+struct half {
+  ui16 bits;
+
+  half() : bits(0) {}
+  half(float x) : bits(prism_half_from_float(x)) {}
+  operator float() const { return prism_half_to_float(bits); }
+};
+#endif
+
+/**
+ * @brief Maps a C++ lane type onto its opcode type and its _v256i view. Only
+ * the specializations below exist.
+ */
+template <typename T> struct lane_traits {
+  static_assert(sizeof(T) == 0, "prism: unsupported lane type");
+};
+
+#define __PRISM_LANE_TRAITS(T, TYPE, FIELD, LANES, INTEGRAL)                   \
+  template <> struct lane_traits<T> {                                          \
+    static const ui8 type = TYPE;                                              \
+    static const ui8 lanes = LANES;                                            \
+    static const bool integral = INTEGRAL;                                     \
+    static T *data(_v256i &v) { return (T *)v.FIELD; }                         \
+    static const T *data(const _v256i &v) { return (const T *)v.FIELD; }       \
+  };
+
+__PRISM_LANE_TRAITS(ui32, PRISM_OPCODE_TYPE_UI32, ui, 8, true)
+__PRISM_LANE_TRAITS(si32, PRISM_OPCODE_TYPE_SI32, si, 8, true)
+__PRISM_LANE_TRAITS(ui16, PRISM_OPCODE_TYPE_UI16, uix, 16, true)
+__PRISM_LANE_TRAITS(si16, PRISM_OPCODE_TYPE_SI16, six, 16, true)
+__PRISM_LANE_TRAITS(ui8, PRISM_OPCODE_TYPE_UI8, uib, 32, true)
+__PRISM_LANE_TRAITS(si8, PRISM_OPCODE_TYPE_SI8, sib, 32, true)
+#ifdef PRISM_ENABLE_IEE754
+__PRISM_LANE_TRAITS(float, PRISM_OPCODE_TYPE_FL, fl, 8, false)
+__PRISM_LANE_TRAITS(half, PRISM_OPCODE_TYPE_HF, hf, 16, false)
+#endif
+
+#undef __PRISM_LANE_TRAITS
+
+// Keeps T out of template argument deduction, so a + 1 works for any T
+template <typename T> struct identity {
+  typedef T type;
+};
+
+/**
+ * @brief Lanes lanes of type T in one 256-bit vector.
+ */
+template <typename T, ui8 Lanes = lane_traits<T>::lanes> class vec {
+  static_assert(Lanes >= 1 && Lanes <= lane_traits<T>::lanes,
+                "prism: a vector holds 1 to 256 / (8 * sizeof(T)) lanes");
+
+public:
+  typedef T lane_type;
+  static const ui8 lanes = Lanes;
+  // 32-bit units an operation has to cover
+  static const ui8 units = (Lanes * sizeof(T) + 3) / 4;
+
+  vec() { memset(&m_v, 0, sizeof(m_v)); }
+  explicit vec(const _v256i &v) : m_v(v) {}
+
+  static vec splat(const T x) {
+    vec v;
+    for (ui8 i = 0; i < Lanes; i++) {
+      v[i] = x;
+    }
+    return v;
+  }
+
+  static vec load(const T *src) {
+    vec v;
+    for (ui8 i = 0; i < Lanes; i++) {
+      v[i] = src[i];
+    }
+    return v;
+  }
+
+  T operator[](const ui8 i) const { return lane_traits<T>::data(m_v)[i]; }
+  T &operator[](const ui8 i) { return lane_traits<T>::data(m_v)[i]; }
+
+  _v256i &raw() { return m_v; }
+  const _v256i &raw() const { return m_v; }
+
+private:
+  _v256i m_v;
+};
+
+/**
+ * @brief An operation on one or two vectors, run by device::eval.
+ * The operands are copied, so an operation never refers to a temporary.
+ */
+template <typename T, ui8 Lanes> struct op {
+  uint16_t code;
+  vec<T, Lanes> a;
+  vec<T, Lanes> b;
+  ui32 imm;
+  bool has_b;
+};
+
+// The frame immediate of a scalar operand
+template <typename T> inline ui32 __prism_imm(const T x) { return (ui32)x; }
+#ifdef PRISM_ENABLE_IEE754
+template <> inline ui32 __prism_imm<float>(const float x) {
+  return _prism_fl_bits(x);
+}
+template <> inline ui32 __prism_imm<half>(const half x) { return x.bits; }
+#endif
+
+template <typename T, ui8 Lanes>
+inline op<T, Lanes> __prism_make(const uint16_t code, const vec<T, Lanes> &a,
+                                 const vec<T, Lanes> &b) {
+  op<T, Lanes> o = {code, a, b, 0, true};
+  return o;
+}
+
+template <typename T, ui8 Lanes>
+inline op<T, Lanes> __prism_make(const uint16_t code, const vec<T, Lanes> &a,
+                                 const T s) {
+  op<T, Lanes> o = {code, a, vec<T, Lanes>(), __prism_imm(s), false};
+  return o;
+}
+
+#define __PRISM_BINARY_OP(SYM, OPN, OPS, INTEGRAL_ONLY)                        \
+  template <typename T, ui8 Lanes>                                             \
+  inline op<T, Lanes> operator SYM(const vec<T, Lanes> &a,                     \
+                                   const vec<T, Lanes> &b) {                   \
+    static_assert(!INTEGRAL_ONLY || lane_traits<T>::integral,                  \
+                  "prism: bit operations need integer lanes");                 \
+    return __prism_make(OPN, a, b);                                            \
+  }                                                                            \
+  template <typename T, ui8 Lanes>                                             \
+  inline op<T, Lanes> operator SYM(const vec<T, Lanes> &a,                     \
+                                   const typename identity<T>::type s) {       \
+    static_assert(!INTEGRAL_ONLY || lane_traits<T>::integral,                  \
+                  "prism: bit operations need integer lanes");                 \
+    return __prism_make(OPS, a, s);                                            \
+  }
+
+__PRISM_BINARY_OP(+, PRISM_OPCODE_ADD_N, PRISM_OPCODE_ADD_S, false)
+__PRISM_BINARY_OP(-, PRISM_OPCODE_SUB_N, PRISM_OPCODE_SUB_S, false)
+__PRISM_BINARY_OP(*, PRISM_OPCODE_MUL_N, PRISM_OPCODE_MUL_S, false)
+__PRISM_BINARY_OP(/, PRISM_OPCODE_DIV_N, PRISM_OPCODE_DIV_S, false)
+__PRISM_BINARY_OP(&, PRISM_OPCODE_AND_N, PRISM_OPCODE_AND_S, true)
+__PRISM_BINARY_OP(|, PRISM_OPCODE_OR_N, PRISM_OPCODE_OR_S, true)
+__PRISM_BINARY_OP(^, PRISM_OPCODE_XOR_N, PRISM_OPCODE_XOR_S, true)
+
+#undef __PRISM_BINARY_OP
+
+// Compares write 1 into every lane that compares true, 0 elsewhere. They are
+// functions, so == keeps meaning equality of the host values.
+#define __PRISM_COMPARE(NAME, OPN, OPS)                                        \
+  template <typename T, ui8 Lanes>                                             \
+  inline op<T, Lanes> NAME(const vec<T, Lanes> &a, const vec<T, Lanes> &b) {   \
+    return __prism_make(OPN, a, b);                                            \
+  }                                                                            \
+  template <typename T, ui8 Lanes>                                             \
+  inline op<T, Lanes> NAME(const vec<T, Lanes> &a,                             \
+                           const typename identity<T>::type s) {               \
+    return __prism_make(OPS, a, s);                                            \
+  }
+
+__PRISM_COMPARE(cmp_eq, PRISM_OPCODE_CMP_EQ, PRISM_OPCODE_CMP_EQ_S)
+__PRISM_COMPARE(cmp_ne, PRISM_OPCODE_CMP_NE, PRISM_OPCODE_CMP_NE_S)
+__PRISM_COMPARE(cmp_gt, PRISM_OPCODE_CMP_GT, PRISM_OPCODE_CMP_GT_S)
+__PRISM_COMPARE(cmp_ge, PRISM_OPCODE_CMP_GE, PRISM_OPCODE_CMP_GE_S)
+__PRISM_COMPARE(cmp_lt, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_CMP_LT_S)
+__PRISM_COMPARE(cmp_le, PRISM_OPCODE_CMP_LE, PRISM_OPCODE_CMP_LE_S)
+
+#undef __PRISM_COMPARE
+
+/**
+ * @brief Owns a Prism device. The device is stopped when the object is
+ * destroyed or closed. Not copyable; ownership moves.
+ */
+class device {
+public:
+  device() : m_open(false), m_timeout(1000) {
+    memset(&m_dev, 0, sizeof(m_dev));
+  }
+  ~device() { close(); }
+
+  device(device &&other)
+      : m_dev(other.m_dev), m_open(other.m_open), m_timeout(other.m_timeout) {
+    other.m_open = false;
+  }
+  device &operator=(device &&other) {
+    if (this != &other) {
+      close();
+      m_dev = other.m_dev;
+      m_open = other.m_open;
+      m_timeout = other.m_timeout;
+      other.m_open = false;
+    }
+    return *this;
+  }
+  device(const device &) = delete;
+  device &operator=(const device &) = delete;
+
+  /**
+   * @brief Opens the device at an I²C address, see prism_device_create.
+   */
+  result<void> open(const uint8_t address, const bool wireInit = true,
+                    const prism_dev_config_t *config = 0) {
+    close();
+    return __prism_opened(
+        prism_device_create(address, wireInit, config, &m_dev));
+  }
+
+  /**
+   * @brief Opens a device on a custom transport, see
+   * prism_device_create_with.
+   */
+  result<void> open_with(const uint8_t address,
+                         const prism_transport_t *transport, void *ctx) {
+    close();
+    return __prism_opened(
+        prism_device_create_with(address, transport, ctx, &m_dev));
+  }
+
+  /**
+   * @brief Opens an emulated device, see prism_device_create_loopback.
+   */
+  result<void> open_loopback(prism_loopback_t *state) {
+    close();
+    return __prism_opened(prism_device_create_loopback(state, &m_dev));
+  }
+
+  /**
+   * @brief Stops the device. Called by the destructor.
+   */
+  result<void> close() {
+    if (!m_open) {
+      return PR_OK;
+    }
+    m_open = false;
+    return prism_device_stop(&m_dev);
+  }
+
+  bool is_open() const { return m_open; }
+  const prdev_t *get() const { return &m_dev; }
+
+  // Timeout of every command, in milliseconds
+  void set_timeout(const ui32 timeout) { m_timeout = timeout; }
+  ui32 timeout() const { return m_timeout; }
+
+  template <typename T, ui8 Lanes>
+  result<void> store(const bank_t bank, const vec<T, Lanes> &v) {
+    return _prism_send_bank_ptr(&m_dev, v.raw().ui, bank, m_timeout);
+  }
+
+  template <typename T, ui8 Lanes>
+  result<vec<T, Lanes> > load(const bank_t bank) {
+    vec<T, Lanes> v;
+    prism_err err = _prism_load_bank_ptr(&m_dev, bank, v.raw().ui, m_timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+    return v;
+  }
+
+  /**
+   * @brief Runs an operation: its operands go to banks A and B (scalars
+   * travel in the frame), the result comes back from bank C.
+   */
+  template <typename T, ui8 Lanes>
+  result<vec<T, Lanes> > eval(const op<T, Lanes> &o) {
+    prism_err err = _prism_send_bank_ptr(&m_dev, o.a.raw().ui, PRISM_BANK_A,
+                                         m_timeout);
+    if (err == PR_OK && o.has_b) {
+      err = _prism_send_bank_ptr(&m_dev, o.b.raw().ui, PRISM_BANK_B,
+                                 m_timeout);
+    }
+    if (err == PR_OK) {
+      err = prism_op(&m_dev, o.code, lane_traits<T>::type,
+                     vec<T, Lanes>::units, o.imm, m_timeout);
+    }
+    if (err != PR_OK) {
+      return err;
+    }
+    return load<T, Lanes>(PRISM_BANK_C);
+  }
+
+private:
+  result<void> __prism_opened(const prism_err err) {
+    m_open = (err == PR_OK);
+    return err;
+  }
+
+  prdev_t m_dev;
+  bool m_open;
+  ui32 m_timeout;
+};
+
+} // namespace prism
+
+#endif // __cplusplus
+
+#endif // __PRISM_HPP__
@@ -0,0 +1,78 @@
+/**
+ * @file prism_async.h
+ * @brief Non-blocking submit/poll layer of the Prism library.
+ * The blocking _prism_arch_send_opcode_* functions write a command frame and
+ * wait for its status byte. The functions in this file split that into
+ * prism_submit_opcode, which only writes the frame, and prism_poll, which
+ * checks once whether the status byte is there. A caller can keep several
+ * devices busy at the same time or do host work while a frame is processed.
+ * @note Polling needs a transport with a poll_status function and a device
+ * that answers PRISM_STATUS_BUSY (or NACKs) until it is done, i.e. the SPI
+ * and I²C-only backends. On other transports, including the default P²Link
+ * backend, prism_poll falls back to the blocking read_status.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_ASYNC__
+#define __PRISM_ASYNC__ 1
+
+#include "prism/prism.h"
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief A command frame that was written and waits for its status byte.
+ */
+typedef struct prism_pending {
+  const prdev_t *device;
+  unsigned long start; // millis() when the frame was written
+  ui32 timeout;        // Milliseconds until prism_poll gives up
+} prism_pending_t;
+
+/**
+ * @brief Writes a command frame without waiting for the device.
+ * @param device Pointer to the Prism device structure.
+ * @param op The opcode.
+ * @param type The PRISM_OPCODE_TYPE_* of the operation.
+ * @param arg The argument byte, the lane count for the vector opcodes.
+ * @param timeout The timeout value in milliseconds, sent to the device and
+ * used by prism_poll.
+ * @param pending Receives the state to poll.
+ * @return PR_OK if the frame was written, or an error code if there is an
+ * issue.
+ */
+extern prism_err prism_submit_opcode(const prdev_t *device, const uint16_t op,
+                                     const ui8 type, const ui8 arg,
+                                     timeout_t timeout,
+                                     prism_pending_t *pending);
+
+/**
+ * @brief Writes a command frame with a 32-bit immediate without waiting.
+ */
+extern prism_err prism_submit_opcode_imm(const prdev_t *device,
+                                         const uint16_t op, const ui8 type,
+                                         const ui8 arg, const ui32 imm,
+                                         timeout_t timeout,
+                                         prism_pending_t *pending);
+
+/**
+ * @brief Checks once whether the device finished a submitted frame.
+ * @param pending The frame returned by prism_submit_opcode.
+ * @param done Set to true once the frame is finished, successfully or not.
+ * @return PR_OK while the frame is pending or after it succeeded,
+ * PR_ERR_LINK if bank data before an END frame arrived damaged,
+ * PR_ERR_UNKNOWN if the device failed it or did not answer in time.
+ */
+extern prism_err prism_poll(prism_pending_t *pending, bool *done);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_ASYNC__
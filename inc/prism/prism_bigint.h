@@ -0,0 +1,170 @@
+/**
+ * @file prism_bigint.h
+ * @brief 64-, 128- and 256-bit integer arithmetic for the Prism library.
+ * Wide values are arrays of 32-bit limbs, least significant limb first, and
+ * occupy 2, 4 or 8 lanes of a vector; a bank holds 4, 2 or 1 of them. The
+ * device adds or subtracts all limbs at once and detects the carry (borrow)
+ * of every lane with a compare against an operand:
+ *   s = a + b, carry = (s < b)      d = a - b, borrow = (a < d)
+ * The sum and the carry vector are downloaded and the host resolves the
+ * carries lane to lane, which the device cannot do without a lane shift.
+ * Shifts move whole limbs on the host and shift the bits of every lane on the
+ * device (PRISM_OPCODE_SHIFT_L, PRISM_OPCODE_SHIFT_R).
+ * @note The typed wrappers for ui64, ui128 and ui256 need
+ * PRISM_ENABLE_64BIT_EXT (and PRISM_ENABLE_LONGTYPES); the limb functions
+ * work without them.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_BIGINT__
+#define __PRISM_BIGINT__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Width of the values, in 32-bit limbs.
+ */
+typedef enum prism_bigint_width {
+  PRISM_BIGINT_64 = 2,
+  PRISM_BIGINT_128 = 4,
+  PRISM_BIGINT_256 = 8
+} prism_bigint_width_t;
+
+/**
+ * @brief out = a + b for count values of the given width.
+ * @param device Pointer to the Prism device structure.
+ * @param width Limbs per value.
+ * @param a, b count values each.
+ * @param out Receives count values. May be a or b.
+ * @param count Number of values.
+ * @param carry Receives the carry out of every value, 0 or 1. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_bigint_add(const prdev_t *device,
+                                  const prism_bigint_width_t width,
+                                  const ui32 *a, const ui32 *b, ui32 *out,
+                                  const size_t count, ui8 *carry,
+                                  ui32 timeout);
+
+/**
+ * @brief out = a - b for count values of the given width.
+ * @param borrow Receives the borrow out of every value, 1 if a < b. May be
+ * NULL.
+ * @see prism_bigint_add for the other parameters.
+ */
+extern prism_err prism_bigint_sub(const prdev_t *device,
+                                  const prism_bigint_width_t width,
+                                  const ui32 *a, const ui32 *b, ui32 *out,
+                                  const size_t count, ui8 *borrow,
+                                  ui32 timeout);
+
+/**
+ * @brief Compares count pairs of unsigned values.
+ * @param device Pointer to the Prism device structure.
+ * @param width Limbs per value.
+ * @param a, b count values each.
+ * @param result Receives -1, 0 or 1 for a < b, a == b and a > b.
+ * @param count Number of values.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_bigint_cmp(const prdev_t *device,
+                                  const prism_bigint_width_t width,
+                                  const ui32 *a, const ui32 *b, si8 *result,
+                                  const size_t count, ui32 timeout);
+
+/**
+ * @brief out = a << shift for count values of the given width. Bits shifted
+ * out of a value are lost.
+ * @param device Pointer to the Prism device structure.
+ * @param width Limbs per value.
+ * @param a count values.
+ * @param shift Bits to shift, the result is zero from 32 * width on.
+ * @param out Receives count values. May be a.
+ * @param count Number of values.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_bigint_shl(const prdev_t *device,
+                                  const prism_bigint_width_t width,
+                                  const ui32 *a, const ui16 shift, ui32 *out,
+                                  const size_t count, ui32 timeout);
+
+/**
+ * @brief out = a >> shift (logical) for count values of the given width.
+ * @see prism_bigint_shl for the parameters.
+ */
+extern prism_err prism_bigint_shr(const prdev_t *device,
+                                  const prism_bigint_width_t width,
+                                  const ui32 *a, const ui16 shift, ui32 *out,
+                                  const size_t count, ui32 timeout);
+
+// 64-bit values are stored low half first on every supported board
+#if PRISM_ENABLE_64BIT_EXT == 1
+#define prism_add_ui64(device, a, b, out, count, timeout)                      \
+  prism_bigint_add(device, PRISM_BIGINT_64, (const ui32 *)(a),                 \
+                   (const ui32 *)(b), (ui32 *)(out), count, 0, timeout)
+#define prism_sub_ui64(device, a, b, out, count, timeout)                      \
+  prism_bigint_sub(device, PRISM_BIGINT_64, (const ui32 *)(a),                 \
+                   (const ui32 *)(b), (ui32 *)(out), count, 0, timeout)
+#define prism_cmp_ui64(device, a, b, result, count, timeout)                   \
+  prism_bigint_cmp(device, PRISM_BIGINT_64, (const ui32 *)(a),                 \
+                   (const ui32 *)(b), result, count, timeout)
+#define prism_shl_ui64(device, a, shift, out, count, timeout)                  \
+  prism_bigint_shl(device, PRISM_BIGINT_64, (const ui32 *)(a), shift,          \
+                   (ui32 *)(out), count, timeout)
+#define prism_shr_ui64(device, a, shift, out, count, timeout)                  \
+  prism_bigint_shr(device, PRISM_BIGINT_64, (const ui32 *)(a), shift,          \
+                   (ui32 *)(out), count, timeout)
+
+#if PRISM_ENABLE_LONGTYPES == 1
+#define prism_add_ui128(device, a, b, out, count, timeout)                     \
+  prism_bigint_add(device, PRISM_BIGINT_128, (a)->limb, (b)->limb,             \
+                   (out)->limb, count, 0, timeout)
+#define prism_sub_ui128(device, a, b, out, count, timeout)                     \
+  prism_bigint_sub(device, PRISM_BIGINT_128, (a)->limb, (b)->limb,             \
+                   (out)->limb, count, 0, timeout)
+#define prism_cmp_ui128(device, a, b, result, count, timeout)                  \
+  prism_bigint_cmp(device, PRISM_BIGINT_128, (a)->limb, (b)->limb, result,     \
+                   count, timeout)
+#define prism_shl_ui128(device, a, shift, out, count, timeout)                 \
+  prism_bigint_shl(device, PRISM_BIGINT_128, (a)->limb, shift, (out)->limb,    \
+                   count, timeout)
+#define prism_shr_ui128(device, a, shift, out, count, timeout)                 \
+  prism_bigint_shr(device, PRISM_BIGINT_128, (a)->limb, shift, (out)->limb,    \
+                   count, timeout)
+
+#define prism_add_ui256(device, a, b, out, count, timeout)                     \
+  prism_bigint_add(device, PRISM_BIGINT_256, (a)->limb, (b)->limb,             \
+                   (out)->limb, count, 0, timeout)
+#define prism_sub_ui256(device, a, b, out, count, timeout)                     \
+  prism_bigint_sub(device, PRISM_BIGINT_256, (a)->limb, (b)->limb,             \
+                   (out)->limb, count, 0, timeout)
+#define prism_cmp_ui256(device, a, b, result, count, timeout)                  \
+  prism_bigint_cmp(device, PRISM_BIGINT_256, (a)->limb, (b)->limb, result,     \
+                   count, timeout)
+#define prism_shl_ui256(device, a, shift, out, count, timeout)                 \
+  prism_bigint_shl(device, PRISM_BIGINT_256, (a)->limb, shift, (out)->limb,    \
+                   count, timeout)
+#define prism_shr_ui256(device, a, shift, out, count, timeout)                 \
+  prism_bigint_shr(device, PRISM_BIGINT_256, (a)->limb, shift, (out)->limb,    \
+                   count, timeout)
+#endif // PRISM_ENABLE_LONGTYPES
+#endif // PRISM_ENABLE_64BIT_EXT
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_BIGINT__
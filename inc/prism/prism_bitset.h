@@ -0,0 +1,134 @@
+/**
+ * @file prism_bitset.h
+ * @brief Bitmaps of arbitrary size for the Prism library.
+ * Set operations stream the bitmaps through the coprocessor in 256-bit blocks,
+ * one bank per block. Blocks whose result follows from an all-zero operand
+ * (x & 0, x | 0, x & ~0, ...) are resolved on the host and never sent. The
+ * result of every block comes down while the next block goes up
+ * (_prism_exchange_bank_ptr).
+ * Population count and the any/all tests run on the host; the device has no
+ * popcount instruction and the answer is a single scalar.
+ * @note Bits past the size of a bitmap are kept zero by every call.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_BITSET__
+#define __PRISM_BITSET__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Number of ui32 words that hold the given number of bits
+#define PRISM_BITSET_WORDS(bits) (((bits) + 31) / 32)
+
+/**
+ * @brief A bitmap in caller memory.
+ */
+typedef struct prism_bitset {
+  ui32 *words; // PRISM_BITSET_WORDS(bits) words, bit i in words[i / 32]
+  size_t bits; // Size of the bitmap in bits
+} prism_bitset_t;
+
+/**
+ * @brief Set operations of prism_bitset_op.
+ */
+typedef enum prism_bitset_op {
+  PRISM_BITSET_UNION = 0,      // a | b
+  PRISM_BITSET_INTERSECT = 1,  // a & b
+  PRISM_BITSET_DIFFERENCE = 2, // a & ~b
+  PRISM_BITSET_SYMDIFF = 3     // a ^ b
+} prism_bitset_op_t;
+
+/**
+ * @brief Attaches a bitmap to caller memory and clears it.
+ * @param set The bitmap.
+ * @param words Storage of PRISM_BITSET_WORDS(bits) words.
+ * @param bits Size of the bitmap in bits.
+ */
+extern void prism_bitset_init(prism_bitset_t *set, ui32 *words,
+                              const size_t bits);
+
+static inline void prism_bitset_set(prism_bitset_t *set, const size_t bit) {
+  if (bit < set->bits) {
+    set->words[bit / 32] |= (ui32)1 << (bit % 32);
+  }
+}
+
+static inline void prism_bitset_clear(prism_bitset_t *set, const size_t bit) {
+  if (bit < set->bits) {
+    set->words[bit / 32] &= ~((ui32)1 << (bit % 32));
+  }
+}
+
+static inline bool prism_bitset_test(const prism_bitset_t *set,
+                                     const size_t bit) {
+  return bit < set->bits && (set->words[bit / 32] >> (bit % 32)) & 1;
+}
+
+/**
+ * @brief out = a op b for bitmaps of the same size.
+ * @param device Pointer to the Prism device structure.
+ * @param op The set operation.
+ * @param a, b The operands.
+ * @param out The result. May be a or b.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT if the sizes differ, or
+ * the error of the failed device command.
+ */
+extern prism_err prism_bitset_op(const prdev_t *device,
+                                 const prism_bitset_op_t op,
+                                 const prism_bitset_t *a,
+                                 const prism_bitset_t *b, prism_bitset_t *out,
+                                 ui32 timeout);
+
+/**
+ * @brief out = ~a for bitmaps of the same size. All-zero blocks become
+ * all-one blocks on the host.
+ * @param device Pointer to the Prism device structure.
+ * @param a The operand.
+ * @param out The result. May be a.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_bitset_complement(const prdev_t *device,
+                                         const prism_bitset_t *a,
+                                         prism_bitset_t *out, ui32 timeout);
+
+/**
+ * @brief Number of set bits.
+ */
+extern size_t prism_bitset_count(const prism_bitset_t *set);
+
+/**
+ * @brief true if at least one bit is set. Stops at the first non-zero word.
+ */
+extern bool prism_bitset_any(const prism_bitset_t *set);
+
+/**
+ * @brief true if every bit is set. Stops at the first word with a clear bit.
+ */
+extern bool prism_bitset_all(const prism_bitset_t *set);
+
+#define prism_bitset_union(device, a, b, out, timeout)                         \
+  prism_bitset_op(device, PRISM_BITSET_UNION, a, b, out, timeout)
+#define prism_bitset_intersect(device, a, b, out, timeout)                     \
+  prism_bitset_op(device, PRISM_BITSET_INTERSECT, a, b, out, timeout)
+#define prism_bitset_difference(device, a, b, out, timeout)                    \
+  prism_bitset_op(device, PRISM_BITSET_DIFFERENCE, a, b, out, timeout)
+#define prism_bitset_symdiff(device, a, b, out, timeout)                       \
+  prism_bitset_op(device, PRISM_BITSET_SYMDIFF, a, b, out, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_BITSET__
@@ -0,0 +1,294 @@
+/**
+ * @file prism_coro.h
+ * @brief C++20 coroutine front end of the Prism library.
+ * A prism::scheduler interleaves many coroutines over one or more devices on
+ * a single thread. Every command frame is an awaitable built on the
+ * non-blocking prism_submit_opcode / prism_poll layer, so a coroutine that
+ * waits for a device does not block the others:
+ *
+ *   prism::task add(prism::scheduler &s, const prdev_t *dev, ...) {
+ *     prism::device_guard guard = co_await s.lock(dev);
+ *     co_await s.store(dev, PRISM_BANK_A, a);
+ *     co_await s.store(dev, PRISM_BANK_B, b);
+ *     co_await s.op(dev, PRISM_OPCODE_ADD_N, PRISM_OPCODE_TYPE_UI32, 8);
+ *     co_return co_await s.load(dev, PRISM_BANK_C, out);
+ *   }
+ *
+ * Frames for the same device are sent one after the other. Coroutines that
+ * share a device must hold its lock while they use the banks.
+ * @note Only available when the compiler supports C++20 coroutines. Define
+ * PRISM_ENABLE_COROUTINES to 0 or 1 to override.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_CORO__
+#define __PRISM_CORO__ 1
+
+#include "prism/prism.h"
+#include "prism/prism_async.h"
+
+#ifndef PRISM_ENABLE_COROUTINES
+#if defined(__cplusplus) && defined(__cpp_impl_coroutine)
+#define PRISM_ENABLE_COROUTINES 1
+#else
+#define PRISM_ENABLE_COROUTINES 0
+#endif
+#endif // PRISM_ENABLE_COROUTINES
+
+#if PRISM_ENABLE_COROUTINES == 1
+
+#include <coroutine>
+#include <new>
+#include <stddef.h>
+
+// Devices a scheduler can lock at the same time
+#define PRISM_CORO_MAX_DEVICES 8
+
+namespace prism {
+
+class scheduler;
+
+/**
+ * @brief Coroutine that returns a prism_err. Starts when it is awaited or
+ * passed to scheduler::spawn.
+ */
+class task {
+public:
+  struct promise_type;
+  typedef std::coroutine_handle<promise_type> handle_type;
+
+  struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(handle_type handle) noexcept;
+    void await_resume() const noexcept {}
+  };
+
+  struct promise_type {
+    prism_err result = PR_OK;
+    std::coroutine_handle<> continuation;
+    scheduler *owner = nullptr; // Set by scheduler::spawn
+    promise_type *next = nullptr;
+
+    task get_return_object() noexcept {
+      return task(handle_type::from_promise(*this));
+    }
+    // Frames are allocated with nothrow new, a failed allocation returns an
+    // empty task that reports PR_ERR_OUT_OF_MEMORY
+    static task get_return_object_on_allocation_failure() noexcept {
+      return task(nullptr);
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void return_value(prism_err err) noexcept { result = err; }
+    void unhandled_exception() noexcept { result = PR_ERR_UNKNOWN; }
+  };
+
+  task(task &&other) noexcept : m_handle(other.m_handle) {
+    other.m_handle = nullptr;
+  }
+  task(const task &) = delete;
+  task &operator=(const task &) = delete;
+  ~task() {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+
+  bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<> continuation) noexcept {
+    m_handle.promise().continuation = continuation;
+    return m_handle; // Start the task, it resumes the awaiter when done
+  }
+  prism_err await_resume() const noexcept {
+    return m_handle ? m_handle.promise().result : PR_ERR_OUT_OF_MEMORY;
+  }
+
+private:
+  friend class scheduler;
+  explicit task(handle_type handle) noexcept : m_handle(handle) {}
+
+  handle_type m_handle;
+};
+
+/**
+ * @brief Awaits one command frame. Resumes with its prism_err.
+ */
+class frame_awaiter {
+public:
+  frame_awaiter(scheduler &sched, const prdev_t *device, const uint16_t op,
+                const ui8 type, const ui8 arg, const ui32 imm,
+                const bool has_imm, timeout_t timeout) noexcept;
+
+  bool await_ready() noexcept;
+  void await_suspend(std::coroutine_handle<> handle) noexcept;
+  prism_err await_resume() const noexcept { return m_err; }
+
+private:
+  friend class scheduler;
+
+  scheduler &m_sched;
+  const prdev_t *m_device;
+  uint16_t m_op;
+  ui8 m_type;
+  ui8 m_arg;
+  ui32 m_imm;
+  bool m_has_imm;
+  bool m_submitted;
+  timeout_t m_timeout;
+  prism_pending_t m_pending;
+  prism_err m_err;
+  std::coroutine_handle<> m_handle;
+  frame_awaiter *m_next;
+};
+
+/**
+ * @brief Exclusive use of a device, released when the guard is destroyed.
+ */
+class device_guard {
+public:
+  device_guard(scheduler *sched, const prdev_t *device) noexcept
+      : m_sched(sched), m_device(device) {}
+  device_guard(device_guard &&other) noexcept
+      : m_sched(other.m_sched), m_device(other.m_device) {
+    other.m_sched = nullptr;
+  }
+  device_guard(const device_guard &) = delete;
+  device_guard &operator=(const device_guard &) = delete;
+  ~device_guard();
+
+private:
+  scheduler *m_sched;
+  const prdev_t *m_device;
+};
+
+/**
+ * @brief Awaits the lock of a device. Resumes with its device_guard.
+ */
+class lock_awaiter {
+public:
+  lock_awaiter(scheduler &sched, const prdev_t *device) noexcept
+      : m_sched(sched), m_device(device), m_next(nullptr) {}
+
+  bool await_ready() noexcept;
+  void await_suspend(std::coroutine_handle<> handle) noexcept;
+  device_guard await_resume() noexcept {
+    return device_guard(&m_sched, m_device);
+  }
+
+private:
+  friend class scheduler;
+
+  scheduler &m_sched;
+  const prdev_t *m_device;
+  std::coroutine_handle<> m_handle;
+  lock_awaiter *m_next;
+};
+
+/**
+ * @brief Runs coroutines on one thread and drives their device frames.
+ */
+class scheduler {
+public:
+  /**
+   * @param timeout The timeout value in milliseconds for every frame.
+   */
+  explicit scheduler(timeout_t timeout = 1000) noexcept;
+  ~scheduler();
+
+  scheduler(const scheduler &) = delete;
+  scheduler &operator=(const scheduler &) = delete;
+
+  /**
+   * @brief Starts a task. The scheduler owns it until it finishes.
+   * @return PR_OK, or PR_ERR_OUT_OF_MEMORY if the task has no frame.
+   */
+  prism_err spawn(task &&t) noexcept;
+
+  /**
+   * @brief Polls every pending frame once and resumes the finished ones.
+   * Never blocks on a transport that provides poll_status.
+   * @return true while spawned tasks are still running.
+   */
+  bool poll() noexcept;
+
+  /**
+   * @brief Polls until every spawned task finished.
+   */
+  void run() noexcept;
+
+  /**
+   * @brief Number of spawned tasks that did not finish yet.
+   */
+  size_t running() const noexcept { return m_running; }
+
+  // Awaitables for a single command frame
+  frame_awaiter opcode(const prdev_t *device, const uint16_t op,
+                       const ui8 type, const ui8 arg) noexcept;
+  frame_awaiter opcode_imm(const prdev_t *device, const uint16_t op,
+                           const ui8 type, const ui8 arg,
+                           const ui32 imm) noexcept;
+  // A vector operation on the first lanes (1 to 8) of banks A and B, sent
+  // with the frame prism_op builds: arg is the immediate of scalar opcodes,
+  // the count of shifts and ignored otherwise
+  frame_awaiter op(const prdev_t *device, const uint16_t op, const ui8 type,
+                   const ui8 lanes, const ui32 arg = 0) noexcept;
+
+  // Bank transfers, the STORE or LOAD frame and the closing END frame are
+  // awaited, the 32 data bytes are moved in between
+  task store(const prdev_t *device, const bank_t bank, const ui32 *src);
+  task load(const prdev_t *device, const bank_t bank, ui32 *out);
+
+  // Exclusive use of a device across several awaits
+  lock_awaiter lock(const prdev_t *device) noexcept;
+
+private:
+  friend class task;
+  friend class frame_awaiter;
+  friend class lock_awaiter;
+  friend class device_guard;
+
+  void finished(task::handle_type handle) noexcept;
+  bool device_busy(const prdev_t *device) const noexcept;
+  void submit(frame_awaiter *frame) noexcept;
+  void enqueue(frame_awaiter *frame) noexcept;
+  bool try_lock(const prdev_t *device) noexcept;
+  void wait_lock(lock_awaiter *waiter) noexcept;
+  void unlock(const prdev_t *device) noexcept;
+
+  timeout_t m_timeout;
+  size_t m_running;
+  task::promise_type *m_tasks;  // Spawned tasks
+  frame_awaiter *m_frames;      // Frames waiting to be sent or answered
+  lock_awaiter *m_lock_waiters; // Coroutines waiting for a device
+  lock_awaiter *m_granted;      // Lock hand-overs resumed by the next poll
+  const prdev_t *m_locked[PRISM_CORO_MAX_DEVICES];
+};
+
+inline std::coroutine_handle<>
+task::final_awaiter::await_suspend(handle_type handle) noexcept {
+  promise_type &promise = handle.promise();
+  if (promise.continuation) {
+    return promise.continuation;
+  }
+  if (promise.owner != nullptr) {
+    promise.owner->finished(handle); // Destroys the frame
+  }
+  return std::noop_coroutine();
+}
+
+inline device_guard::~device_guard() {
+  if (m_sched != nullptr) {
+    m_sched->unlock(m_device);
+  }
+}
+
+} // namespace prism
+
+#endif // PRISM_ENABLE_COROUTINES == 1
+
+#endif // __PRISM_CORO__
@@ -0,0 +1,136 @@
+/**
+ * @file prism_dispatch.h
+ * @brief Cost-model based offload decision for streaming PRISM operations.
+ * Offloading a vector operation to the PRISM coprocessor costs two bank
+ * uploads, one command frame and one bank download. For cheap operations such
+ * as ADD or AND this is often slower than doing the math on the host. The
+ * dispatcher keeps a per-device cost model that is seeded from the measured
+ * link latency and P²Link throughput and refined after every streaming call.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_DISPATCH__
+#define __PRISM_DISPATCH__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+// Number of binary operations tracked by the cost model (ADD_N ... NOR_N)
+#define PRISM_COST_OP_COUNT (PRISM_OPCODE_NOR_N - PRISM_OPCODE_ADD_N + 1)
+
+// Command frames needed for one device block: STORE_A+END, STORE_B+END, OP,
+// LOAD_C+END
+#define PRISM_COST_FRAMES_PER_BLOCK 7
+// P²Link payload bytes for one device block: two uploads and one download
+#define PRISM_COST_BYTES_PER_BLOCK (3 * sizeof(_v256i))
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Where a streaming operation is executed.
+ */
+typedef enum prism_exec_enum {
+  PRISM_EXEC_HOST = 0x00,   // Everything is computed on the host
+  PRISM_EXEC_DEVICE = 0x01, // Everything is computed on the coprocessor
+  PRISM_EXEC_SPLIT = 0x02   // Full blocks on the device, the tail on the host
+} prism_exec_t;
+
+/**
+ * @brief Per-device cost model used by prism_stream_op.
+ * The link figures are measured once by prism_cost_model_init. The block and
+ * host costs start as estimates and are refined with an exponential moving
+ * average after every call of prism_stream_op.
+ */
+typedef struct prism_cost_model {
+  ui32 link_latency_us;  // Duration of one command frame including the ack
+  ui32 link_bytes_per_s; // P²Link payload throughput
+  ui32 block_us;         // Device cost of one 8-lane block (refined)
+  ui32 host_ns_per_lane[PRISM_COST_OP_COUNT]; // Host cost per lane (refined)
+} prism_cost_model_t;
+
+/**
+ * @brief Seeds the cost model of a device.
+ * Measures the latency of a single command frame, the P²Link throughput of a
+ * bank D download and the host cost of every tracked operation.
+ * @param device Pointer to the Prism device structure.
+ * @param model The cost model to initialize.
+ * @param timeout The timeout value in milliseconds for the measurements.
+ * @return PR_OK on success or the error of the failed measurement.
+ */
+extern prism_err prism_cost_model_init(const prdev_t *device,
+                                       prism_cost_model_t *model,
+                                       timeout_t timeout);
+
+/**
+ * @brief Decides where a streaming operation of n lanes should run.
+ * @param model The cost model of the device.
+ * @param op One of the binary opcodes PRISM_OPCODE_ADD_N ... NOR_N.
+ * @param n Number of 32-bit lanes to process.
+ * @param device_lanes Receives the number of lanes to run on the device. May
+ * be NULL.
+ * @return The chosen execution path.
+ */
+extern prism_exec_t prism_cost_decide(const prism_cost_model_t *model,
+                                      const uint16_t op, const size_t n,
+                                      size_t *device_lanes);
+
+/**
+ * @brief Computes out[i] = a[i] op b[i] on the faster side.
+ * The call chooses between host and coprocessor with prism_cost_decide, runs
+ * the work and refines the model with the measured duration. The results are
+ * identical on both paths.
+ * @param device Pointer to the Prism device structure.
+ * @param model The cost model of the device, refined by this call.
+ * @param op One of the binary opcodes PRISM_OPCODE_ADD_N ... NOR_N.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param a, b The input arrays of n lanes.
+ * @param out The output array of n lanes. May alias a or b.
+ * @param n Number of lanes.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_stream_op(const prdev_t *device,
+                                 prism_cost_model_t *model, const uint16_t op,
+                                 const ui8 type, const ui32 *a, const ui32 *b,
+                                 ui32 *out, const size_t n, timeout_t timeout);
+
+#define prism_stream_add_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_ADD_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_sub_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_SUB_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_mul_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_mul_si32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_SI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_div_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_DIV_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_div_si32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_DIV_N, PRISM_OPCODE_TYPE_SI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_and_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_AND_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+#define prism_stream_or_ui32(device, model, a, b, out, n, timeout)             \
+  prism_stream_op(device, model, PRISM_OPCODE_OR_N, PRISM_OPCODE_TYPE_UI32,    \
+                  a, b, out, n, timeout)
+#define prism_stream_xor_ui32(device, model, a, b, out, n, timeout)            \
+  prism_stream_op(device, model, PRISM_OPCODE_XOR_N, PRISM_OPCODE_TYPE_UI32,   \
+                  a, b, out, n, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_DISPATCH__
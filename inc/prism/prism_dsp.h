@@ -0,0 +1,198 @@
+/**
+ * @file prism_dsp.h
+ * @brief Fixed-point DSP kernels for the Prism library.
+ * FIR filtering, dot products, multiply-accumulate and moving averages on
+ * signed 32-bit samples in Q format. The device has two operand banks and no
+ * lane shift, so the kernels pick one of two layouts:
+ * - FIR and dot product keep one operand resident in bank B (no-clear-after-op
+ *   mode) and stream the other into bank A. Each product vector is downloaded
+ *   while the next operand goes up (_prism_exchange_bank_ptr) and its 8 lanes
+ *   are summed on the host in 64 bits.
+ * - MAC and moving average keep the accumulator resident in bank B and only
+ *   upload the new vector of every step; the scale factor travels in the
+ *   scalar-immediate frame (PRISM_OPCODE_MUL_S).
+ * @note Products are computed with 32-bit device multiplies. Scale samples and
+ * coefficients so that every product fits into 32 bits, e.g. Q15 samples
+ * with Q15 coefficients give Q30 products and q = 15 restores Q15.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_DSP__
+#define __PRISM_DSP__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Longest FIR filter, a multiple of 8
+#define PRISM_FIR_MAX_TAPS 32
+// Outputs computed per coefficient upload
+#define PRISM_FIR_CHUNK 16
+// History kept between calls of prism_fir_process
+#define PRISM_FIR_HISTORY (PRISM_FIR_MAX_TAPS - 1)
+
+/**
+ * @brief State of a FIR filter.
+ */
+typedef struct prism_fir {
+  const prdev_t *device;
+  ui32 timeout; // Timeout in milliseconds for every device command
+  ui8 taps;     // Number of coefficients
+  ui8 blocks;   // Coefficient vectors, taps rounded up to 8
+  ui8 q;        // Fraction bits removed from every output
+  // Coefficient vectors in bank order, reversed and zero padded:
+  // coeff[8 * j + l] = h[8 * j + 7 - l]
+  si32 coeff[PRISM_FIR_MAX_TAPS];
+  // The last samples of the previous call followed by the current chunk
+  si32 line[PRISM_FIR_HISTORY + PRISM_FIR_CHUNK];
+} prism_fir_t;
+
+/**
+ * @brief Initializes a FIR filter y[n] = sum(h[k] * x[n - k]) >> q.
+ * @param fir The filter state.
+ * @param device Pointer to the Prism device structure.
+ * @param h The coefficients, h[0] applies to the newest sample.
+ * @param taps Number of coefficients, 1 to PRISM_FIR_MAX_TAPS.
+ * @param q Fraction bits removed from every output with rounding, 0 to 31.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_fir_init(prism_fir_t *fir, const prdev_t *device,
+                                const si32 *h, const ui8 taps, const ui8 q,
+                                ui32 timeout);
+
+/**
+ * @brief Clears the sample history of a FIR filter.
+ */
+extern void prism_fir_reset(prism_fir_t *fir);
+
+/**
+ * @brief Filters n samples. The history carries over between calls, so a
+ * stream can be filtered in blocks of any size.
+ * Every coefficient vector is uploaded once per PRISM_FIR_CHUNK outputs.
+ * Per output and coefficient vector the device runs one MUL and one bank
+ * exchange: 3 frames on a full-duplex link, 5 frames otherwise.
+ * @param fir The filter state.
+ * @param in The input samples.
+ * @param out Receives n filtered samples, saturated to 32 bits. May be in.
+ * @param n Number of samples.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_fir_process(prism_fir_t *fir, const si32 *in,
+                                   si32 *out, const size_t n);
+
+/**
+ * @brief Dot product of two vectors of n signed lanes.
+ * Full 8-lane blocks are multiplied on the device, the products are summed on
+ * the host in 64 bits. A ragged tail is computed on the host.
+ * @param device Pointer to the Prism device structure.
+ * @param a, b The operands.
+ * @param n Number of lanes.
+ * @param result Receives the 64-bit sum of the products.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_dot_si32(const prdev_t *device, const si32 *a,
+                                const si32 *b, const size_t n, int64_t *result,
+                                ui32 timeout);
+
+/**
+ * @brief State of a running multiply-accumulate acc += x * s.
+ */
+typedef struct prism_mac {
+  const prdev_t *device;
+  ui8 type;     // PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32
+  ui32 count;   // Vectors accumulated
+  ui32 timeout; // Timeout in milliseconds for every device command
+} prism_mac_t;
+
+/**
+ * @brief Starts a multiply-accumulate with every lane of the accumulator set
+ * to init. Switches the device to no-clear-after-op mode; the accumulator
+ * stays in bank B until prism_mac_end.
+ * @param ctx The MAC state to initialize.
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param init Start value of every lane, e.g. the rounding constant of a
+ * later shift.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_mac_begin(prism_mac_t *ctx, const prdev_t *device,
+                                 const ui8 type, const ui32 init,
+                                 ui32 timeout);
+
+/**
+ * @brief acc += x * s on all 8 lanes. Uploads x only; s travels in the frame.
+ * With s == 1 the multiply is skipped.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_mac_push(prism_mac_t *ctx, const ui32 *x, const ui32 s);
+
+/**
+ * @brief Sets every lane of the accumulator to init and keeps the device in
+ * no-clear-after-op mode, to start the next sum without prism_mac_end.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_mac_reset(prism_mac_t *ctx, const ui32 init);
+
+/**
+ * @brief Applies op with an immediate to the accumulator, e.g.
+ * PRISM_OPCODE_DIV_S to scale the result down on the device.
+ */
+extern prism_err prism_mac_apply(prism_mac_t *ctx, const uint16_t op,
+                                 const ui32 imm);
+
+/**
+ * @brief Downloads the accumulator, the MAC keeps running.
+ * @param ctx The running MAC.
+ * @param acc Receives the 8 accumulated lanes.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_mac_read(prism_mac_t *ctx, ui32 *acc);
+
+/**
+ * @brief Downloads the accumulator and restores clear-after-op mode.
+ * @param ctx The running MAC.
+ * @param acc Receives the 8 accumulated lanes.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_mac_end(prism_mac_t *ctx, ui32 *acc);
+
+/**
+ * @brief Moving average over a window of samples.
+ * out[i] = (x[i] + ... + x[i + window - 1]) / window for the n - window + 1
+ * complete windows. Eight outputs share one device accumulator; the division
+ * runs on the device and truncates toward zero.
+ * @param device Pointer to the Prism device structure.
+ * @param x The input samples.
+ * @param n Number of input samples, at least window.
+ * @param window Window length, at least 1.
+ * @param out Receives n - window + 1 averages.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_moving_average_si32(const prdev_t *device,
+                                           const si32 *x, const size_t n,
+                                           const ui8 window, si32 *out,
+                                           ui32 timeout);
+
+#define prism_mac_begin_si32(ctx, device, init, timeout)                       \
+  prism_mac_begin(ctx, device, PRISM_OPCODE_TYPE_SI32, (ui32)(init), timeout)
+#define prism_mac_push_si32(ctx, x, s)                                         \
+  prism_mac_push(ctx, (const ui32 *)(x), (ui32)(s))
+#define prism_mac_end_si32(ctx, acc) prism_mac_end(ctx, (ui32 *)(acc))
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_DSP__
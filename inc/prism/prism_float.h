@@ -0,0 +1,272 @@
+/**
+ * @file prism_float.h
+ * @brief IEEE754 single and half precision lanes for the Prism library.
+ * With PRISM_ENABLE_IEE754 a vector holds 8 floats (PRISM_OPCODE_TYPE_FL,
+ * the `fl` view of _v256i) or 16 half floats (PRISM_OPCODE_TYPE_HF, the `hf`
+ * view). The coprocessor does the float math, so hosts without an FPU only
+ * pack and unpack lanes. Half floats carry twice the lanes per transfer; the
+ * host converts them with prism_half_from_float and prism_half_to_float,
+ * which need no FPU either.
+ * @note Compares write the integer 1 (not 1.0f) into every lane that
+ * compares true, like the integer compares, so the masks work with
+ * prism/prism_select.h. NaN compares false except for not-equal.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_FLOAT__
+#define __PRISM_FLOAT__ 1
+
+#include "prism/prism.h"
+
+#ifdef PRISM_ENABLE_IEE754
+
+#include <stddef.h>
+#include <string.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Converts a float to half precision, rounding to nearest even.
+ * Values beyond the half range become infinity, tiny values subnormal or
+ * zero.
+ * @param x The float.
+ * @return The binary16 bit pattern.
+ */
+extern ui16 prism_half_from_float(const float x);
+
+/**
+ * @brief Converts a half float to a float. Exact for every half value.
+ * @param h The binary16 bit pattern.
+ * @return The float.
+ */
+extern float prism_half_to_float(const ui16 h);
+
+/**
+ * @brief Converts n floats to half precision.
+ */
+extern void prism_half_from_float_n(const float *src, ui16 *dst,
+                                    const size_t n);
+
+/**
+ * @brief Converts n half floats to floats.
+ */
+extern void prism_half_to_float_n(const ui16 *src, float *dst,
+                                  const size_t n);
+
+/**
+ * @brief Bit pattern of a float, for the immediate of scalar opcodes.
+ */
+static inline ui32 _prism_fl_bits(const float x) {
+  ui32 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Sets a 256-bit vector with 8 floats.
+ * @param a, b, c, d, e, f, g, h The 8 floats to be set in the vector.
+ * @return A 256-bit vector initialized with the specified values.
+ */
+static inline _v256i _v256_set8_flv(const float a, const float b,
+                                    const float c, const float d,
+                                    const float e, const float f,
+                                    const float g, const float h) {
+  _v256i v;
+  v.fl[0] = a;
+  v.fl[1] = b;
+  v.fl[2] = c;
+  v.fl[3] = d;
+  v.fl[4] = e;
+  v.fl[5] = f;
+  v.fl[6] = g;
+  v.fl[7] = h;
+  return v;
+}
+
+#define _v256_set7_flv(a, b, c, d, e, f, g)                                    \
+  _v256_set8_flv(a, b, c, d, e, f, g, 0.0f)
+#define _v256_set6_flv(a, b, c, d, e, f)                                       \
+  _v256_set8_flv(a, b, c, d, e, f, 0.0f, 0.0f)
+#define _v256_set5_flv(a, b, c, d, e)                                          \
+  _v256_set8_flv(a, b, c, d, e, 0.0f, 0.0f, 0.0f)
+#define _v256_set4_flv(a, b, c, d)                                             \
+  _v256_set8_flv(a, b, c, d, 0.0f, 0.0f, 0.0f, 0.0f)
+#define _v256_set3_flv(a, b, c)                                                \
+  _v256_set8_flv(a, b, c, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f)
+#define _v256_set2_flv(a, b)                                                   \
+  _v256_set8_flv(a, b, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f)
+#define _v256_set1_flv(a)                                                      \
+  _v256_set8_flv(a, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f)
+
+/**
+ * @brief Sets every float lane of a vector to x.
+ */
+static inline _v256i _v256_splat_flv(const float x) {
+  return _v256_set8_flv(x, x, x, x, x, x, x, x);
+}
+
+/**
+ * @brief Packs 16 floats into the half float lanes of a vector.
+ * @param src 16 floats.
+ * @return A 256-bit vector of 16 half floats.
+ */
+static inline _v256i _v256_set_hfv_p(const float *src) {
+  _v256i v;
+  prism_half_from_float_n(src, v.hf, 16);
+  return v;
+}
+
+/**
+ * @brief Sets every half float lane of a vector to x.
+ */
+static inline _v256i _v256_splat_hfv(const float x) {
+  const ui16 h = prism_half_from_float(x);
+  _v256i v;
+  for (ui8 i = 0; i < 16; i++) {
+    v.hf[i] = h;
+  }
+  return v;
+}
+
+static inline float _v256_extract_fl(const _v256i v, const ui8 n) {
+  return v.fl[n % 8];
+}
+
+static inline float _v256_extract_hf(const _v256i v, const ui8 n) {
+  return prism_half_to_float(v.hf[n % 16]);
+}
+
+/**
+ * @brief Unpacks the 16 half float lanes of a vector into floats.
+ */
+static inline void _v256_get_hfv_p(const _v256i *v, float *dst) {
+  prism_half_to_float_n(v->hf, dst, 16);
+}
+
+/**
+ * @brief Compares bank A with bank B as lanes of the given type, result in
+ * bank C.
+ * @param device Pointer to the Prism device structure.
+ * @param op PRISM_OPCODE_CMP_EQ to PRISM_OPCODE_CMP_LE.
+ * @param type PRISM_OPCODE_TYPE_FL or PRISM_OPCODE_TYPE_HF.
+ * @param vector_len Number of 32-bit units, 1 to 8.
+ * @param timeout The timeout value in milliseconds.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+#define _v256_cmpN_fx(device, op, type, vector_len, timeout)                   \
+  prism_op(device, op, type, vector_len, 0, timeout)
+
+// Lane-wise arithmetic on the first vector_len floats of A and B
+#define _v256_addN_fl(device, vector_len, timeout)                             \
+  _v256_addN_ui32(device, PRISM_OPCODE_TYPE_FL, vector_len, timeout)
+#define _v256_subN_fl(device, vector_len, timeout)                             \
+  _v256_subN_ui32(device, PRISM_OPCODE_TYPE_FL, vector_len, timeout)
+#define _v256_mulN_fl(device, vector_len, timeout)                             \
+  _v256_mulN_ui32(device, PRISM_OPCODE_TYPE_FL, vector_len, timeout)
+#define _v256_divN_fl(device, vector_len, timeout)                             \
+  _v256_divN_ui32(device, PRISM_OPCODE_TYPE_FL, vector_len, timeout)
+
+#define _v256_add8_fl(device, timeout) _v256_addN_fl(device, 8, timeout)
+#define _v256_sub8_fl(device, timeout) _v256_subN_fl(device, 8, timeout)
+#define _v256_mul8_fl(device, timeout) _v256_mulN_fl(device, 8, timeout)
+#define _v256_div8_fl(device, timeout) _v256_divN_fl(device, 8, timeout)
+
+// 16 half floats fill the 8 32-bit units of a vector
+#define _v256_add16_hf(device, timeout)                                        \
+  _v256_addN_ui32(device, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_sub16_hf(device, timeout)                                        \
+  _v256_subN_ui32(device, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_mul16_hf(device, timeout)                                        \
+  _v256_mulN_ui32(device, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_div16_hf(device, timeout)                                        \
+  _v256_divN_ui32(device, PRISM_OPCODE_TYPE_HF, 8, timeout)
+
+#define _v256_cmpeq8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_EQ, PRISM_OPCODE_TYPE_FL, 8, timeout)
+#define _v256_cmpne8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_NE, PRISM_OPCODE_TYPE_FL, 8, timeout)
+#define _v256_cmpgt8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_GT, PRISM_OPCODE_TYPE_FL, 8, timeout)
+#define _v256_cmpge8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_GE, PRISM_OPCODE_TYPE_FL, 8, timeout)
+#define _v256_cmplt8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_TYPE_FL, 8, timeout)
+#define _v256_cmple8_fl(device, timeout)                                       \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_LE, PRISM_OPCODE_TYPE_FL, 8, timeout)
+
+#define _v256_cmpeq16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_EQ, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_cmpne16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_NE, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_cmpgt16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_GT, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_cmpge16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_GE, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_cmplt16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_TYPE_HF, 8, timeout)
+#define _v256_cmple16_hf(device, timeout)                                      \
+  _v256_cmpN_fx(device, PRISM_OPCODE_CMP_LE, PRISM_OPCODE_TYPE_HF, 8, timeout)
+
+// The immediate of the scalar forms travels as its bit pattern
+#define _v256_add_scalar_fl(device, value, vector_len, timeout)                \
+  _v256_opN_scalar(device, PRISM_OPCODE_ADD_S, PRISM_OPCODE_TYPE_FL,           \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_sub_scalar_fl(device, value, vector_len, timeout)                \
+  _v256_opN_scalar(device, PRISM_OPCODE_SUB_S, PRISM_OPCODE_TYPE_FL,           \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_mul_scalar_fl(device, value, vector_len, timeout)                \
+  _v256_opN_scalar(device, PRISM_OPCODE_MUL_S, PRISM_OPCODE_TYPE_FL,           \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_div_scalar_fl(device, value, vector_len, timeout)                \
+  _v256_opN_scalar(device, PRISM_OPCODE_DIV_S, PRISM_OPCODE_TYPE_FL,           \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_cmpgt_scalar_fl(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GT_S, PRISM_OPCODE_TYPE_FL,        \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_cmpge_scalar_fl(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_GE_S, PRISM_OPCODE_TYPE_FL,        \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_cmplt_scalar_fl(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LT_S, PRISM_OPCODE_TYPE_FL,        \
+                   vector_len, _prism_fl_bits(value), timeout)
+#define _v256_cmple_scalar_fl(device, value, vector_len, timeout)              \
+  _v256_opN_scalar(device, PRISM_OPCODE_CMP_LE_S, PRISM_OPCODE_TYPE_FL,        \
+                   vector_len, _prism_fl_bits(value), timeout)
+
+#define _v256_add_scalar_hf(device, value, timeout)                            \
+  _v256_opN_scalar(device, PRISM_OPCODE_ADD_S, PRISM_OPCODE_TYPE_HF, 8,        \
+                   prism_half_from_float(value), timeout)
+#define _v256_sub_scalar_hf(device, value, timeout)                            \
+  _v256_opN_scalar(device, PRISM_OPCODE_SUB_S, PRISM_OPCODE_TYPE_HF, 8,        \
+                   prism_half_from_float(value), timeout)
+#define _v256_mul_scalar_hf(device, value, timeout)                            \
+  _v256_opN_scalar(device, PRISM_OPCODE_MUL_S, PRISM_OPCODE_TYPE_HF, 8,        \
+                   prism_half_from_float(value), timeout)
+#define _v256_div_scalar_hf(device, value, timeout)                            \
+  _v256_opN_scalar(device, PRISM_OPCODE_DIV_S, PRISM_OPCODE_TYPE_HF, 8,        \
+                   prism_half_from_float(value), timeout)
+
+// Sign manipulation is a bit operation, one mask covers both half floats of a
+// 32-bit unit
+#define _v256_neg8_fl(device, timeout)                                         \
+  _v256_xor_scalar_ui32(device, 0x80000000UL, 8, timeout)
+#define _v256_abs8_fl(device, timeout)                                         \
+  _v256_and_scalar_ui32(device, 0x7FFFFFFFUL, 8, timeout)
+#define _v256_neg16_hf(device, timeout)                                        \
+  _v256_xor_scalar_ui32(device, 0x80008000UL, 8, timeout)
+#define _v256_abs16_hf(device, timeout)                                        \
+  _v256_and_scalar_ui32(device, 0x7FFF7FFFUL, 8, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // PRISM_ENABLE_IEE754
+
+#endif // __PRISM_FLOAT__
@@ -0,0 +1,98 @@
+/**
+ * @file prism_hist.h
+ * @brief Histograms of 8-bit and 16-bit sample streams for the Prism library.
+ * The bins are the lanes of a device-resident vector. Every lane holds the
+ * lower edge of its bin above a counter:
+ *   8-bit samples:  16 bins per vector, lane = edge << 8 | count (UI16)
+ *   16-bit samples:  8 bins per vector, lane = edge << 16 | count (UI32)
+ * One scalar range compare per sample (PRISM_OPCODE_CMP_LE_S with
+ * sample << bits | max count) yields the mask of all bins whose edge is not
+ * above the sample, and adding the mask counts the sample in those lanes:
+ * the counters hold cumulative counts, bin j = count[j] - count[j + 1].
+ * The counters never leave the device until a group of bins is done.
+ * @note One group of bins is resident at a time. The host sends each group
+ * only the samples that fall into its range, so every sample costs one
+ * device update however many bins there are. Runs of equal samples reuse the
+ * mask of their first sample.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_HIST__
+#define __PRISM_HIST__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Largest number of bins
+#define PRISM_HIST_MAX_BINS 256
+
+/**
+ * @brief A histogram with bins in caller memory.
+ * Bin j counts the samples in [edges[j], edges[j + 1]), the last bin every
+ * sample from its edge up to the largest value of the sample type.
+ */
+typedef struct prism_hist {
+  const prdev_t *device;
+  const ui16 *edges; // Lower edge of every bin, strictly ascending
+  ui32 *counts;      // Samples per bin
+  ui16 bins;         // Number of bins
+  ui8 type;          // PRISM_OPCODE_TYPE_UI8 or PRISM_OPCODE_TYPE_UI16
+  ui32 below;        // Samples under edges[0]
+  ui32 timeout;
+} prism_hist_t;
+
+/**
+ * @brief Sets up an empty histogram.
+ * @param hist The histogram.
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI8 or PRISM_OPCODE_TYPE_UI16 samples.
+ * @param edges Lower edge of every bin, strictly ascending and within the
+ * sample type. Must stay valid while the histogram is used.
+ * @param bins Number of bins, 1 to PRISM_HIST_MAX_BINS.
+ * @param counts Receives the count of every bin.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT for bad edges.
+ */
+extern prism_err prism_hist_init(prism_hist_t *hist, const prdev_t *device,
+                                 const ui8 type, const ui16 *edges,
+                                 const ui16 bins, ui32 *counts, ui32 timeout);
+
+/**
+ * @brief Fills edges with bins of the same width starting at lo.
+ * @param edges Room for bins edges.
+ * @param bins Number of bins.
+ * @param lo Lower edge of the first bin.
+ * @param width Width of every bin, at least 1.
+ */
+extern void prism_hist_edges_uniform(ui16 *edges, const ui16 bins,
+                                     const ui16 lo, const ui16 width);
+
+/**
+ * @brief Clears the counts, e.g. before the next window.
+ */
+extern void prism_hist_reset(prism_hist_t *hist);
+
+/**
+ * @brief Counts n samples into the histogram.
+ * @param hist The histogram.
+ * @param samples n samples of the histogram type.
+ * @param n Number of samples.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_hist_add(prism_hist_t *hist, const void *samples,
+                                const size_t n);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_HIST__
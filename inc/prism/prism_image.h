@@ -0,0 +1,137 @@
+/**
+ * @file prism_image.h
+ * @brief 8-bit grayscale image kernels for the Prism library.
+ * Frames are streamed row by row through the coprocessor in blocks of 32
+ * pixels, one pixel per lane of the uib view with PRISM_OPCODE_TYPE_UI8. The
+ * result of every block comes down while the next block goes up
+ * (_prism_exchange_bank_ptr); the last width % 32 pixels of a row are computed
+ * on the host. Every kernel saturates like the host reference, the device
+ * lanes wrap, so overflow is masked with compares on the device.
+ * - Blending needs 16 bits per product and runs 16 pixels per block on the
+ *   uix view (PRISM_OPCODE_TYPE_UI16), the pixels are widened on the host.
+ * - Row sums accumulate byte pairs in 16-bit lanes on the device.
+ * @note Every kernel takes an optional prism_image_stats_t that accumulates the
+ * processed frames and their time, prism_image_fps turns it into frames per
+ * second.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_IMAGE__
+#define __PRISM_IMAGE__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief A grayscale frame in caller memory.
+ */
+typedef struct prism_frame {
+  ui8 *pixels;   // First pixel of the first row
+  ui16 width;    // Pixels per row
+  ui16 height;   // Number of rows
+  size_t stride; // Bytes from one row to the next, at least width
+} prism_frame_t;
+
+/**
+ * @brief Frame counter of the image kernels.
+ */
+typedef struct prism_image_stats {
+  ui32 frames; // Frames processed
+  ui32 micros; // Time spent on them in microseconds
+} prism_image_stats_t;
+
+/**
+ * @brief dst = clamp(src + offset, 0, 255). 7 device operations per block.
+ * @param device Pointer to the Prism device structure.
+ * @param src The source frame.
+ * @param offset Brightness offset, -255 to 255.
+ * @param dst The destination frame, same size as src. May be src.
+ * @param stats Accumulates the frame and its time. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_image_offset(const prdev_t *device,
+                                    const prism_frame_t *src, const si16 offset,
+                                    const prism_frame_t *dst,
+                                    prism_image_stats_t *stats, ui32 timeout);
+
+/**
+ * @brief dst = src > threshold ? 255 : 0. 3 device operations per block.
+ * @param device Pointer to the Prism device structure.
+ * @param src The source frame.
+ * @param threshold Pixels above it are set in the mask.
+ * @param dst The mask frame, same size as src. May be src.
+ * @param stats Accumulates the frame and its time. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_image_threshold(const prdev_t *device,
+                                       const prism_frame_t *src,
+                                       const ui8 threshold,
+                                       const prism_frame_t *dst,
+                                       prism_image_stats_t *stats,
+                                       ui32 timeout);
+
+/**
+ * @brief dst = |a - b|. 9 device operations per block.
+ * @param device Pointer to the Prism device structure.
+ * @param a, b The frames to compare, same size.
+ * @param dst The difference frame, same size. May be a or b.
+ * @param stats Accumulates the frame and its time. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_image_diff(const prdev_t *device, const prism_frame_t *a,
+                                  const prism_frame_t *b,
+                                  const prism_frame_t *dst,
+                                  prism_image_stats_t *stats, ui32 timeout);
+
+/**
+ * @brief dst = (a * alpha + b * (256 - alpha) + 128) / 256.
+ * @param device Pointer to the Prism device structure.
+ * @param a, b The frames to blend, same size.
+ * @param alpha Weight of a, 0 (only b) to 256 (only a).
+ * @param dst The blended frame, same size. May be a or b.
+ * @param stats Accumulates the frame and its time. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_image_blend(const prdev_t *device,
+                                   const prism_frame_t *a,
+                                   const prism_frame_t *b, const ui16 alpha,
+                                   const prism_frame_t *dst,
+                                   prism_image_stats_t *stats, ui32 timeout);
+
+/**
+ * @brief sums[y] = sum of the pixels of row y.
+ * @param device Pointer to the Prism device structure.
+ * @param src The source frame.
+ * @param sums Receives height sums.
+ * @param stats Accumulates the frame and its time. May be NULL.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_image_row_sums(const prdev_t *device,
+                                      const prism_frame_t *src, ui32 *sums,
+                                      prism_image_stats_t *stats,
+                                      ui32 timeout);
+
+/**
+ * @brief Frames per second of the frames counted in stats, 0 if none.
+ */
+extern float prism_image_fps(const prism_image_stats_t *stats);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_IMAGE__
@@ -0,0 +1,89 @@
+/**
+ * @file prism_matrix.h
+ * @brief Matrix-vector and small matrix-matrix products for the Prism library.
+ * Sized for the small dense matrices of neural-net layers and Kalman updates
+ * (up to about 64x64). Matrices are row-major; elements are int8, int16 or
+ * int32, selected with PRISM_OPCODE_TYPE_SI8, _SI16 or _SI32. Products and sums
+ * use the 32-bit device lanes and wrap like them.
+ * - GEMV keeps an 8-element block of x resident in bank B and streams the
+ *   matching block of every row through bank A, downloading each product
+ *   while the next row goes up (_prism_exchange_bank_ptr).
+ * - GEMM accumulates every 8-column tile of the result on the device
+ *   (prism_mac_t): a row of the right operand is uploaded, the element of the
+ *   left operand travels as the MUL_S immediate. Zero elements are skipped.
+ * @note int8 and int16 elements are widened to 32-bit lanes on upload. Sums of
+ * their products need 32 bits, so the narrow uib/six views would overflow
+ * after the first multiply-accumulate.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_MATRIX__
+#define __PRISM_MATRIX__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief y = M * x.
+ * @param device Pointer to the Prism device structure.
+ * @param type Element type of m and x, PRISM_OPCODE_TYPE_SI8, _SI16 or _SI32.
+ * @param m The rows x cols matrix, row-major.
+ * @param rows, cols The dimensions of m.
+ * @param x The vector of cols elements.
+ * @param y Receives rows results.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_gemv(const prdev_t *device, const ui8 type,
+                            const void *m, const size_t rows, const size_t cols,
+                            const void *x, si32 *y, ui32 timeout);
+
+/**
+ * @brief c = a * b.
+ * @param device Pointer to the Prism device structure.
+ * @param type Element type of a and b, PRISM_OPCODE_TYPE_SI8, _SI16 or _SI32.
+ * @param a The m x k matrix, row-major.
+ * @param b The k x n matrix, row-major.
+ * @param c Receives the m x n result, row-major. Must not alias a or b.
+ * @param m, k, n The dimensions.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_gemm(const prdev_t *device, const ui8 type,
+                            const void *a, const void *b, si32 *c,
+                            const size_t m, const size_t k, const size_t n,
+                            ui32 timeout);
+
+#define prism_gemv_si32(device, m, rows, cols, x, y, timeout)                  \
+  prism_gemv(device, PRISM_OPCODE_TYPE_SI32, (const si32 *)(m), rows, cols,    \
+             (const si32 *)(x), y, timeout)
+#define prism_gemv_si16(device, m, rows, cols, x, y, timeout)                  \
+  prism_gemv(device, PRISM_OPCODE_TYPE_SI16, (const si16 *)(m), rows, cols,    \
+             (const si16 *)(x), y, timeout)
+#define prism_gemv_si8(device, m, rows, cols, x, y, timeout)                   \
+  prism_gemv(device, PRISM_OPCODE_TYPE_SI8, (const si8 *)(m), rows, cols,      \
+             (const si8 *)(x), y, timeout)
+#define prism_gemm_si32(device, a, b, c, m, k, n, timeout)                     \
+  prism_gemm(device, PRISM_OPCODE_TYPE_SI32, (const si32 *)(a),                \
+             (const si32 *)(b), c, m, k, n, timeout)
+#define prism_gemm_si16(device, a, b, c, m, k, n, timeout)                     \
+  prism_gemm(device, PRISM_OPCODE_TYPE_SI16, (const si16 *)(a),                \
+             (const si16 *)(b), c, m, k, n, timeout)
+#define prism_gemm_si8(device, a, b, c, m, k, n, timeout)                      \
+  prism_gemm(device, PRISM_OPCODE_TYPE_SI8, (const si8 *)(a),                  \
+             (const si8 *)(b), c, m, k, n, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_MATRIX__
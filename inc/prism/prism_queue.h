@@ -0,0 +1,135 @@
+/**
+ * @file prism_queue.h
+ * @brief Thread-safe command queue for the Prism library.
+ * Several tasks or threads can share one coprocessor through a prism_queue_t.
+ * Producers submit complete jobs (two operands and an operation), a single
+ * worker thread owns the device and runs them in submission order. The worker
+ * drains all pending jobs at once and packs adjacent jobs with the same
+ * operation and type into one device operation when their lanes fit into 8,
+ * and it downloads every result while the operand of the next job goes up
+ * (_prism_exchange_bank_ptr). Results are returned through a callback or, in
+ * C++, a std::future.
+ * @note Only available where std::thread exists (ESP32 and Linux hosts by
+ * default). Define PRISM_ENABLE_THREADS to 0 or 1 to override.
+ * @note Once a queue is created, every access to its device must go through
+ * the queue.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_QUEUE__
+#define __PRISM_QUEUE__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#ifndef PRISM_ENABLE_THREADS
+#if defined(ESP32) || defined(__linux__)
+#define PRISM_ENABLE_THREADS 1
+#else
+#define PRISM_ENABLE_THREADS 0
+#endif
+#endif // PRISM_ENABLE_THREADS
+
+#if PRISM_ENABLE_THREADS == 1
+
+// Jobs the worker takes from the queue in one batch
+#define PRISM_QUEUE_BATCH_MAX 32
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Result of a queued job.
+ */
+typedef struct prism_job_result {
+  prism_err err; // PR_OK, or the error of the device operation
+  _v256i value;  // The first lanes of the job hold the result
+} prism_job_result_t;
+
+/**
+ * @brief Completion callback of a queued job. Runs on the worker thread and
+ * must not submit to the same queue and wait for the result.
+ */
+typedef void (*prism_job_callback_t)(const prism_job_result_t *result,
+                                     void *user);
+
+/**
+ * @brief Counters of a queue, for tuning batch sizes.
+ */
+typedef struct prism_queue_stats {
+  ui32 jobs;       // Jobs completed
+  ui32 batches;    // Times the worker drained the queue
+  ui32 device_ops; // Device operations run, packed jobs share one
+} prism_queue_stats_t;
+
+typedef struct prism_queue prism_queue_t;
+
+/**
+ * @brief Creates a queue and starts its worker thread.
+ * @param device The device the worker owns from now on.
+ * @param capacity Pending jobs before submitters block, at least 1.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @param queue Receives the new queue.
+ * @return PR_OK on success, PR_ERR_OUT_OF_MEMORY if the queue or its thread
+ * could not be created, or PR_ERR_INVALID_ARGUMENT.
+ */
+extern prism_err prism_queue_create(const prdev_t *device,
+                                    const size_t capacity, ui32 timeout,
+                                    prism_queue_t **queue);
+
+/**
+ * @brief Runs all pending jobs, stops the worker and frees the queue.
+ */
+extern void prism_queue_destroy(prism_queue_t *queue);
+
+/**
+ * @brief Queues C = A op B for the first lanes of a and b.
+ * Blocks while the queue is full. a and b are copied before the call returns.
+ * @param queue The queue.
+ * @param op A binary opcode, PRISM_OPCODE_ADD_N to PRISM_OPCODE_NOR_N or
+ * PRISM_OPCODE_CMP_EQ to PRISM_OPCODE_CMP_LE.
+ * @param type The PRISM_OPCODE_TYPE_* of the lanes.
+ * @param lanes Number of 32-bit lanes, 1 to 8. Jobs with fewer lanes can share
+ * a device operation.
+ * @param a, b The operands.
+ * @param callback Called with the result on the worker thread, may be 0.
+ * @param user Passed to the callback.
+ * @return PR_OK if the job was queued, or an error code if there is an issue.
+ */
+extern prism_err prism_queue_submit(prism_queue_t *queue, const uint16_t op,
+                                    const ui8 type, const ui8 lanes,
+                                    const _v256i *a, const _v256i *b,
+                                    prism_job_callback_t callback, void *user);
+
+/**
+ * @brief Reads the counters of a queue.
+ */
+extern prism_err prism_queue_stats(prism_queue_t *queue,
+                                   prism_queue_stats_t *stats);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#if __cplusplus
+#include <future>
+
+/**
+ * @brief Queues C = A op B and returns a future for the result.
+ * Submission errors are reported through the future as well.
+ */
+extern std::future<prism_job_result_t>
+prism_queue_submit_future(prism_queue_t *queue, const uint16_t op,
+                          const ui8 type, const ui8 lanes, const _v256i *a,
+                          const _v256i *b);
+#endif // __cplusplus
+
+#endif // PRISM_ENABLE_THREADS == 1
+
+#endif // __PRISM_QUEUE__
@@ -0,0 +1,145 @@
+/**
+ * @file prism_reduce.h
+ * @brief Device-resident reductions for the Prism library.
+ * A reduction keeps its running accumulator in bank A of the coprocessor.
+ * Every step streams only the new operand into bank B, runs the operation and
+ * moves bank C back into bank A with _v256_store_ctoa while the device is in
+ * no-clear-after-op mode (_v256_set_ncaop). The accumulator is downloaded once
+ * at the end and folded into a scalar on the host, so N vectors cost N uploads
+ * and a single download instead of N downloads.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_REDUCE__
+#define __PRISM_REDUCE__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Reduction operations.
+ * SUM, AND, OR and XOR take one device operation per step. MIN and MAX are
+ * built from SUB, CMP_GE and MUL and take five to seven operations and two
+ * uploads of the operand per step; they assume the compare opcodes write 1
+ * into a lane that compares true and 0 otherwise.
+ */
+typedef enum prism_reduce_op_enum {
+  PRISM_REDUCE_SUM = 0x00,
+  PRISM_REDUCE_MIN = 0x01,
+  PRISM_REDUCE_MAX = 0x02,
+  PRISM_REDUCE_AND = 0x03,
+  PRISM_REDUCE_OR = 0x04,
+  PRISM_REDUCE_XOR = 0x05
+} prism_reduce_op_t;
+
+/**
+ * @brief State of a running device-resident reduction.
+ */
+typedef struct prism_reduce {
+  const prdev_t *device;
+  prism_reduce_op_t op;
+  ui8 type;      // PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32
+  ui32 count;    // Number of vectors folded into the accumulator
+  ui32 timeout;  // Timeout in milliseconds for every device command
+} prism_reduce_t;
+
+/**
+ * @brief Starts a reduction with the first vector as accumulator.
+ * Switches the device to no-clear-after-op mode and uploads the first vector
+ * into bank A.
+ * @param ctx The reduction state to initialize.
+ * @param device Pointer to the Prism device structure.
+ * @param op The reduction operation.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param first The first 8 lanes.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_reduce_begin(prism_reduce_t *ctx, const prdev_t *device,
+                                    const prism_reduce_op_t op, const ui8 type,
+                                    const ui32 *first, ui32 timeout);
+
+/**
+ * @brief Folds the next 8 lanes into the device accumulator.
+ * @param ctx The running reduction.
+ * @param next The next 8 lanes, read straight from caller memory.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_reduce_push(prism_reduce_t *ctx, const ui32 *next);
+
+/**
+ * @brief Downloads the accumulator and restores clear-after-op mode.
+ * @param ctx The running reduction.
+ * @param acc Receives the 8 accumulated lanes.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_reduce_end(prism_reduce_t *ctx, _v256i *acc);
+
+/**
+ * @brief Folds the first lanes of a vector into a scalar on the host.
+ * @param v The vector to fold.
+ * @param op The reduction operation.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param lanes Number of lanes to fold, 1 to 8.
+ * @return The folded value. Signed results are returned as their bit pattern.
+ */
+extern ui32 _v256_fold_ui32(const _v256i *v, const prism_reduce_op_t op,
+                            const ui8 type, const ui8 lanes);
+
+/**
+ * @brief Reduces an array of n lanes into a scalar.
+ * Full 8-lane blocks are reduced on the device with a single download, the
+ * ragged tail is folded in on the host.
+ * @param device Pointer to the Prism device structure.
+ * @param op The reduction operation.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param data The input lanes.
+ * @param n Number of lanes, at least 1.
+ * @param result Receives the reduced value.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_reduce_ui32(const prdev_t *device,
+                                   const prism_reduce_op_t op, const ui8 type,
+                                   const ui32 *data, const size_t n,
+                                   ui32 *result, ui32 timeout);
+
+#define prism_reduce_sum_ui32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_SUM, PRISM_OPCODE_TYPE_UI32, data, n, \
+                    result, timeout)
+#define prism_reduce_min_ui32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_MIN, PRISM_OPCODE_TYPE_UI32, data, n, \
+                    result, timeout)
+#define prism_reduce_max_ui32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_MAX, PRISM_OPCODE_TYPE_UI32, data, n, \
+                    result, timeout)
+#define prism_reduce_min_si32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_MIN, PRISM_OPCODE_TYPE_SI32,          \
+                    (const ui32 *)(data), n, (ui32 *)(result), timeout)
+#define prism_reduce_max_si32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_MAX, PRISM_OPCODE_TYPE_SI32,          \
+                    (const ui32 *)(data), n, (ui32 *)(result), timeout)
+#define prism_reduce_and_ui32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_AND, PRISM_OPCODE_TYPE_UI32, data, n, \
+                    result, timeout)
+#define prism_reduce_or_ui32(device, data, n, result, timeout)                 \
+  prism_reduce_ui32(device, PRISM_REDUCE_OR, PRISM_OPCODE_TYPE_UI32, data, n,  \
+                    result, timeout)
+#define prism_reduce_xor_ui32(device, data, n, result, timeout)                \
+  prism_reduce_ui32(device, PRISM_REDUCE_XOR, PRISM_OPCODE_TYPE_UI32, data, n, \
+                    result, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_REDUCE__
@@ -0,0 +1,188 @@
+/**
+ * @file prism_ring.h
+ * @brief Sample ring buffer and streaming pipeline for the Prism library.
+ * An interrupt handler pushes samples into a prism_ring_t while the main loop
+ * runs a prism_pipeline_t on the other end. The pipeline cuts the samples into
+ * windows of one full vector (8, 16 or 32 lanes), sends every window to a bank
+ * and hands it to a processing callback that runs the device operations.
+ *   ISR:  prism_ring_push(&ring, analogRead(A0));
+ *   loop: prism_pipeline_pump(&pipeline);
+ * The pipeline starts to flush when the ring fills up to its high watermark
+ * and keeps going until the fill level is down to the low watermark, so the
+ * coprocessor gets bursts of windows instead of one frame per sample.
+ * @note The ring has one producer and one consumer. Neither side takes a lock:
+ * each index is written by one side only and published with release/acquire
+ * ordering, which is safe between an interrupt and the main loop and between
+ * two cores. This is lock-free where 16-bit atomics are native, e.g. ARM
+ * Cortex-M, ESP32 and hosts. On 8-bit AVR an index access is two byte
+ * accesses, so it runs with interrupts disabled for a few cycles instead.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_RING__
+#define __PRISM_RING__ 1
+
+#include "prism/prism.h"
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Largest capacity of a ring in samples
+#define PRISM_RING_MAX (32768U)
+
+/**
+ * @brief What a push into a full ring does.
+ */
+typedef enum prism_ring_policy_enum {
+  PRISM_RING_DROP = 0x00, // The new sample is dropped and counted
+  PRISM_RING_BLOCK = 0x01 // The producer waits until the consumer made room
+} prism_ring_policy_t;
+
+/**
+ * @brief A single-producer single-consumer ring of samples in caller memory.
+ * @note PRISM_RING_BLOCK must not be used by an interrupt handler on a
+ * single-core board: the consumer never gets to run while the handler waits.
+ */
+typedef struct prism_ring {
+  uint8_t *buf;      // size samples of width bytes
+  uint16_t size;     // Capacity in samples, a power of two
+  uint8_t width;     // Bytes per sample, 1, 2 or 4
+  uint8_t type;      // PRISM_OPCODE_TYPE_* of the samples
+  uint8_t policy;    // prism_ring_policy_t
+  uint16_t head;     // Next slot to write, written by the producer only
+  uint16_t tail;     // Next slot to read, written by the consumer only
+  uint16_t peak;     // Highest fill level, producer only
+  uint32_t pushed;   // Samples accepted, producer only
+  uint32_t overruns; // Samples dropped by a full ring, producer only
+  uint32_t waits;    // Pushes that waited for room, producer only
+} prism_ring_t;
+
+/**
+ * @brief Fill level and counters of a ring.
+ */
+typedef struct prism_ring_stats {
+  uint16_t fill;     // Samples waiting
+  uint16_t peak;     // Highest fill level so far
+  uint32_t pushed;   // Samples accepted
+  uint32_t overruns; // Samples dropped because the ring was full
+  uint32_t waits;    // Pushes that had to wait for room (PRISM_RING_BLOCK)
+} prism_ring_stats_t;
+
+/**
+ * @brief Sets up an empty ring.
+ * @param ring The ring.
+ * @param buf Room for size samples of the given type.
+ * @param size Capacity in samples, a power of two up to PRISM_RING_MAX.
+ * @param type PRISM_OPCODE_TYPE_UI32, SI32, UI16, SI16, UI8 or SI8.
+ * @param policy What a push into a full ring does.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT for a bad size or type.
+ */
+extern prism_err prism_ring_init(prism_ring_t *ring, void *buf,
+                                 const uint16_t size, const ui8 type,
+                                 const prism_ring_policy_t policy);
+
+/**
+ * @brief Appends one sample. Producer side, safe in an interrupt handler.
+ * @param ring The ring.
+ * @param sample The sample, truncated to the sample width.
+ * @return PR_OK, or PR_ERR_OUT_OF_MEMORY if the ring was full and the sample
+ * was dropped.
+ */
+extern prism_err prism_ring_push(prism_ring_t *ring, const ui32 sample);
+
+/**
+ * @brief Number of samples waiting. Consumer side.
+ */
+extern uint16_t prism_ring_count(const prism_ring_t *ring);
+
+/**
+ * @brief Takes up to n samples out of the ring. Consumer side.
+ * @param ring The ring.
+ * @param out Receives the samples, width bytes each.
+ * @param n Largest number of samples to take.
+ * @return Number of samples taken.
+ */
+extern uint16_t prism_ring_read(prism_ring_t *ring, void *out,
+                                const uint16_t n);
+
+/**
+ * @brief Reads the fill level and the counters. Consumer side.
+ */
+extern void prism_ring_stats(const prism_ring_t *ring,
+                             prism_ring_stats_t *stats);
+
+/**
+ * @brief Processes one window. The window is already in the bank of the
+ * pipeline; the callback runs the device operations on it and may read the
+ * results. Returning an error stops the pump.
+ * @param device The device of the pipeline.
+ * @param window The samples of the window, a full vector.
+ * @param user The user pointer of the pipeline.
+ */
+typedef prism_err (*prism_pipeline_fn)(const prdev_t *device,
+                                       const _v256i *window, void *user);
+
+/**
+ * @brief Moves full windows from a ring to the coprocessor.
+ */
+typedef struct prism_pipeline {
+  prism_ring_t *ring;
+  const prdev_t *device;
+  bank_t bank;               // Bank every window is sent to
+  uint16_t lanes;            // Samples per window
+  uint16_t high;             // Fill level that starts a flush
+  uint16_t low;              // Fill level that ends a flush
+  uint8_t flushing;          // Between the high and the low watermark
+  prism_pipeline_fn process; // Runs the device operations of a window
+  void *user;
+  uint32_t windows; // Windows processed
+  ui32 timeout;
+} prism_pipeline_t;
+
+/**
+ * @brief Sets up a pipeline behind a ring.
+ * @param pipeline The pipeline.
+ * @param ring The ring it drains.
+ * @param device Pointer to the Prism device structure.
+ * @param bank PRISM_BANK_A or PRISM_BANK_B, where every window goes.
+ * @param high Fill level in samples that starts a flush, at least one window
+ * and at most the capacity of the ring.
+ * @param low Fill level in samples down to which a flush runs, below high.
+ * @param process Runs the device operations of a window.
+ * @param user Passed to process.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT for bad watermarks.
+ */
+extern prism_err prism_pipeline_init(prism_pipeline_t *pipeline,
+                                     prism_ring_t *ring, const prdev_t *device,
+                                     const bank_t bank, const uint16_t high,
+                                     const uint16_t low,
+                                     prism_pipeline_fn process, void *user,
+                                     ui32 timeout);
+
+/**
+ * @brief Processes windows as the watermarks ask for. Call it from the loop.
+ * Returns after at most one ring capacity of windows, so a producer that is
+ * faster than the device cannot keep the caller inside.
+ * @param pipeline The pipeline.
+ * @return PR_OK, or the error of the transfer or of the callback.
+ */
+extern prism_err prism_pipeline_pump(prism_pipeline_t *pipeline);
+
+/**
+ * @brief Processes every full window now, regardless of the watermarks.
+ * Samples that do not fill a window stay in the ring.
+ * @see prism_pipeline_pump for the parameters.
+ */
+extern prism_err prism_pipeline_flush(prism_pipeline_t *pipeline);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_RING__
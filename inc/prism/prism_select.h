@@ -0,0 +1,129 @@
+/**
+ * @file prism_select.h
+ * @brief Predicated select, min/max and clamp for the Prism library.
+ * The compare opcodes write 1 into every lane that compares true and 0 into
+ * every other lane of bank C. The functions in this file consume those masks
+ * on the device: the mask is widened to all-ones with PRISM_OPCODE_CPL2 and
+ * combined with AND/XOR, or used as a 0/1 factor with MUL. Intermediate
+ * results move between banks with _v256_store_ctoa and _v256_store_ctob, so
+ * nothing is downloaded to the host until the caller loads bank C.
+ * @note Unary opcodes (PRISM_OPCODE_CPL2) read bank A and write bank C.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_SELECT__
+#define __PRISM_SELECT__ 1
+
+#include "prism/prism.h"
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Blends two vectors with the compare mask in bank C.
+ * Bank C = mask ? a : b, per lane. The mask must be the 0/1 result of a
+ * preceding compare opcode. The host forms a ^ b while staging the first
+ * upload, so the select costs the same two uploads as storing a and b:
+ *   C = b ^ ((a ^ b) & -mask)
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param a The lanes taken where the mask is set.
+ * @param b The lanes taken where the mask is clear.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err _v256_select_v(const prdev_t *device, const ui8 type,
+                                const _v256i *a, const _v256i *b,
+                                ui32 timeout);
+
+/**
+ * @brief Blends two vectors with a 0/1 mask supplied by the host.
+ * The mask is uploaded into bank A and moved to bank C with OR 0 before
+ * _v256_select_v runs.
+ */
+extern prism_err _v256_blend_v(const prdev_t *device, const ui8 type,
+                               const _v256i *mask, const _v256i *a,
+                               const _v256i *b, ui32 timeout);
+
+/**
+ * @brief Lane-wise minimum or maximum of two vectors, result in bank C.
+ * Built from SUB, CMP_GE and MUL with three uploads and no download:
+ *   d = a - b, ge = (a >= d), max = b + ge * d, min = b - (ge * d - d)
+ * Signed lanes are compared with the sign bit flipped.
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param is_max true for the maximum, false for the minimum.
+ * @param a, b The two operands.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err _v256_minmax_v(const prdev_t *device, const ui8 type,
+                                const bool is_max, const _v256i *a,
+                                const _v256i *b, ui32 timeout);
+
+/**
+ * @brief Clamps the vector in bank A to [lo, hi], result in bank C.
+ * Runs entirely on the device with scalar-immediate opcodes, so a clamp of a
+ * resident vector costs no upload at all.
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI32 or PRISM_OPCODE_TYPE_SI32.
+ * @param lo, hi The bounds, signed values passed as their bit pattern.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err _v256_clamp_bank_a(const prdev_t *device, const ui8 type,
+                                    const ui32 lo, const ui32 hi,
+                                    ui32 timeout);
+
+/**
+ * @brief Uploads a vector into bank A and clamps it to [lo, hi].
+ */
+extern prism_err _v256_clamp_v(const prdev_t *device, const ui8 type,
+                               const _v256i *x, const ui32 lo, const ui32 hi,
+                               ui32 timeout);
+
+/**
+ * @brief A = min/max(A, b) for unsigned lanes, also left in bank C.
+ * Expects the device in no-clear-after-op mode. Shared by _v256_minmax_v and
+ * the MIN/MAX reductions.
+ * @note This function is an internal function and should not be used directly
+ * by users of the Prism library.
+ */
+extern prism_err _prism_minmax_bank_a(const prdev_t *device, const bool is_max,
+                                      const ui32 *b, ui32 timeout);
+
+#define _v256_select_ui32(device, a, b, timeout)                               \
+  _v256_select_v(device, PRISM_OPCODE_TYPE_UI32, a, b, timeout)
+#define _v256_select_si32(device, a, b, timeout)                               \
+  _v256_select_v(device, PRISM_OPCODE_TYPE_SI32, a, b, timeout)
+
+#define _v256_blend_ui32(device, mask, a, b, timeout)                          \
+  _v256_blend_v(device, PRISM_OPCODE_TYPE_UI32, mask, a, b, timeout)
+#define _v256_blend_si32(device, mask, a, b, timeout)                          \
+  _v256_blend_v(device, PRISM_OPCODE_TYPE_SI32, mask, a, b, timeout)
+
+#define _v256_min8_ui32(device, a, b, timeout)                                 \
+  _v256_minmax_v(device, PRISM_OPCODE_TYPE_UI32, false, a, b, timeout)
+#define _v256_max8_ui32(device, a, b, timeout)                                 \
+  _v256_minmax_v(device, PRISM_OPCODE_TYPE_UI32, true, a, b, timeout)
+#define _v256_min8_si32(device, a, b, timeout)                                 \
+  _v256_minmax_v(device, PRISM_OPCODE_TYPE_SI32, false, a, b, timeout)
+#define _v256_max8_si32(device, a, b, timeout)                                 \
+  _v256_minmax_v(device, PRISM_OPCODE_TYPE_SI32, true, a, b, timeout)
+
+#define _v256_clamp8_ui32(device, x, lo, hi, timeout)                          \
+  _v256_clamp_v(device, PRISM_OPCODE_TYPE_UI32, x, lo, hi, timeout)
+#define _v256_clamp8_si32(device, x, lo, hi, timeout)                          \
+  _v256_clamp_v(device, PRISM_OPCODE_TYPE_SI32, x, (ui32)(lo), (ui32)(hi),     \
+                timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_SELECT__
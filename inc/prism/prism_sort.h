@@ -0,0 +1,156 @@
+/**
+ * @file prism_sort.h
+ * @brief Sorting networks, array sort and streaming top-k for the Prism
+ * library.
+ * Every compare-exchange of a network stage runs on the coprocessor, one
+ * comparator per lane: bank A holds the lower and bank B the upper elements
+ * of up to 32, 16 or 8 comparators (8-, 16- or 32-bit elements). The device
+ * computes the swap amount t = (a >= b) * (a - b) with SUB, CMP_GE and MUL,
+ * and the host applies lo -= t, hi += t while staging the next stage. The
+ * device has no lane shuffle, so the permutation between stages is done on
+ * the host. Comparators of independent arrays share the banks, which is what
+ * makes batches of short windows (median and percentile filters) cheap.
+ * The networks are bitonic with every comparator ascending, so any size
+ * works without padding.
+ * @note Signed elements are compared with the sign bit flipped.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_SORT__
+#define __PRISM_SORT__ 1
+
+#include "prism/prism.h"
+
+#include <stddef.h>
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * @brief Sorts the lanes of a vector in ascending order: 8 lanes of 32 bits,
+ * 16 lanes of 16 bits or 32 lanes of 8 bits.
+ * @param device Pointer to the Prism device structure.
+ * @param type PRISM_OPCODE_TYPE_UI32, _SI32, _UI16, _SI16, _UI8 or _SI8.
+ * @param v The vector, sorted in place.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err _v256_sort_v(const prdev_t *device, const ui8 type,
+                              _v256i *v, ui32 timeout);
+
+/**
+ * @brief Sorts count independent arrays of n elements each, stored one after
+ * the other. The comparators of all arrays go through the device together.
+ * @param device Pointer to the Prism device structure.
+ * @param type Element type, see _v256_sort_v.
+ * @param data count * n elements of the given type.
+ * @param count Number of arrays.
+ * @param n Elements per array.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_sort_batch(const prdev_t *device, const ui8 type,
+                                  void *data, const size_t count,
+                                  const size_t n, ui32 timeout);
+
+/**
+ * @brief Sorts an array in ascending order. Runs of one vector are sorted by
+ * the device networks, the runs are merged on the host.
+ * @param device Pointer to the Prism device structure.
+ * @param type Element type, see _v256_sort_v.
+ * @param data n elements of the given type, sorted in place.
+ * @param n Number of elements.
+ * @param scratch Room for n elements for the merge passes. May be NULL if n
+ * fits one vector.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_sort(const prdev_t *device, const ui8 type, void *data,
+                            const size_t n, void *scratch, ui32 timeout);
+
+/**
+ * @brief Running set of the k largest elements of a stream.
+ * The set is kept sorted in one vector. Candidates that cannot enter it are
+ * dropped on the host; the others are collected until a vector is full, then
+ * sorted and merged into the set by the device networks.
+ */
+typedef struct prism_topk {
+  const prdev_t *device;
+  ui8 type;
+  ui8 k;       // Size of the set, up to one vector
+  ui8 pending; // Candidates collected in block
+  size_t seen; // Elements pushed since the last reset
+  ui32 timeout;
+  _v256i best;  // The largest elements in ascending order
+  _v256i block; // Candidates not merged yet
+} prism_topk_t;
+
+/**
+ * @brief Starts an empty top-k set.
+ * @param ctx The context.
+ * @param device Pointer to the Prism device structure.
+ * @param type Element type, see _v256_sort_v.
+ * @param k Size of the set, 1 up to the lanes of one vector.
+ * @param timeout The timeout value in milliseconds per device command.
+ * @return PR_OK on success, PR_ERR_INVALID_ARGUMENT for a bad type or k.
+ */
+extern prism_err prism_topk_init(prism_topk_t *ctx, const prdev_t *device,
+                                 const ui8 type, const ui8 k, ui32 timeout);
+
+/**
+ * @brief Empties the set.
+ */
+extern void prism_topk_reset(prism_topk_t *ctx);
+
+/**
+ * @brief Offers n elements of the stream to the set.
+ * @param ctx The context.
+ * @param x n elements of the context type.
+ * @param n Number of elements.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_topk_push(prism_topk_t *ctx, const void *x,
+                                 const size_t n);
+
+/**
+ * @brief Copies the set out, largest element first.
+ * @param ctx The context.
+ * @param out Room for k elements of the context type.
+ * @param count Receives the number of elements written, k or fewer if the
+ * stream was shorter.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_topk_read(prism_topk_t *ctx, void *out, ui8 *count);
+
+#define _v256_sort8_ui32(device, v, timeout)                                   \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_UI32, v, timeout)
+#define _v256_sort8_si32(device, v, timeout)                                   \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_SI32, v, timeout)
+#define _v256_sort16_ui16(device, v, timeout)                                  \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_UI16, v, timeout)
+#define _v256_sort16_si16(device, v, timeout)                                  \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_SI16, v, timeout)
+#define _v256_sort32_ui8(device, v, timeout)                                   \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_UI8, v, timeout)
+#define _v256_sort32_si8(device, v, timeout)                                   \
+  _v256_sort_v(device, PRISM_OPCODE_TYPE_SI8, v, timeout)
+
+#define prism_sort_si32(device, data, n, scratch, timeout)                     \
+  prism_sort(device, PRISM_OPCODE_TYPE_SI32, data, n, scratch, timeout)
+#define prism_sort_ui32(device, data, n, scratch, timeout)                     \
+  prism_sort(device, PRISM_OPCODE_TYPE_UI32, data, n, scratch, timeout)
+#define prism_sort_si16(device, data, n, scratch, timeout)                     \
+  prism_sort(device, PRISM_OPCODE_TYPE_SI16, data, n, scratch, timeout)
+#define prism_sort_ui16(device, data, n, scratch, timeout)                     \
+  prism_sort(device, PRISM_OPCODE_TYPE_UI16, data, n, scratch, timeout)
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_SORT__
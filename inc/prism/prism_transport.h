@@ -0,0 +1,91 @@
+/**
+ * @file prism_transport.h
+ * @brief Transport backends of the Prism library.
+ * Every prdev_t talks to its coprocessor through a prism_transport_t. The
+ * default backend sends command frames over I²C and bank data over the 8-bit
+ * parallel P²Link bus, the SPI backend carries both over hardware SPI and
+ * exchanges bank data full-duplex, and the I²C backend needs only SDA and SCL.
+ * The loopback backend emulates a coprocessor in host memory; it needs no
+ * hardware and is used to measure the overhead of the library itself and to
+ * run code on boards without a PRISM device.
+ * @author Amber-Sophia Schröck
+ * @version 1.0.1
+ * @date 2025-06-14
+ * @licence MPL-2.0
+ */
+#pragma once
+
+#ifndef __PRISM_TRANSPORT__
+#define __PRISM_TRANSPORT__ 1
+
+#include "prism/prism.h"
+
+#if __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+// Status byte of a successfully processed command frame
+#define PRISM_STATUS_OK (0x01)
+// Status byte of a frame the device could not process
+#define PRISM_STATUS_FAIL (0x00)
+// Status byte while the device is still processing a frame
+#define PRISM_STATUS_BUSY (0xFF)
+// Status byte of the END frame after bank data that failed its CRC
+#define PRISM_STATUS_CRC (0x02)
+
+/**
+ * @brief I²C command frames and P²Link bank data. Used by
+ * prism_device_create.
+ */
+extern const prism_transport_t prism_transport_p2link;
+
+/**
+ * @brief Command frames and bank data over hardware SPI. Bank data is
+ * exchanged full-duplex. Used by prism_device_create for PRISM_MODE_SPI.
+ */
+extern const prism_transport_t prism_transport_spi;
+
+/**
+ * @brief Command frames and bank data over I²C only, no P²Link wiring. Bank
+ * data is split into chunks that fit the Wire buffer and the status byte is
+ * polled. Used by prism_device_create for PRISM_MODE_I2C.
+ */
+extern const prism_transport_t prism_transport_i2c;
+
+/**
+ * @brief In-memory coprocessor emulation.
+ */
+extern const prism_transport_t prism_transport_loopback;
+
+/**
+ * @brief State of an emulated coprocessor for prism_transport_loopback.
+ * Pass a zero-initialized instance as ctx to prism_device_create_with.
+ */
+typedef struct prism_loopback {
+  _v256i bank[PRISM_BANK_MAX]; // Banks A, B, C, D
+  uint8_t clear_after_op;      // Clear A and B after an operation
+  uint8_t status;              // Status of the last frame
+  uint8_t xfer_bank;           // Bank of the running STORE or LOAD
+  uint8_t xfer_pos;            // Byte position in the running transfer
+  uint8_t xfer_store;          // The running transfer is a STORE
+  uint8_t rx[sizeof(_v256i) + 2]; // STORE data and CRC, banked at END
+  uint8_t link_crc;               // Bank data carries a CRC-16
+  uint8_t corrupt;                // Blocks to damage with a bit flip
+  uint32_t frames;             // Command frames processed
+  uint32_t bytes;              // Bank data bytes transferred
+} prism_loopback_t;
+
+/**
+ * @brief Creates a Prism device backed by an in-memory emulation.
+ * @param state The emulation state, zero-initialized by this call.
+ * @param device The device to initialize.
+ * @return PR_OK on success, or an error code if there is an issue.
+ */
+extern prism_err prism_device_create_loopback(prism_loopback_t *state,
+                                              prdev_t *device);
+
+#if __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PRISM_TRANSPORT__
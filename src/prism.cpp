@@ -1,9 +1,14 @@
 #include "prism/prism.h"
+#include "prism/prism_async.h"
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
 
 // #include "prism/prism_arch.h"
 
 #include "Arduino.h"
 #include <Wire.h>
+#include <string.h>
 
 typedef struct prism_send_data {
   uint16_t op;
@@ -27,200 +32,1007 @@ prism_err _prism_arch_send_opcode(const prdev_t *dev, const uint16_t op,
   return _prism_arch_send_opcode_arg1(dev, op, type, 255,
                                       timeout); // Assume success for now
 }
+typedef struct prism_send_data_imm {
+  uint16_t op;
+  ui8 arg;
+  ui8 type;
+  timeout_t timeout;
+  ui32 imm;
+} prism_send_data_imm_t;
+
+// PRISM_LANE_* bit of a lane type, 0 for types the library does not know
+static uint16_t __prism_lane_bit(const ui8 type) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_UI32:
+    return PRISM_LANE_UI32;
+  case PRISM_OPCODE_TYPE_SI32:
+    return PRISM_LANE_SI32;
+  case PRISM_OPCODE_TYPE_UI16:
+    return PRISM_LANE_UI16;
+  case PRISM_OPCODE_TYPE_SI16:
+    return PRISM_LANE_SI16;
+  case PRISM_OPCODE_TYPE_UI8:
+    return PRISM_LANE_UI8;
+  case PRISM_OPCODE_TYPE_SI8:
+    return PRISM_LANE_SI8;
+  case PRISM_OPCODE_TYPE_UI4:
+    return PRISM_LANE_UI4;
+  case PRISM_OPCODE_TYPE_SI4:
+    return PRISM_LANE_SI4;
+#if PRISM_ENABLE_64BIT_EXT == 1
+  case PRISM_OPCODE_TYPE_UI64:
+    return PRISM_LANE_UI64;
+#if PRISM_ENABLE_LONGTYPES == 1
+  case PRISM_OPCODE_TYPE_UI128:
+    return PRISM_LANE_UI128;
+  case PRISM_OPCODE_TYPE_UI256:
+    return PRISM_LANE_UI256;
+#endif
+#endif
+#ifdef PRISM_ENABLE_IEE754
+  case PRISM_OPCODE_TYPE_FL:
+    return PRISM_LANE_FL;
+  case PRISM_OPCODE_TYPE_HF:
+    return PRISM_LANE_HF;
+#endif
+  default:
+    return 0;
+  }
+}
+
+static inline bool __prism_op_is_scalar(const uint16_t op) {
+  return (op >= PRISM_OPCODE_ADD_S && op <= PRISM_OPCODE_NOR_S) ||
+         (op >= PRISM_OPCODE_CMP_EQ_S && op <= PRISM_OPCODE_CMP_LE_S);
+}
+
+// Opcodes that compute lanes and therefore depend on the lane type
+static inline bool __prism_op_is_lane(const uint16_t op) {
+  return (op >= PRISM_OPCODE_ADD_N && op <= PRISM_OPCODE_NOT_N) ||
+         (op >= PRISM_OPCODE_CMP_EQ && op <= PRISM_OPCODE_SHIFT_R) ||
+         __prism_op_is_scalar(op);
+}
+
+// PRISM_FEATURE_* bits an opcode needs, 0 for the base protocol
+static uint32_t __prism_op_features(const uint16_t op) {
+  uint32_t needs = 0;
+  if (__prism_op_is_scalar(op)) {
+    needs |= PRISM_FEATURE_SCALAR;
+  }
+  if ((op >= PRISM_OPCODE_CMP_EQ && op <= PRISM_OPCODE_CPL2) ||
+      (op >= PRISM_OPCODE_CMP_EQ_S && op <= PRISM_OPCODE_CMP_LE_S)) {
+    needs |= PRISM_FEATURE_COMPARE;
+  }
+  switch (op) {
+  case PRISM_OPCODE_SHIFT_L:
+  case PRISM_OPCODE_SHIFT_R:
+    needs |= PRISM_FEATURE_SHIFT;
+    break;
+  case PRISM_OPCODE_SPLAT_A:
+  case PRISM_OPCODE_SPLAT_B:
+    needs |= PRISM_FEATURE_SPLAT;
+    break;
+  case PRISM_OPCODE_NOCLEAR_AFTEROP:
+    needs |= PRISM_FEATURE_NOCLEAR;
+    break;
+  case PRISM_OPCODE_EXCHANGE:
+    needs |= PRISM_FEATURE_EXCHANGE;
+    break;
+  case PRISM_OPCODE_ARCH_LINK_CRC:
+    needs |= PRISM_FEATURE_CRC;
+    break;
+  case PRISM_OPCODE_ARCH_PEEK:
+    needs |= PRISM_FEATURE_PEEK;
+    break;
+  default:
+    break;
+  }
+  return needs;
+}
+
+bool prism_device_supports(const prdev_t *dev, const uint16_t op,
+                           const ui8 type) {
+  if (dev == 0) {
+    return false;
+  }
+  if (__prism_op_is_lane(op) &&
+      (dev->lane_types & __prism_lane_bit(type)) == 0) {
+    return false;
+  }
+  const uint32_t needs = __prism_op_features(op);
+  return (dev->features & needs) == needs;
+}
+
+// The bookkeeping of a device changes under a const device, like the state of
+// the device itself. Devices are never defined const.
+static prdev_t *__prism_state(const prdev_t *dev) { return (prdev_t *)dev; }
+
+// Banks an opcode writes, one bit per bank_t
+static uint8_t __prism_bank_writes(const prdev_t *dev, const uint16_t op,
+                                   const ui8 arg) {
+  switch (op) {
+  case PRISM_OPCODE_ARCH_INIT:
+  case PRISM_OPCODE_ARCH_RESET:
+  case PRISM_OPCODE_CLEAR_ALL:
+    return 0x0F;
+  case PRISM_OPCODE_STORE_A:
+  case PRISM_OPCODE_SPLAT_A:
+  case PRISM_OPCODE_CTOA:
+    return 1 << PRISM_BANK_A;
+  case PRISM_OPCODE_STORE_B:
+  case PRISM_OPCODE_SPLAT_B:
+  case PRISM_OPCODE_CTOB:
+    return 1 << PRISM_BANK_B;
+  case PRISM_OPCODE_EXCHANGE:
+    return 1 << (arg & 0x03); // Low nibble: bank shifted in
+  case PRISM_OPCODE_NOTC:
+  case PRISM_OPCODE_CLEAR_C:
+    return 1 << PRISM_BANK_C;
+  case PRISM_OPCODE_CLEAR_D:
+    return 1 << PRISM_BANK_D;
+  default:
+    break;
+  }
+  if (!__prism_op_is_lane(op)) {
+    return 0;
+  }
+  return (1 << PRISM_BANK_C) |
+         (dev->clears_ab ? (1 << PRISM_BANK_A) | (1 << PRISM_BANK_B) : 0);
+}
+
+// Called for every frame that goes out. Moves the epoch of every bank the
+// opcode writes, which cancels lazy loads of them, and follows the
+// clear-after-op mode of the device.
+static void __prism_frame_sent(const prdev_t *dev, const uint16_t op,
+                               const ui8 arg) {
+  prdev_t *state = __prism_state(dev);
+  const uint8_t banks = __prism_bank_writes(dev, op, arg);
+  for (uint8_t bank = 0; bank < PRISM_BANK_MAX; bank++) {
+    if (banks & (1 << bank)) {
+      state->bank_epoch[bank]++;
+    }
+  }
+
+  if (op == PRISM_OPCODE_NOCLEAR_AFTEROP) {
+    state->clears_ab = 0;
+  } else if (op == PRISM_OPCODE_CLEAR_AFTEROP ||
+             op == PRISM_OPCODE_ARCH_INIT || op == PRISM_OPCODE_ARCH_RESET) {
+    state->clears_ab = 1;
+  }
+}
+
+// prism_err of a status byte
+static prism_err __prism_status_err(const uint8_t status) {
+  if (status == PRISM_STATUS_OK) {
+    return PR_OK;
+  }
+  if (status == PRISM_STATUS_CRC) {
+    return PR_ERR_LINK; // Bank data arrived damaged
+  }
+  return PR_ERR_UNKNOWN; // Device did not respond as expected
+}
+
+static prism_err __prism_arch_transmit(const prdev_t *dev, const uint8_t *frame,
+                                       const size_t len) {
+  if (dev->transport == 0) {
+    return PR_ERR_INVALID_ARGUMENT; // Device was never created
+  }
+
+  prism_err err = dev->transport->send_command(dev, frame, len);
+  if (err != PR_OK) {
+    return err; // Transmission error
+  }
+
+  uint8_t response = 0;
+  err = dev->transport->read_status(dev, &response);
+  if (err != PR_OK) {
+    return err; // Device not responding
+  }
+  return __prism_status_err(response);
+}
+
 prism_err _prism_arch_send_opcode_arg1(const prdev_t *dev, const uint16_t op,
                                        const ui8 type, const ui8 arg,
                                        timeout_t timeout) {
   if (dev == 0) {
     return PR_ERR_INVALID_ARGUMENT;
   }
+  if (!prism_device_supports(dev, op, type)) {
+    return PR_ERR_UNSUPPORTED_OPERATION;
+  }
 
   prism_send_data data = {
       .op = op, .arg = arg, .type = type, .timeout = timeout};
 
-  Wire.beginTransmission(dev->address); // Start Übertragung zum PCF8574
-  Wire.write((const uint8_t *)&data,
-             sizeof(prism_send_data_t)); // Wert schreiben
-  uint8_t err = Wire.endTransmission();  // End transmission
+  __prism_frame_sent(dev, op, arg);
+  return __prism_arch_transmit(dev, (const uint8_t *)&data,
+                               sizeof(prism_send_data_t));
+}
+
+// The immediate repeated over a 32-bit unit, low bits per lane like SPLAT
+static ui32 __prism_replicate(const ui8 type, const ui32 imm) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_UI16:
+  case PRISM_OPCODE_TYPE_SI16:
+#ifdef PRISM_ENABLE_IEE754
+  case PRISM_OPCODE_TYPE_HF:
+#endif
+    return (imm & 0xFFFFUL) * 0x00010001UL;
+  case PRISM_OPCODE_TYPE_UI8:
+  case PRISM_OPCODE_TYPE_SI8:
+    return (imm & 0xFFUL) * 0x01010101UL;
+  case PRISM_OPCODE_TYPE_UI4:
+  case PRISM_OPCODE_TYPE_SI4:
+    return (imm & 0xFUL) * 0x11111111UL;
+  default:
+    return imm;
+  }
+}
 
-  if (err != 0) {
-    return PR_ERR_UNKNOWN; // Transmission error
+// Sends the immediate as a bank upload for devices that do not take it in the
+// frame. Scalar operations then run their bank form on bank B. In no-clear
+// mode B may hold live data, e.g. an accumulator, so it is saved on the host
+// and written back afterwards.
+static prism_err __prism_arch_emulate_imm(const prdev_t *dev,
+                                          const uint16_t op, const ui8 type,
+                                          const ui8 arg, const ui32 imm,
+                                          timeout_t timeout) {
+  const bool splat = (op == PRISM_OPCODE_SPLAT_A || op == PRISM_OPCODE_SPLAT_B);
+  uint16_t base = op;
+  if (!splat) {
+    if (!__prism_op_is_scalar(op)) {
+      return PR_ERR_UNSUPPORTED_OPERATION;
+    }
+    base = (op >= PRISM_OPCODE_CMP_EQ_S)
+               ? op - (PRISM_OPCODE_CMP_EQ_S - PRISM_OPCODE_CMP_EQ)
+               : op - (PRISM_OPCODE_ADD_S - PRISM_OPCODE_ADD_N);
+    if (!prism_device_supports(dev, base, type)) {
+      return PR_ERR_UNSUPPORTED_OPERATION;
+    }
   }
 
-  delay(50); // Wait for the dev to process the command
+  const bool keep_b = !splat && !dev->clears_ab;
+  ui32 saved_b[8];
+  if (keep_b) {
+    PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_B, saved_b, timeout));
+  }
 
-  Wire.requestFrom(dev->address,
-                   sizeof(uint8_t)); // Request 1 byte from the dev
-  if (Wire.available() == 0) {
-    return PR_ERR_UNKNOWN; // Device not responding
+  ui32 vec[8];
+  const ui32 unit = __prism_replicate(type, imm);
+  for (uint8_t i = 0; i < 8; i++) {
+    vec[i] = unit;
+  }
+  prism_err err = _prism_send_bank_ptr(
+      dev, vec, (op == PRISM_OPCODE_SPLAT_A) ? PRISM_BANK_A : PRISM_BANK_B,
+      timeout);
+  if (err == PR_OK && !splat) {
+    err = _prism_arch_send_opcode_arg1(dev, base, type, arg, timeout);
   }
-  uint8_t response = Wire.read(); // Read the response byte
-  if (response != 0x01) {  // Assuming 0x01 is the expected response for a
-                           // successful operation
-    return PR_ERR_UNKNOWN; // Device did not respond as expected
+  if (keep_b) {
+    // Also after a failed step, the caller still expects its B
+    prism_err restored =
+        _prism_send_bank_ptr(dev, saved_b, PRISM_BANK_B, timeout);
+    if (err == PR_OK) {
+      err = restored;
+    }
   }
+  return err;
+}
 
-  return PR_OK; // Assume success for now
+prism_err _prism_arch_send_opcode_imm(const prdev_t *dev, const uint16_t op,
+                                      const ui8 type, const ui8 arg,
+                                      const ui32 imm, timeout_t timeout) {
+  if (dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!prism_device_supports(dev, op, type)) {
+    return __prism_arch_emulate_imm(dev, op, type, arg, imm, timeout);
+  }
+
+  // Same layout as prism_send_data_t, followed by the 32-bit immediate
+  prism_send_data_imm data = {
+      .op = op, .arg = arg, .type = type, .timeout = timeout, .imm = imm};
+
+  __prism_frame_sent(dev, op, arg);
+  return __prism_arch_transmit(dev, (const uint8_t *)&data,
+                               sizeof(prism_send_data_imm_t));
 }
 
-uint8_t _prism_arch_get_variable(const prdev_t *dev, const uint16_t op) {
+// What the arg of prism_op means for an opcode
+#define __PRISM_ARG_LANES (0) // Nothing, the frame carries the lane count
+#define __PRISM_ARG_ALL (1)   // Nothing, the opcode always covers all lanes
+#define __PRISM_ARG_COUNT (2) // The 8-bit count of the frame, e.g. shifts
+#define __PRISM_ARG_IMM (3)   // The immediate, with the lane count
+#define __PRISM_ARG_SPLAT (4) // The immediate, no lane count
+#define __PRISM_ARG_CMP (5)   // Nothing, the lane count on float lanes only
+
+// Lane types of the integer and of all operations
+#define __PRISM_LANES_INT (0x07FF) // PRISM_LANE_UI32 to PRISM_LANE_UI256
+#define __PRISM_LANES_ANY (0x1FFF) // Integer, PRISM_LANE_FL and PRISM_LANE_HF
+
+typedef struct prism_op_desc {
+  uint16_t op;
+  uint16_t types; // PRISM_LANE_* bits the opcode accepts
+  uint8_t arg;    // __PRISM_ARG_*
+} prism_op_desc_t;
+
+// Lane operations ordered by opcode. In flash on AVR.
+static const prism_op_desc_t __prism_ops[] PROGMEM = {
+    {PRISM_OPCODE_ADD_N, __PRISM_LANES_ANY, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_SUB_N, __PRISM_LANES_ANY, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_MUL_N, __PRISM_LANES_ANY, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_DIV_N, __PRISM_LANES_ANY, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_AND_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_NAND_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_OR_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_XOR_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_NOR_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_NOT_N, __PRISM_LANES_INT, __PRISM_ARG_LANES},
+    {PRISM_OPCODE_NOTC, __PRISM_LANES_INT, __PRISM_ARG_ALL},
+    {PRISM_OPCODE_ADD_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_SUB_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_MUL_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_DIV_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_AND_S, __PRISM_LANES_INT, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_NAND_S, __PRISM_LANES_INT, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_OR_S, __PRISM_LANES_INT, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_XOR_S, __PRISM_LANES_INT, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_NOR_S, __PRISM_LANES_INT, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_SPLAT_A, __PRISM_LANES_ANY, __PRISM_ARG_SPLAT},
+    {PRISM_OPCODE_SPLAT_B, __PRISM_LANES_ANY, __PRISM_ARG_SPLAT},
+    {PRISM_OPCODE_CMP_EQ, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CMP_NE, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CMP_GT, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CMP_GE, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CMP_LT, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CMP_LE, __PRISM_LANES_ANY, __PRISM_ARG_CMP},
+    {PRISM_OPCODE_CPL2, __PRISM_LANES_INT, __PRISM_ARG_ALL},
+    {PRISM_OPCODE_SHIFT_L, __PRISM_LANES_INT, __PRISM_ARG_COUNT},
+    {PRISM_OPCODE_SHIFT_R, __PRISM_LANES_INT, __PRISM_ARG_COUNT},
+    {PRISM_OPCODE_CMP_EQ_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_CMP_NE_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_CMP_GT_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_CMP_GE_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_CMP_LT_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+    {PRISM_OPCODE_CMP_LE_S, __PRISM_LANES_ANY, __PRISM_ARG_IMM},
+};
+
+static const prism_op_desc_t *__prism_op_find(const uint16_t op) {
+  for (uint8_t i = 0; i < sizeof(__prism_ops) / sizeof(__prism_ops[0]); i++) {
+    const uint16_t entry = pgm_read_word(&__prism_ops[i].op);
+    if (entry == op) {
+      return &__prism_ops[i];
+    }
+    if (entry > op) {
+      break; // Ordered, op is not in the table
+    }
+  }
+  return 0;
+}
+
+prism_err _prism_op_arg(const uint16_t op, const ui8 type, const ui8 lanes,
+                        const ui32 arg, ui8 *frame_arg, bool *has_imm) {
+  if (lanes < 1 || lanes > 8) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  const prism_op_desc_t *desc = __prism_op_find(op);
+  if (desc == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if ((pgm_read_word(&desc->types) & __prism_lane_bit(type)) == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  *has_imm = false;
+  switch (pgm_read_byte(&desc->arg)) {
+  case __PRISM_ARG_LANES:
+    *frame_arg = (lanes % 8);
+    break;
+  case __PRISM_ARG_ALL:
+    *frame_arg = 255;
+    break;
+  case __PRISM_ARG_CMP:
+    // Integer compares always cover the vector, float compares take the
+    // lane count like the arithmetic
+    *frame_arg = ((__prism_lane_bit(type) & __PRISM_LANES_INT) != 0)
+                     ? 255
+                     : (lanes % 8);
+    break;
+  case __PRISM_ARG_COUNT:
+    *frame_arg = (ui8)arg;
+    break;
+  case __PRISM_ARG_IMM:
+    *frame_arg = (lanes % 8);
+    *has_imm = true;
+    break;
+  default:
+    *frame_arg = 0;
+    *has_imm = true;
+    break;
+  }
+  return PR_OK;
+}
+
+prism_err prism_op(const prdev_t *dev, const uint16_t op, const ui8 type,
+                   const ui8 lanes, const ui32 arg, timeout_t timeout) {
   if (dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  ui8 frame_arg = 0;
+  bool has_imm = false;
+  PRISM_TRY(_prism_op_arg(op, type, lanes, arg, &frame_arg, &has_imm));
+  if (has_imm) {
+    return _prism_arch_send_opcode_imm(dev, op, type, frame_arg, arg,
+                                       timeout);
+  }
+  return _prism_arch_send_opcode_arg1(dev, op, type, frame_arg, timeout);
+}
+
+static prism_err __prism_submit(const prdev_t *dev, const uint8_t *frame,
+                                const size_t len, timeout_t timeout,
+                                prism_pending_t *pending) {
+  if (dev->transport == 0) {
+    return PR_ERR_INVALID_ARGUMENT; // Device was never created
+  }
+
+  prism_err err = dev->transport->send_command(dev, frame, len);
+  if (err != PR_OK) {
+    return err; // Transmission error
+  }
+
+  pending->device = dev;
+  pending->start = millis();
+  pending->timeout = timeout;
+  return PR_OK;
+}
+
+prism_err prism_submit_opcode(const prdev_t *dev, const uint16_t op,
+                              const ui8 type, const ui8 arg, timeout_t timeout,
+                              prism_pending_t *pending) {
+  if (dev == 0 || pending == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!prism_device_supports(dev, op, type)) {
+    return PR_ERR_UNSUPPORTED_OPERATION;
+  }
+
+  prism_send_data data = {
+      .op = op, .arg = arg, .type = type, .timeout = timeout};
+
+  __prism_frame_sent(dev, op, arg);
+  return __prism_submit(dev, (const uint8_t *)&data,
+                        sizeof(prism_send_data_t), timeout, pending);
+}
+
+prism_err prism_submit_opcode_imm(const prdev_t *dev, const uint16_t op,
+                                  const ui8 type, const ui8 arg,
+                                  const ui32 imm, timeout_t timeout,
+                                  prism_pending_t *pending) {
+  if (dev == 0 || pending == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!prism_device_supports(dev, op, type)) {
+    return PR_ERR_UNSUPPORTED_OPERATION; // No wait-free emulation
+  }
+
+  prism_send_data_imm data = {
+      .op = op, .arg = arg, .type = type, .timeout = timeout, .imm = imm};
+
+  __prism_frame_sent(dev, op, arg);
+  return __prism_submit(dev, (const uint8_t *)&data,
+                        sizeof(prism_send_data_imm_t), timeout, pending);
+}
+
+prism_err prism_poll(prism_pending_t *pending, bool *done) {
+  if (pending == 0 || done == 0 || pending->device == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const prdev_t *dev = pending->device;
+  uint8_t response = PRISM_STATUS_BUSY;
+  prism_err err = PR_OK;
+
+  if (dev->transport->poll_status != 0) {
+    err = dev->transport->poll_status(dev, &response);
+  } else {
+    err = dev->transport->read_status(dev, &response); // Can only wait
+  }
+
+  *done = true;
+  if (err != PR_OK) {
+    return err;
+  }
+  if (response == PRISM_STATUS_BUSY) {
+    if ((ui32)(millis() - pending->start) <= pending->timeout) {
+      *done = false;
+      return PR_OK;
+    }
+    return PR_ERR_UNKNOWN; // Device did not answer in time
+  }
+  return __prism_status_err(response);
+}
+
+uint8_t _prism_arch_get_variable(const prdev_t *dev, const uint16_t op) {
+  if (dev == 0 || dev->transport == 0) {
     return 0;
   }
 
   prism_send_data data = {
       .op = op, .arg = 0, .type = PRISM_OPCODE_TYPE_UI8, .timeout = UINT16_MAX};
 
-  Wire.beginTransmission(dev->address); // Start Übertragung zum PCF8574
-  Wire.write((uint8_t *)&data, sizeof(prism_send_data_t)); // Wert schreiben
-  Wire.endTransmission();                                  // Ende
-
-  delay(50); // Wait for the dev to process the command
+  dev->transport->send_command(dev, (const uint8_t *)&data,
+                               sizeof(prism_send_data_t));
 
-  Wire.requestFrom(dev->address,
-                   sizeof(uint8_t)); // Request 1 byte from the dev
-  if (Wire.available() == 0) {
+  uint8_t value = 0;
+  if (dev->transport->read_status(dev, &value) != PR_OK) {
     return PR_ERR_UNKNOWN; // Device not responding
   }
-  return Wire.read(); // Read the response byte
+  return value; // Read the response byte
 }
 
-void __prism_send_byte(const prdev_t *dev, uint8_t byte, bool new_entry) {
-  // CLK auf HIGH (vorbereitend für Fallende Flanke)
-  digitalWrite(dev->config.pin5Time, HIGH);
-  // ENTRY_FLAG (Pin 6)
-  digitalWrite(dev->config.pin6Next, new_entry ? HIGH : LOW);
+// CRC-16/CCITT-FALSE, one nibble at a time. In flash on AVR.
+static const ui16 __prism_crc16_table[16] PROGMEM = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
 
-  // Daten setzen
-  digitalWrite(dev->config.pin1low, byte & 0x01);
-  digitalWrite(dev->config.pin2low, (byte >> 1) & 0x01);
-  digitalWrite(dev->config.pin3low, (byte >> 2) & 0x01);
-  digitalWrite(dev->config.pin4low, (byte >> 3) & 0x01);
-  digitalWrite(dev->config.pin7high, (byte >> 4) & 0x01);
-  digitalWrite(dev->config.pin8high, (byte >> 5) & 0x01);
-  digitalWrite(dev->config.pin9high, (byte >> 6) & 0x01);
-  digitalWrite(dev->config.pin10high, (byte >> 7) & 0x01);
+ui16 _prism_crc16(ui16 crc, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    uint8_t n = (uint8_t)((crc >> 12) ^ (data[i] >> 4));
+    crc = (ui16)((crc << 4) ^ pgm_read_word(&__prism_crc16_table[n]));
+    n = (uint8_t)((crc >> 12) ^ (data[i] & 0x0F));
+    crc = (ui16)((crc << 4) ^ pgm_read_word(&__prism_crc16_table[n]));
+  }
+  return crc;
+}
 
-  delayMicroseconds(2);
+bool _prism_link_retry(const prdev_t *dev, const prism_err err,
+                       const uint8_t attempt) {
+  prism_link_stats_t *stats = &__prism_state(dev)->link;
+  stats->blocks++;
+  if (err != PR_ERR_LINK) {
+    return false;
+  }
+  stats->crc_errors++;
+  if (attempt >= PRISM_LINK_RETRIES) {
+    stats->failures++;
+    return false;
+  }
+  stats->retries++;
+  return true;
+}
 
-  // Fallende Flanke erzeugen
-  digitalWrite(dev->config.pin5Time, LOW);
+// PR_ERR_LINK if the CRC received after a block does not match the block
+static prism_err __prism_check_crc(const ui32 *block, const uint8_t *tail) {
+  const ui16 crc =
+      _prism_crc16(PRISM_CRC16_INIT, (const uint8_t *)block, 8 * sizeof(ui32));
+  if (tail[0] != (uint8_t)crc || tail[1] != (uint8_t)(crc >> 8)) {
+    return PR_ERR_LINK;
+  }
+  return PR_OK;
+}
 
-  if (new_entry == true) {
-    // ENTRY_FLAG (Pin 6)
-    digitalWrite(dev->config.pin6Next, LOW);
+prism_err _prism_write_bank_data(const prdev_t *dev, const ui32 *src,
+                                 const bool pgm) {
+  prism_err err = PR_OK;
+  ui16 crc = PRISM_CRC16_INIT;
+  if (pgm) {
+    // Read one entry at a time from flash while it is sent
+    for (uint8_t i = 0; i < 8 && err == PR_OK; i++) {
+      ui32 entry = pgm_read_dword(&src[i]);
+      err = dev->transport->write_block(dev, (const uint8_t *)&entry,
+                                        sizeof(ui32));
+      if (dev->link_crc) {
+        crc = _prism_crc16(crc, (const uint8_t *)&entry, sizeof(ui32));
+      }
+    }
+  } else {
+    // Send the entries straight from the caller memory, no staging copy
+    err = dev->transport->write_block(dev, (const uint8_t *)src,
+                                      8 * sizeof(ui32));
+    if (dev->link_crc) {
+      crc = _prism_crc16(crc, (const uint8_t *)src, 8 * sizeof(ui32));
+    }
   }
+  if (err != PR_OK || !dev->link_crc) {
+    return err;
+  }
+  const uint8_t tail[2] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+  return dev->transport->write_block(dev, tail, sizeof(tail));
+}
 
-  // Hold-Zeit (nach der Flanke)
-  delayMicroseconds(4);
+prism_err _prism_read_bank_data(const prdev_t *dev, ui32 *out) {
+  prism_err err =
+      dev->transport->read_block(dev, (uint8_t *)out, 8 * sizeof(ui32));
+  if (err != PR_OK || !dev->link_crc) {
+    return err;
+  }
+  uint8_t tail[2];
+  err = dev->transport->read_block(dev, tail, sizeof(tail));
+  if (err != PR_OK) {
+    return err;
+  }
+  return __prism_check_crc(out, tail);
 }
-void __prism_send_uint32(const prdev_t *dev, ui32 entry) {
 
-  // Send each byte of the entry to the dev
-  __prism_send_byte(dev, entry & 0xFF, true); // First byte is a new entry
-  __prism_send_byte(dev, (entry >> 8) & 0xFF, false);
-  __prism_send_byte(dev, (entry >> 16) & 0xFF, false);
-  __prism_send_byte(dev, (entry >> 24) & 0xFF, false);
+// One attempt to write a bank. The device checks the CRC and answers END
+// with PRISM_STATUS_CRC if the block arrived damaged.
+static prism_err __prism_store_block(const prdev_t *dev, const ui32 *src,
+                                     const bool pgm, const bank_t bank,
+                                     timeout_t timeout) {
+  prism_err err = _prism_arch_send_opcode(dev, _prism_store_opcode(bank),
+                                          PRISM_OPCODE_TYPE_UI32, timeout);
+
+  if (err != PR_OK) {
+    return err;
+  }
+  err = _prism_write_bank_data(dev, src, pgm);
+
+  // The device closes the transfer in any case
+  prism_err end = _prism_arch_send_opcode(dev, PRISM_OPCODE_END,
+                                          PRISM_OPCODE_TYPE_UI8, timeout);
+  return (err != PR_OK) ? err : end;
+}
+
+// Writes a bank, sending it again while it fails its CRC
+static prism_err __prism_store_bank(const prdev_t *dev, const ui32 *src,
+                                    const bool pgm, const bank_t bank,
+                                    uint8_t attempt, timeout_t timeout) {
+  prism_err err;
+  do {
+    err = __prism_store_block(dev, src, pgm, bank, timeout);
+  } while (_prism_link_retry(dev, err, attempt++));
+  return err;
+}
+
+static prism_err __prism_send_bank(const prdev_t *dev, const ui32 *src,
+                                   const bool pgm, const bank_t bank,
+                                   timeout_t timeout) {
+  if (dev == 0 || dev->transport == 0 || src == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank != PRISM_BANK_A && bank != PRISM_BANK_B) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  return __prism_store_bank(dev, src, pgm, bank, 0, timeout);
 }
 
 prism_err _prism_send_bank_x(const prdev_t *dev, const _v256i vec,
                              const bank_t bank, timeout_t timeout) {
+  return __prism_send_bank(dev, vec.ui, false, bank, timeout);
+}
+
+prism_err _prism_send_bank_ptr(const prdev_t *dev, const ui32 *src,
+                               const bank_t bank, timeout_t timeout) {
+  return __prism_send_bank(dev, src, false, bank, timeout);
+}
 
-  prism_err err = _prism_arch_send_opcode(
-      dev, bank == PRISM_BANK_A ? PRISM_OPCODE_STORE_A : PRISM_OPCODE_STORE_B,
-      PRISM_OPCODE_TYPE_UI32, timeout);
+prism_err _prism_send_bank_pgm(const prdev_t *dev, const ui32 *src,
+                               const bank_t bank, timeout_t timeout) {
+  return __prism_send_bank(dev, src, true, bank, timeout);
+}
 
+// One attempt to read a bank, PR_ERR_LINK if it arrived damaged
+static prism_err __prism_load_block(const prdev_t *dev, const bank_t bank,
+                                    ui32 *out, timeout_t timeout) {
+  prism_err err = _prism_arch_send_opcode(dev, _prism_load_opcode(bank),
+                                          PRISM_OPCODE_TYPE_UI8, timeout);
   if (err != PR_OK) {
     return err;
   }
 
-  for (uint8_t i = 0; i < 8; i++) {
-    __prism_send_uint32(dev, vec.ui[i]);
-  }
+  // 2. Lese alle 8 Einträge (32 Bit × 8)
+  err = _prism_read_bank_data(dev, out);
 
-  _prism_arch_send_opcode(dev, PRISM_OPCODE_END, PRISM_OPCODE_TYPE_UI8,
-                          timeout);
+  // 3.  END-Opcode für Abschluss
+  prism_err end = _prism_arch_send_opcode(dev, PRISM_OPCODE_END,
+                                          PRISM_OPCODE_TYPE_UI32, timeout);
+  return (err != PR_OK) ? err : end;
+}
 
-  return PR_OK; // Assume success for now
+// Reads a bank, reading it again while it fails its CRC
+static prism_err __prism_load_bank(const prdev_t *dev, const bank_t bank,
+                                   ui32 *out, uint8_t attempt,
+                                   timeout_t timeout) {
+  prism_err err;
+  do {
+    err = __prism_load_block(dev, bank, out, timeout);
+  } while (_prism_link_retry(dev, err, attempt++));
+  return err;
 }
 
-uint8_t __prism_recv_byte(const prdev_t *dev, bool new_entry) {
-  // ENTRY_FLAG (Pin 6)
-  digitalWrite(dev->config.pin6Next, new_entry ? HIGH : LOW);
+prism_err _prism_load_bank_ptr(const prdev_t *dev, const bank_t bank,
+                               ui32 *out, timeout_t timeout) {
+  if (dev == 0 || dev->transport == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  return __prism_load_bank(dev, bank, out, 0, timeout);
+}
 
-  // Takt vorbereiten
-  digitalWrite(dev->config.pin5Time, HIGH);
-  delayMicroseconds(2); // Setup-Zeit für Empfänger
+prism_err _prism_exchange_bank_ptr(const prdev_t *dev, const bank_t load_bank,
+                                   ui32 *out, const bank_t store_bank,
+                                   const ui32 *src, timeout_t timeout) {
+  if (dev == 0 || dev->transport == 0 || out == 0 || src == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (load_bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (store_bank != PRISM_BANK_A && store_bank != PRISM_BANK_B) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
 
-  // Taktflanke erzeugen (Fallend)
-  digitalWrite(dev->config.pin5Time, LOW);
-  delayMicroseconds(2); // Hold-Zeit
+  if (dev->transport->exchange_block == 0 ||
+      (dev->features & PRISM_FEATURE_EXCHANGE) == 0 ||
+      (dev->link_crc && load_bank == store_bank)) {
+    // Half-duplex link or device, one transfer after the other. With the
+    // link CRC a bank exchanged with itself goes this way too, so a damaged
+    // read can be repeated before the bank is overwritten.
+    prism_err err = _prism_load_bank_ptr(dev, load_bank, out, timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+    return _prism_send_bank_ptr(dev, src, store_bank, timeout);
+  }
 
-  if (new_entry) {
-    digitalWrite(dev->config.pin6Next, LOW);
+  // High nibble: bank shifted out, low nibble: bank shifted in
+  prism_err err = _prism_arch_send_opcode_arg1(
+      dev, PRISM_OPCODE_EXCHANGE, PRISM_OPCODE_TYPE_UI32,
+      (ui8)((load_bank << 4) | store_bank), timeout);
+  if (err != PR_OK) {
+    return err;
   }
 
-  // Daten einlesen (nach der Fallenden Flanke)
-  uint8_t byte = 0;
-  byte |= digitalRead(dev->config.pin1low) << 0;
-  byte |= digitalRead(dev->config.pin2low) << 1;
-  byte |= digitalRead(dev->config.pin3low) << 2;
-  byte |= digitalRead(dev->config.pin4low) << 3;
-  byte |= digitalRead(dev->config.pin7high) << 4;
-  byte |= digitalRead(dev->config.pin8high) << 5;
-  byte |= digitalRead(dev->config.pin9high) << 6;
-  byte |= digitalRead(dev->config.pin10high) << 7;
+  err = dev->transport->exchange_block(dev, (const uint8_t *)src,
+                                       (uint8_t *)out, 8 * sizeof(ui32));
+  uint8_t tail_in[2] = {0, 0};
+  if (err == PR_OK && dev->link_crc) {
+    const ui16 crc = _prism_crc16(PRISM_CRC16_INIT, (const uint8_t *)src,
+                                  8 * sizeof(ui32));
+    const uint8_t tail_out[2] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+    err = dev->transport->exchange_block(dev, tail_out, tail_in, 2);
+  }
 
-  return byte;
-}
+  // END reports whether the block shifted in arrived intact
+  prism_err stored = _prism_arch_send_opcode(dev, PRISM_OPCODE_END,
+                                             PRISM_OPCODE_TYPE_UI32, timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+  prism_err loaded = dev->link_crc ? __prism_check_crc(out, tail_in) : PR_OK;
 
-uint32_t __prism_recv_uint32(const prdev_t *dev) {
-  uint32_t val = 0;
-  val |= ((uint32_t)__prism_recv_byte(dev, true)) << 0;
-  val |= ((uint32_t)__prism_recv_byte(dev, false)) << 8;
-  val |= ((uint32_t)__prism_recv_byte(dev, false)) << 16;
-  val |= ((uint32_t)__prism_recv_byte(dev, false)) << 24;
-  return val;
+  // Only the direction that failed is repeated, the banks differ here
+  if (_prism_link_retry(dev, loaded, 0)) {
+    loaded = __prism_load_bank(dev, load_bank, out, 1, timeout);
+  }
+  if (_prism_link_retry(dev, stored, 0)) {
+    stored = __prism_store_bank(dev, src, false, store_bank, 1, timeout);
+  }
+  return (loaded != PR_OK) ? loaded : stored;
 }
 
 prism_err _prism_load_bank_x(const prdev_t *dev, const bank_t bank, _v256i *out,
                              timeout_t timeout) {
+  if (out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_load_bank_ptr(dev, bank, out->ui, timeout);
+}
 
-  prism_err _ret = PR_OK;
-
-  if (bank == PRISM_BANK_A) {
-    _ret = _prism_arch_send_opcode(dev, PRISM_OPCODE_LOAD_A,
-                                   PRISM_OPCODE_TYPE_UI8, timeout);
-  } else if (bank == PRISM_BANK_B) {
-    _ret = _prism_arch_send_opcode(dev, PRISM_OPCODE_LOAD_B,
-                                   PRISM_OPCODE_TYPE_UI8, timeout);
-  } else if (bank == PRISM_BANK_C) {
-    _ret = _prism_arch_send_opcode(dev, PRISM_OPCODE_LOAD_C,
-                                   PRISM_OPCODE_TYPE_UI8, timeout);
-  } else if (bank == PRISM_BANK_D) {
-    _ret = _prism_arch_send_opcode(dev, PRISM_OPCODE_LOAD_D,
-                                   PRISM_OPCODE_TYPE_UI8, timeout);
-  } else {
-    _ret = PR_ERR_INVALID_ARGUMENT;
+prism_err _prism_load_bank_lazy(const prdev_t *dev, const bank_t bank,
+                                const uint8_t mode, prism_lazy_t *lazy,
+                                timeout_t timeout) {
+  if (dev == 0 || dev->transport == 0 || lazy == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
   }
+  if (bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // Nothing is read yet, the epoch tells whether the bank still holds it
+  lazy->device = dev;
+  lazy->bank = bank;
+  lazy->mode = mode;
+  lazy->epoch = dev->bank_epoch[bank];
+  lazy->valid = 0;
+  lazy->timeout = timeout;
+  return PR_OK;
+}
 
-  if (_ret != PR_OK) {
-    return _ret;
+bool _prism_lazy_cancelled(const prism_lazy_t *lazy) {
+  if (lazy == 0 || lazy->device == 0) {
+    return true;
   }
+  return lazy->valid != 0xFFFFFFFFUL &&
+         lazy->device->bank_epoch[lazy->bank] != lazy->epoch;
+}
 
-  // 2. Lese alle 8 Einträge (32 Bit × 8)
-  for (uint8_t i = 0; i < 8; i++) {
-    out->ui[i] = __prism_recv_uint32(dev);
+// Reads one byte of a bank as two nibbles over the status byte
+static prism_err __prism_peek_byte(const prdev_t *dev, const bank_t bank,
+                                   const uint8_t offset, uint8_t *out) {
+  uint8_t byte = 0;
+  for (uint8_t half = 0; half < 2; half++) {
+    prism_send_data data = {.op = PRISM_OPCODE_ARCH_PEEK,
+                            .arg = (ui8)((bank << 6) | (offset * 2 + half)),
+                            .type = PRISM_OPCODE_TYPE_UI8,
+                            .timeout = UINT16_MAX};
+    PRISM_TRY(dev->transport->send_command(dev, (const uint8_t *)&data,
+                                           sizeof(prism_send_data_t)));
+    uint8_t status = 0;
+    PRISM_TRY(dev->transport->read_status(dev, &status));
+    if ((status & 0xF0) != PRISM_PEEK_TAG) {
+      return PR_ERR_UNKNOWN; // Device did not respond as expected
+    }
+    byte |= (uint8_t)((status & 0x0F) << (half * 4));
+  }
+  *out = byte;
+  return PR_OK;
+}
+
+prism_err _prism_lazy_read(prism_lazy_t *lazy, const uint8_t offset,
+                           const uint8_t len, void *out) {
+  if (lazy == 0 || lazy->device == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (len == 0 || offset >= sizeof(_v256i) ||
+      len > sizeof(_v256i) - offset) {
+    return PR_ERR_INVALID_ARGUMENT;
   }
 
-  // 3.  END-Opcode für Abschluss
-  _prism_arch_send_opcode(dev, PRISM_OPCODE_END, PRISM_OPCODE_TYPE_UI32,
-                          timeout);
+  const prdev_t *dev = lazy->device;
+  const uint32_t want =
+      ((len == 32) ? 0xFFFFFFFFUL : ((1UL << len) - 1)) << offset;
+  if ((lazy->valid & want) != want) {
+    if (dev->bank_epoch[lazy->bank] != lazy->epoch) {
+      return PR_ERR_STALE; // The bank was written before it was read
+    }
 
+    // A peek costs two status reads. Transports without poll_status (P²Link)
+    // wait out the processing delay on every one, so a bank read is cheaper
+    if (lazy->mode == PRISM_LAZY_LANE && dev->transport->poll_status != 0 &&
+        prism_device_supports(dev, PRISM_OPCODE_ARCH_PEEK,
+                              PRISM_OPCODE_TYPE_UI8)) {
+      for (uint8_t i = offset; i < offset + len; i++) {
+        if ((lazy->valid & (1UL << i)) == 0) {
+          PRISM_TRY(
+              __prism_peek_byte(dev, lazy->bank, i, &lazy->value.uib[i]));
+          lazy->valid |= 1UL << i;
+        }
+      }
+    } else {
+      PRISM_TRY(_prism_load_bank_ptr(dev, lazy->bank, lazy->value.ui,
+                                     lazy->timeout));
+      lazy->valid = 0xFFFFFFFFUL;
+    }
+  }
+
+  memcpy(out, &lazy->value.uib[offset], len);
   return PR_OK;
 }
 
+static void __prism_describe_decode(const uint8_t *raw,
+                                    prism_describe_t *out) {
+  out->major = raw[0];
+  out->minor = raw[1];
+  out->patch = raw[2];
+  out->flank = raw[3];
+  out->protocol = raw[4];
+  out->banks = raw[5];
+  out->lane_types = (uint16_t)(raw[6] | (raw[7] << 8));
+  out->features = (uint32_t)raw[8] | ((uint32_t)raw[9] << 8) |
+                  ((uint32_t)raw[10] << 16) | ((uint32_t)raw[11] << 24);
+}
+
+// One variable read per field, for devices without PRISM_OPCODE_ARCH_DESCRIBE
+static void __prism_describe_legacy(const prdev_t *dev, prism_describe_t *out) {
+  out->flank = _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_FLANK);
+  out->major =
+      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_MAJOR);
+  out->minor =
+      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_MINOR);
+  out->patch =
+      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_PATCH);
+  out->protocol = 0;
+  out->banks = PRISM_BANK_MAX;
+  out->lane_types = PRISM_LANES_BASE;
+  out->features = PRISM_FEATURES_BASE;
+}
+
+static prism_err __prism_device_init(prdev_t *dev) {
+  // prism_device_create does not clear the structure
+  memset(&dev->link, 0, sizeof(prism_link_stats_t));
+  memset(dev->bank_epoch, 0, sizeof(dev->bank_epoch));
+  dev->link_crc = 0;
+  dev->clears_ab = 1;
+
+  if (dev->transport->begin != 0) {
+    prism_err err = dev->transport->begin(dev);
+    if (err != PR_OK) {
+      return err;
+    }
+  }
+
+  // Initialize the communication. ARCH_INIT is opcode 0, which
+  // _prism_arch_send_opcode rejects, so it goes out as a raw frame.
+  prism_err _err = _prism_arch_send_opcode_arg1(
+      dev, PRISM_OPCODE_ARCH_INIT, PRISM_OPCODE_TYPE_UI32, 255,
+      255); // Send initialization opcode
+
+  prism_describe_t desc;
+  memset(&desc, 0, sizeof(desc));
+  prism_err err = prism_device_describe(dev, &desc, 255);
+  if (err == PR_ERR_UNSUPPORTED_OPERATION) {
+    __prism_describe_legacy(dev, &desc);
+    err = PR_OK;
+  } else if (err != PR_OK) {
+    // No answer, keep the base capabilities so calls fail on the link
+    desc.lane_types = PRISM_LANES_BASE;
+    desc.features = PRISM_FEATURES_BASE;
+  }
+
+  dev->flank = desc.flank;
+  dev->major = desc.major;
+  dev->minor = desc.minor;
+  dev->patch = desc.patch;
+  dev->protocol = desc.protocol;
+  dev->lane_types = desc.lane_types;
+  dev->features = desc.features;
+
+  if (err == PR_OK && (dev->features & PRISM_FEATURE_CRC)) {
+    // Check every block if the device can
+    err = prism_link_crc(dev, true, 255);
+  }
+
+  return (_err != PR_OK) ? _err : err;
+}
+
+// Only the standard bus clocks, anything else is taken for an unset field
+static bool __prism_i2c_clock_valid(const uint32_t clock) {
+  return clock == PRISM_I2C_CLOCK_STANDARD || clock == PRISM_I2C_CLOCK_FAST ||
+         clock == PRISM_I2C_CLOCK_FAST_PLUS;
+}
+
+// Longest wait for a device that is still booting
+#define __PRISM_BOOT_WAIT_MS (100UL)
+
+// Waits until the device acknowledges its address, instead of a fixed delay
+static void __prism_wait_ack(const uint8_t address) {
+  unsigned long start = millis();
+  do {
+    Wire.beginTransmission(address);
+    if (Wire.endTransmission() == 0) {
+      return;
+    }
+  } while ((millis() - start) < __PRISM_BOOT_WAIT_MS);
+}
+
 // PUBLIC API
 
+void prism_dev_config_default(prism_dev_config_t *config) {
+  if (config == 0) {
+    return;
+  }
+
+  config->pin1low = PRISM_PIN_1LOW_DEFAULT;
+  config->pin2low = PRISM_PIN_2LOW_DEFAULT;
+  config->pin3low = PRISM_PIN_4LOW_DEFAULT;
+  config->pin4low = PRISM_PIN_3LOW_DEFAULT;
+  config->pin5Time = PRISM_PIN_CLK_DEFAULT;
+  config->pin6Next = PRISM_PIN_NXT_DEFAULT;
+  config->pin7high = PRISM_PIN_7HIGH_DEFAULT;
+  config->pin8high = PRISM_PIN_8HIGH_DEFAULT;
+  config->pin9high = PRISM_PIN_9HIGH_DEFAULT;
+  config->pin10high = PRISM_PIN_10HIGH_DEFAULT;
+  config->mode = PRISM_MODE_P2LINK;
+  config->spiCs = PRISM_PIN_CS_DEFAULT;
+  config->spiClock = PRISM_SPI_CLOCK_DEFAULT;
+  config->i2cClock = 0;
+}
+
 prism_err prism_device_create(const uint8_t address, bool wireInit,
                               const prism_dev_config_t *config, prdev_t *dev) {
   if (dev == 0) {
@@ -231,42 +1043,42 @@ prism_err prism_device_create(const uint8_t address, bool wireInit,
     return PR_ERR_INVALID_ARGUMENT;
   } // Ensure address is within valid I2C range
 
-  prism_err _err = PR_OK;
   dev->address = address;
-  if (wireInit)
-    Wire.begin();
-  delay(100); // Wait for the I2C bus to stabilize
+  dev->transport_ctx = 0;
 
   if (config == 0) {
     // If no config is provided, use default values
-    dev->config.pin1low = PRISM_PIN_1LOW_DEFAULT;
-    dev->config.pin2low = PRISM_PIN_2LOW_DEFAULT;
-    dev->config.pin3low = PRISM_PIN_4LOW_DEFAULT;
-    dev->config.pin4low = PRISM_PIN_3LOW_DEFAULT;
-    dev->config.pin5Time = PRISM_PIN_CLK_DEFAULT;
-    dev->config.pin6Next = PRISM_PIN_NXT_DEFAULT;
-    dev->config.pin7high = PRISM_PIN_7HIGH_DEFAULT;
-    dev->config.pin8high = PRISM_PIN_8HIGH_DEFAULT;
-    dev->config.pin9high = PRISM_PIN_9HIGH_DEFAULT;
-    dev->config.pin10high = PRISM_PIN_10HIGH_DEFAULT;
+    prism_dev_config_default(&dev->config);
   } else {
     // Copy the provided configuration
     dev->config = *config;
   }
-  // Initialize the I2C communication
-  _err = _prism_arch_send_opcode(dev, PRISM_OPCODE_ARCH_INIT,
-                                 PRISM_OPCODE_TYPE_UI32,
-                                 255); // Send initialization opcode
 
-  dev->flank = _prism_arch_get_variable(
-      dev, PRISM_OPCODE_ARCH_GET_FLANK); // Get the flank speed variable
+  if (dev->config.mode == PRISM_MODE_SPI) {
+    if (dev->config.spiClock == 0) {
+      dev->config.spiClock = PRISM_SPI_CLOCK_DEFAULT;
+    }
+    dev->transport = &prism_transport_spi;
+  } else {
+    // Configurations from before the mode field leave it unset: P²Link
+    if (dev->config.mode != PRISM_MODE_I2C) {
+      dev->config.mode = PRISM_MODE_P2LINK;
+    }
+    dev->transport = (dev->config.mode == PRISM_MODE_I2C)
+                         ? &prism_transport_i2c
+                         : &prism_transport_p2link;
+    if (wireInit)
+      Wire.begin();
+    if (__prism_i2c_clock_valid(dev->config.i2cClock)) {
+      Wire.setClock(dev->config.i2cClock);
+    }
+    __prism_wait_ack(address);
+  }
 
-  dev->major =
-      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_MAJOR);
-  dev->minor =
-      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_MINOR);
-  dev->patch =
-      _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_VERSION_PATCH);
+  prism_err err = __prism_device_init(dev);
+  if (err != PR_OK) {
+    return err;
+  }
 
   if ((dev->major != 0 && dev->minor != 0 && dev->patch != 0)) {
 
@@ -282,6 +1094,124 @@ prism_err prism_device_create(const uint8_t address, bool wireInit,
   return PR_OK;
 }
 
+prism_err prism_device_create_with(const uint8_t address,
+                                   const prism_transport_t *transport,
+                                   void *ctx, prdev_t *dev) {
+  if (dev == 0 || transport == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (transport->send_command == 0 || transport->read_status == 0 ||
+      transport->write_block == 0 || transport->read_block == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  } // Ensure the backend is complete
+
+  memset(dev, 0, sizeof(prdev_t));
+  dev->address = address;
+  dev->transport = transport;
+  dev->transport_ctx = ctx;
+
+  return __prism_device_init(dev);
+}
+
+prism_err prism_device_describe(const prdev_t *dev, prism_describe_t *out,
+                                timeout_t timeout) {
+  if (dev == 0 || dev->transport == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_send_data data = {.op = PRISM_OPCODE_ARCH_DESCRIBE,
+                          .arg = 0,
+                          .type = PRISM_OPCODE_TYPE_UI8,
+                          .timeout = timeout};
+  prism_err err = dev->transport->send_command(dev, (const uint8_t *)&data,
+                                               sizeof(prism_send_data_t));
+  if (err != PR_OK) {
+    return err;
+  }
+
+  uint8_t status = 0;
+  err = dev->transport->read_status(dev, &status);
+  if (err != PR_OK) {
+    return err;
+  }
+  if (status == PRISM_STATUS_FAIL) {
+    return PR_ERR_UNSUPPORTED_OPERATION; // Older firmware
+  }
+  if (status != PRISM_STATUS_OK) {
+    return PR_ERR_UNKNOWN;
+  }
+
+  // The transfer ends by itself after the descriptor, no END frame
+  uint8_t raw[PRISM_DESCRIBE_SIZE];
+  err = dev->transport->read_block(dev, raw, sizeof(raw));
+  if (err != PR_OK) {
+    return err;
+  }
+  __prism_describe_decode(raw, out);
+  return PR_OK;
+}
+
+prism_err prism_bus_scan_with(const prism_transport_t *transport, void *ctx,
+                              const uint8_t first, const uint8_t last,
+                              prism_bus_entry_t *found, const uint8_t max,
+                              uint8_t *count) {
+  if (transport == 0 || found == 0 || count == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (transport->send_command == 0 || transport->read_status == 0 ||
+      transport->read_block == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (first == 0 || last > 127 || first > last) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // The descriptor comes back the way prism_device_create_with reads it
+  prdev_t probe;
+  memset(&probe, 0, sizeof(probe));
+  probe.transport = transport;
+  probe.transport_ctx = ctx;
+  if (transport->begin != 0) {
+    prism_err err = transport->begin(&probe);
+    if (err != PR_OK) {
+      return err;
+    }
+  }
+  // Frames go over I²C: an address-only transaction finds the devices
+  const bool i2c = (transport->send_command == _prism_i2c_send_command);
+
+  *count = 0;
+  for (uint16_t address = first; address <= last && *count < max;
+       address++) {
+    if (i2c) {
+      Wire.beginTransmission((uint8_t)address);
+      if (Wire.endTransmission() != 0) {
+        continue; // Nobody there
+      }
+    }
+
+    probe.address = (uint8_t)address;
+    prism_bus_entry_t *entry = &found[*count];
+    prism_err err = prism_device_describe(&probe, &entry->describe, 255);
+    if (err == PR_ERR_UNSUPPORTED_OPERATION) {
+      __prism_describe_legacy(&probe, &entry->describe); // Older firmware
+    } else if (err != PR_OK) {
+      continue;
+    }
+    entry->address = (uint8_t)address;
+    (*count)++;
+  }
+  return PR_OK;
+}
+
+prism_err prism_bus_scan(const uint8_t first, const uint8_t last,
+                         prism_bus_entry_t *found, const uint8_t max,
+                         uint8_t *count) {
+  // The link prism_device_create uses without a configuration
+  return prism_bus_scan_with(&prism_transport_p2link, 0, first, last, found,
+                             max, count);
+}
+
 prism_err prism_device_stop(const prdev_t *dev) {
   if (dev == 0) {
     return PR_ERR_INVALID_ARGUMENT;
@@ -312,5 +1242,41 @@ prism_err prism_device_reset(const prdev_t *dev) {
 
   delay(50); // Wait for the dev to process the reset command
 
+  if (dev->link_crc) {
+    // The reset also returns the link to the plain protocol
+    return _prism_arch_send_opcode_arg1(dev, PRISM_OPCODE_ARCH_LINK_CRC,
+                                        PRISM_OPCODE_TYPE_UI8, 1, 255);
+  }
+
   return PR_OK; // Assume success for now
 }
+
+prism_err prism_link_crc(prdev_t *dev, const bool enable, timeout_t timeout) {
+  if (dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_err err = _prism_arch_send_opcode_arg1(
+      dev, PRISM_OPCODE_ARCH_LINK_CRC, PRISM_OPCODE_TYPE_UI8, enable ? 1 : 0,
+      timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+  dev->link_crc = enable ? 1 : 0;
+  return PR_OK;
+}
+
+prism_err prism_link_stats(const prdev_t *dev, prism_link_stats_t *stats) {
+  if (dev == 0 || stats == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  *stats = dev->link;
+  return PR_OK;
+}
+
+void prism_link_stats_reset(prdev_t *dev) {
+  if (dev == 0) {
+    return;
+  }
+  memset(&dev->link, 0, sizeof(prism_link_stats_t));
+}
@@ -0,0 +1,289 @@
+#include "prism/prism_bigint.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+static inline bool __prism_bigint_width_valid(const prism_bigint_width_t w) {
+  return w == PRISM_BIGINT_64 || w == PRISM_BIGINT_128 ||
+         w == PRISM_BIGINT_256;
+}
+
+// Limbs of block blk, zero padded if the block is partial
+static const ui32 *__prism_bigint_src(const ui32 *base, const size_t total,
+                                      const size_t blk, _v256i *scratch) {
+  const size_t first = blk * 8;
+  if (total - first >= 8) {
+    return &base[first];
+  }
+  memset(scratch, 0, sizeof(_v256i));
+  memcpy(scratch->ui, &base[first], (total - first) * sizeof(ui32));
+  return scratch->ui;
+}
+
+// Resolves the carries (borrows) of the lanes from the least significant
+// limb of every value up:
+//   add: out = s + cin, cout = k | (cin & (out == 0))
+//   sub: out = d - cin, cout = k | (cin & (d == 0))
+static void __prism_bigint_resolve(const bool sub, const ui8 width,
+                                   const _v256i *lanes, const _v256i *k,
+                                   ui32 *out, const size_t values,
+                                   ui8 *carry) {
+  for (size_t v = 0; v < values; v++) {
+    ui32 cin = 0;
+    for (ui8 i = 0; i < width; i++) {
+      const ui8 l = (ui8)(v * width + i);
+      const ui32 x = lanes->ui[l];
+      const ui32 r = sub ? x - cin : x + cin;
+      const bool wrapped = cin != 0 && (sub ? x == 0 : r == 0);
+      cin = (k->ui[l] != 0 || wrapped) ? 1 : 0;
+      out[l] = r;
+    }
+    if (carry != 0) {
+      carry[v] = (ui8)cin;
+    }
+  }
+}
+
+// Leaves the sum (difference) in bank A (B) and the carries in bank C
+static prism_err __prism_bigint_addsub_block(const prdev_t *dev,
+                                             const bool sub, ui32 timeout) {
+  if (sub) {
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_SUB_N, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       timeout));
+    PRISM_TRY(_v256_store_ctob(dev, timeout)); // B = d, A = a
+  } else {
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       timeout));
+    PRISM_TRY(_v256_store_ctoa(dev, timeout)); // A = s, B = b
+  }
+  // add: s < b, sub: a < d
+  return prism_op(dev, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                  timeout);
+}
+
+static prism_err __prism_bigint_addsub(const prdev_t *dev, const bool sub,
+                                       const ui8 width, const ui32 *a,
+                                       const ui32 *b, ui32 *out,
+                                       const size_t count, ui8 *carry,
+                                       ui32 timeout) {
+  const size_t total = count * width;
+  const size_t blocks = (total + 7) / 8;
+  const size_t per_block = 8 / width;
+  _v256i sa, sb, lanes, k;
+
+  for (size_t blk = 0; blk < blocks; blk++) {
+    PRISM_TRY(_prism_send_bank_ptr(
+        dev, __prism_bigint_src(a, total, blk, &sa), PRISM_BANK_A, timeout));
+    PRISM_TRY(_prism_send_bank_ptr(
+        dev, __prism_bigint_src(b, total, blk, &sb), PRISM_BANK_B, timeout));
+    PRISM_TRY(__prism_bigint_addsub_block(dev, sub, timeout));
+    PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, k.ui, timeout));
+    PRISM_TRY(_prism_load_bank_ptr(dev, sub ? PRISM_BANK_B : PRISM_BANK_A,
+                                   lanes.ui, timeout));
+
+    const size_t first = blk * per_block;
+    const size_t values =
+        (count - first < per_block) ? count - first : per_block;
+    ui32 result[8];
+    __prism_bigint_resolve(sub, width, &lanes, &k, result, values,
+                           carry != 0 ? &carry[first] : 0);
+    memcpy(&out[blk * 8], result, values * width * sizeof(ui32));
+  }
+  return PR_OK;
+}
+
+// Leaves no-clear-after-op mode, which the carry compares and the shifts need
+// for both banks, and returns the first error
+static prism_err __prism_bigint_done(const prdev_t *dev, const prism_err err,
+                                     ui32 timeout) {
+  prism_err restore = _v256_set_caop(dev, timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+prism_err prism_bigint_add(const prdev_t *dev, const prism_bigint_width_t width,
+                           const ui32 *a, const ui32 *b, ui32 *out,
+                           const size_t count, ui8 *carry, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_bigint_width_valid(width)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0) {
+    return PR_OK;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_bigint_addsub(dev, false, (ui8)width, a, b, out,
+                                        count, carry, timeout);
+  return __prism_bigint_done(dev, err, timeout);
+}
+
+prism_err prism_bigint_sub(const prdev_t *dev, const prism_bigint_width_t width,
+                           const ui32 *a, const ui32 *b, ui32 *out,
+                           const size_t count, ui8 *borrow, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_bigint_width_valid(width)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0) {
+    return PR_OK;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_bigint_addsub(dev, true, (ui8)width, a, b, out, count,
+                                        borrow, timeout);
+  return __prism_bigint_done(dev, err, timeout);
+}
+
+static prism_err __prism_bigint_cmp(const prdev_t *dev, const ui8 width,
+                                    const ui32 *a, const ui32 *b, si8 *result,
+                                    const size_t count, ui32 timeout) {
+  const size_t total = count * width;
+  const size_t blocks = (total + 7) / 8;
+  const size_t per_block = 8 / width;
+  _v256i sa, sb, lt, gt;
+
+  for (size_t blk = 0; blk < blocks; blk++) {
+    PRISM_TRY(_prism_send_bank_ptr(
+        dev, __prism_bigint_src(a, total, blk, &sa), PRISM_BANK_A, timeout));
+    PRISM_TRY(_prism_send_bank_ptr(
+        dev, __prism_bigint_src(b, total, blk, &sb), PRISM_BANK_B, timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_CMP_LT, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       timeout));
+    PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, lt.ui, timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_CMP_GT, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       timeout));
+    PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, gt.ui, timeout));
+
+    // The most significant limb that differs decides
+    for (size_t v = 0; v < per_block && blk * per_block + v < count; v++) {
+      si8 r = 0;
+      for (ui8 i = width; i-- > 0 && r == 0;) {
+        const size_t l = v * width + i;
+        r = lt.ui[l] ? -1 : gt.ui[l] ? 1 : 0;
+      }
+      result[blk * per_block + v] = r;
+    }
+  }
+  return PR_OK;
+}
+
+prism_err prism_bigint_cmp(const prdev_t *dev, const prism_bigint_width_t width,
+                           const ui32 *a, const ui32 *b, si8 *result,
+                           const size_t count, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || result == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_bigint_width_valid(width)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0) {
+    return PR_OK;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_bigint_cmp(dev, (ui8)width, a, b, result, count,
+                                     timeout);
+  return __prism_bigint_done(dev, err, timeout);
+}
+
+// Limb i of value v moved by limbs towards the top (left) or the bottom,
+// zero where it comes from outside the value
+static inline ui32 __prism_bigint_limb(const ui32 *v, const ui8 width,
+                                       const bool left, const int i,
+                                       const int limbs) {
+  const int from = left ? i - limbs : i + limbs;
+  return (from >= 0 && from < width) ? v[from] : 0;
+}
+
+static prism_err __prism_bigint_shift(const prdev_t *dev, const bool left,
+                                      const ui8 width, const ui32 *a,
+                                      const ui16 shift, ui32 *out,
+                                      const size_t count, ui32 timeout) {
+  const size_t per_block = 8 / width;
+  const ui16 limbs = shift / 32;
+  const ui8 bits = shift % 32;
+  const ui16 near = left ? PRISM_OPCODE_SHIFT_L : PRISM_OPCODE_SHIFT_R;
+  const ui16 far = left ? PRISM_OPCODE_SHIFT_R : PRISM_OPCODE_SHIFT_L;
+
+  for (size_t first = 0; first < count; first += per_block) {
+    const size_t values =
+        (count - first < per_block) ? count - first : per_block;
+
+    // p = the limbs moved by whole limbs, q = their neighbours whose bits
+    // cross into the lane
+    _v256i p, q;
+    memset(&p, 0, sizeof(p));
+    memset(&q, 0, sizeof(q));
+    for (size_t v = 0; v < values; v++) {
+      const ui32 *src = &a[(first + v) * width];
+      for (ui8 i = 0; i < width; i++) {
+        p.ui[v * width + i] = __prism_bigint_limb(src, width, left, i, limbs);
+        q.ui[v * width + i] =
+            __prism_bigint_limb(src, width, left, i, limbs + 1);
+      }
+    }
+
+    ui32 *dst = &out[first * width];
+    if (bits == 0) {
+      memcpy(dst, p.ui, values * width * sizeof(ui32));
+      continue;
+    }
+
+    // C = (p << bits) | (q >> (32 - bits)) for a left shift
+    PRISM_TRY(_prism_send_bank_ptr(dev, p.ui, PRISM_BANK_A, timeout));
+    PRISM_TRY(prism_op(dev, near, PRISM_OPCODE_TYPE_UI32, 8, bits, timeout));
+    PRISM_TRY(_v256_store_ctob(dev, timeout));
+    PRISM_TRY(_prism_send_bank_ptr(dev, q.ui, PRISM_BANK_A, timeout));
+    PRISM_TRY(prism_op(dev, far, PRISM_OPCODE_TYPE_UI32, 8, 32 - bits,
+                       timeout));
+    PRISM_TRY(_v256_store_ctoa(dev, timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_OR_N, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       timeout));
+    PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, p.ui, timeout));
+    memcpy(dst, p.ui, values * width * sizeof(ui32));
+  }
+  return PR_OK;
+}
+
+prism_err prism_bigint_shl(const prdev_t *dev, const prism_bigint_width_t width,
+                           const ui32 *a, const ui16 shift, ui32 *out,
+                           const size_t count, ui32 timeout) {
+  if (dev == 0 || a == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_bigint_width_valid(width)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0) {
+    return PR_OK;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_bigint_shift(dev, true, (ui8)width, a, shift, out,
+                                       count, timeout);
+  return __prism_bigint_done(dev, err, timeout);
+}
+
+prism_err prism_bigint_shr(const prdev_t *dev, const prism_bigint_width_t width,
+                           const ui32 *a, const ui16 shift, ui32 *out,
+                           const size_t count, ui32 timeout) {
+  if (dev == 0 || a == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_bigint_width_valid(width)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0) {
+    return PR_OK;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_bigint_shift(dev, false, (ui8)width, a, shift, out,
+                                       count, timeout);
+  return __prism_bigint_done(dev, err, timeout);
+}
@@ -0,0 +1,301 @@
+#include "prism/prism_bitset.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+// PRISM_BITSET_* of a binary operation, or the complement
+#define __PRISM_BITSET_COMPLEMENT 0xFF
+
+typedef struct prism_bitset_run {
+  const prdev_t *device;
+  ui8 op;
+  const ui32 *a;
+  const ui32 *b; // 0 for the complement
+  ui32 *out;
+  size_t words;
+  size_t blocks; // 256-bit blocks, the last one may be partial
+  ui32 timeout;
+} prism_bitset_run_t;
+
+static inline ui32 __prism_popcount32(ui32 v) {
+  v = v - ((v >> 1) & 0x55555555UL);
+  v = (v & 0x33333333UL) + ((v >> 2) & 0x33333333UL);
+  v = (v + (v >> 4)) & 0x0F0F0F0FUL;
+  return (ui32)(v * 0x01010101UL) >> 24;
+}
+
+// Valid bits of the last word, all bits for a whole word
+static inline ui32 __prism_bitset_tail_mask(const size_t bits) {
+  return (bits % 32) ? (((ui32)1 << (bits % 32)) - 1) : 0xFFFFFFFFUL;
+}
+
+static inline size_t __prism_bitset_block_words(const prism_bitset_run_t *run,
+                                                const size_t block) {
+  const size_t first = block * 8;
+  return (run->words - first < 8) ? run->words - first : 8;
+}
+
+static inline bool __prism_bitset_zero(const ui32 *w, const size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (w[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Resolves a block on the host when an operand is all zero. Returns false if
+// the block has to go through the device.
+static bool __prism_bitset_host(const prism_bitset_run_t *run,
+                                const size_t block) {
+  const size_t first = block * 8;
+  const size_t n = __prism_bitset_block_words(run, block);
+  const ui32 *a = &run->a[first];
+  ui32 *out = &run->out[first];
+
+  const bool za = __prism_bitset_zero(a, n);
+  if (run->op == __PRISM_BITSET_COMPLEMENT) {
+    if (za) {
+      memset(out, 0xFF, n * sizeof(ui32));
+    }
+    return za;
+  }
+
+  const ui32 *b = &run->b[first];
+  const bool zb = __prism_bitset_zero(b, n);
+  const ui32 *copy = 0;
+
+  switch (run->op) {
+  case PRISM_BITSET_UNION:
+  case PRISM_BITSET_SYMDIFF:
+    if (!za && !zb) {
+      return false;
+    }
+    copy = za ? b : a;
+    break;
+  case PRISM_BITSET_INTERSECT:
+    if (!za && !zb) {
+      return false;
+    }
+    break;
+  case PRISM_BITSET_DIFFERENCE:
+    if (!za && !zb) {
+      return false;
+    }
+    copy = za ? 0 : a;
+    break;
+  default:
+    return false;
+  }
+
+  if (copy == 0) {
+    memset(out, 0, n * sizeof(ui32));
+  } else if (copy != out) {
+    memmove(out, copy, n * sizeof(ui32));
+  }
+  return true;
+}
+
+// Resolves host blocks from block on, returns the next block for the device
+static size_t __prism_bitset_next(const prism_bitset_run_t *run,
+                                  size_t block) {
+  while (block < run->blocks && __prism_bitset_host(run, block)) {
+    block++;
+  }
+  return block;
+}
+
+// A whole block is sent from caller memory, a partial one zero padded
+static const ui32 *__prism_bitset_src(const prism_bitset_run_t *run,
+                                      const ui32 *base, const size_t block,
+                                      _v256i *scratch) {
+  const size_t n = __prism_bitset_block_words(run, block);
+  if (n == 8) {
+    return &base[block * 8];
+  }
+  memset(scratch, 0, sizeof(_v256i));
+  memcpy(scratch->ui, &base[block * 8], n * sizeof(ui32));
+  return scratch->ui;
+}
+
+// Bank A holds block of a. Leaves the result in bank C.
+static prism_err __prism_bitset_device_op(const prism_bitset_run_t *run,
+                                          const size_t block) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+  _v256i scratch;
+
+  if (run->op == __PRISM_BITSET_COMPLEMENT) {
+    return prism_op(dev, PRISM_OPCODE_NOT_N, PRISM_OPCODE_TYPE_UI32, 8, 0, t);
+  }
+
+  PRISM_TRY(_prism_send_bank_ptr(
+      dev, __prism_bitset_src(run, run->b, block, &scratch), PRISM_BANK_B, t));
+
+  switch (run->op) {
+  case PRISM_BITSET_UNION:
+    return prism_op(dev, PRISM_OPCODE_OR_N, PRISM_OPCODE_TYPE_UI32, 8, 0, t);
+  case PRISM_BITSET_INTERSECT:
+    return prism_op(dev, PRISM_OPCODE_AND_N, PRISM_OPCODE_TYPE_UI32, 8, 0, t);
+  case PRISM_BITSET_SYMDIFF:
+    return prism_op(dev, PRISM_OPCODE_XOR_N, PRISM_OPCODE_TYPE_UI32, 8, 0, t);
+  default:
+    // a & ~b == a & (a ^ b), bank A is kept by no-clear-after-op mode
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_XOR_N, PRISM_OPCODE_TYPE_UI32, 8, 0,
+                       t));
+    PRISM_TRY(_v256_store_ctob(dev, t));
+    return prism_op(dev, PRISM_OPCODE_AND_N, PRISM_OPCODE_TYPE_UI32, 8, 0, t);
+  }
+}
+
+// Streams the device blocks from block on, the first one is not resolved on
+// the host
+static prism_err __prism_bitset_stream(const prism_bitset_run_t *run,
+                                       size_t block) {
+  const prdev_t *dev = run->device;
+  _v256i upload, result;
+
+  PRISM_TRY(_prism_send_bank_ptr(
+      dev, __prism_bitset_src(run, run->a, block, &upload), PRISM_BANK_A,
+      run->timeout));
+
+  while (block < run->blocks) {
+    PRISM_TRY(__prism_bitset_device_op(run, block));
+
+    const size_t n = __prism_bitset_block_words(run, block);
+    ui32 *dst = (n == 8) ? &run->out[block * 8] : result.ui;
+    const size_t next = __prism_bitset_next(run, block + 1);
+
+    if (next < run->blocks) {
+      PRISM_TRY(_prism_exchange_bank_ptr(
+          dev, PRISM_BANK_C, dst, PRISM_BANK_A,
+          __prism_bitset_src(run, run->a, next, &upload), run->timeout));
+    } else {
+      PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, dst, run->timeout));
+    }
+    if (dst == result.ui) {
+      memcpy(&run->out[block * 8], result.ui, n * sizeof(ui32));
+    }
+    block = next;
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_bitset_run(prism_bitset_run_t *run,
+                                    const size_t bits) {
+  run->words = PRISM_BITSET_WORDS(bits);
+  run->blocks = (run->words + 7) / 8;
+
+  prism_err err = PR_OK;
+  const size_t first = __prism_bitset_next(run, 0);
+  if (first < run->blocks) {
+    // The difference needs bank A for a second operation
+    PRISM_TRY(_v256_set_ncaop(run->device, run->timeout));
+    err = __prism_bitset_stream(run, first);
+    prism_err restore = _v256_set_caop(run->device, run->timeout);
+    if (err == PR_OK) {
+      err = restore;
+    }
+  }
+
+  if (run->words != 0) {
+    run->out[run->words - 1] &= __prism_bitset_tail_mask(bits);
+  }
+  return err;
+}
+
+void prism_bitset_init(prism_bitset_t *set, ui32 *words, const size_t bits) {
+  if (set == 0) {
+    return;
+  }
+  set->words = words;
+  set->bits = bits;
+  if (words != 0) {
+    memset(words, 0, PRISM_BITSET_WORDS(bits) * sizeof(ui32));
+  }
+}
+
+prism_err prism_bitset_op(const prdev_t *dev, const prism_bitset_op_t op,
+                          const prism_bitset_t *a, const prism_bitset_t *b,
+                          prism_bitset_t *out, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (a->words == 0 || b->words == 0 || out->words == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (op > PRISM_BITSET_SYMDIFF || a->bits != b->bits ||
+      a->bits != out->bits) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_bitset_run_t run;
+  run.device = dev;
+  run.op = (ui8)op;
+  run.a = a->words;
+  run.b = b->words;
+  run.out = out->words;
+  run.timeout = timeout;
+  return __prism_bitset_run(&run, a->bits);
+}
+
+prism_err prism_bitset_complement(const prdev_t *dev, const prism_bitset_t *a,
+                                  prism_bitset_t *out, ui32 timeout) {
+  if (dev == 0 || a == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (a->words == 0 || out->words == 0 || a->bits != out->bits) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_bitset_run_t run;
+  run.device = dev;
+  run.op = __PRISM_BITSET_COMPLEMENT;
+  run.a = a->words;
+  run.b = 0;
+  run.out = out->words;
+  run.timeout = timeout;
+  return __prism_bitset_run(&run, a->bits);
+}
+
+size_t prism_bitset_count(const prism_bitset_t *set) {
+  if (set == 0 || set->words == 0) {
+    return 0;
+  }
+
+  size_t count = 0;
+  const size_t words = PRISM_BITSET_WORDS(set->bits);
+  for (size_t i = 0; i < words; i++) {
+    if (set->words[i] != 0) {
+      count += __prism_popcount32(set->words[i]);
+    }
+  }
+  return count;
+}
+
+bool prism_bitset_any(const prism_bitset_t *set) {
+  if (set == 0 || set->words == 0) {
+    return false;
+  }
+  return !__prism_bitset_zero(set->words, PRISM_BITSET_WORDS(set->bits));
+}
+
+bool prism_bitset_all(const prism_bitset_t *set) {
+  if (set == 0 || set->words == 0) {
+    return false;
+  }
+
+  const size_t words = PRISM_BITSET_WORDS(set->bits);
+  for (size_t i = 0; i + 1 < words; i++) {
+    if (set->words[i] != 0xFFFFFFFFUL) {
+      return false;
+    }
+  }
+  if (words == 0) {
+    return true;
+  }
+
+  const ui32 mask = __prism_bitset_tail_mask(set->bits);
+  return (set->words[words - 1] & mask) == mask;
+}
@@ -0,0 +1,308 @@
+#include "prism/prism_coro.h"
+
+#include "prism_internal.h"
+
+#if PRISM_ENABLE_COROUTINES == 1
+
+namespace prism {
+
+frame_awaiter::frame_awaiter(scheduler &sched, const prdev_t *device,
+                             const uint16_t op, const ui8 type, const ui8 arg,
+                             const ui32 imm, const bool has_imm,
+                             timeout_t timeout) noexcept
+    : m_sched(sched), m_device(device), m_op(op), m_type(type), m_arg(arg),
+      m_imm(imm), m_has_imm(has_imm), m_submitted(false), m_timeout(timeout),
+      m_pending(), m_err(PR_OK), m_next(nullptr) {
+  if (device == 0) {
+    m_err = PR_ERR_INVALID_ARGUMENT;
+  }
+}
+
+bool frame_awaiter::await_ready() noexcept {
+  if (m_err != PR_OK) {
+    return true;
+  }
+  // Another frame is in flight on this device, send when it is answered
+  if (m_sched.device_busy(m_device)) {
+    return false;
+  }
+  m_sched.submit(this);
+  return m_err != PR_OK;
+}
+
+void frame_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept {
+  m_handle = handle;
+  m_sched.enqueue(this);
+}
+
+bool lock_awaiter::await_ready() noexcept {
+  return m_sched.try_lock(m_device);
+}
+
+void lock_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept {
+  m_handle = handle;
+  m_sched.wait_lock(this);
+}
+
+scheduler::scheduler(timeout_t timeout) noexcept
+    : m_timeout(timeout), m_running(0), m_tasks(nullptr), m_frames(nullptr),
+      m_lock_waiters(nullptr), m_granted(nullptr) {
+  for (uint8_t i = 0; i < PRISM_CORO_MAX_DEVICES; i++) {
+    m_locked[i] = 0;
+  }
+}
+
+scheduler::~scheduler() {
+  // Tasks that did not finish are destroyed with everything they await
+  m_frames = nullptr;
+  m_lock_waiters = nullptr;
+  m_granted = nullptr;
+  while (m_tasks != nullptr) {
+    task::promise_type *promise = m_tasks;
+    m_tasks = promise->next;
+    task::handle_type::from_promise(*promise).destroy();
+  }
+}
+
+prism_err scheduler::spawn(task &&t) noexcept {
+  if (!t.m_handle) {
+    return PR_ERR_OUT_OF_MEMORY;
+  }
+
+  task::handle_type handle = t.m_handle;
+  t.m_handle = nullptr;
+
+  task::promise_type &promise = handle.promise();
+  promise.owner = this;
+  promise.next = m_tasks;
+  m_tasks = &promise;
+  m_running++;
+
+  handle.resume(); // Runs until the first frame is awaited
+  return PR_OK;
+}
+
+void scheduler::finished(task::handle_type handle) noexcept {
+  task::promise_type *promise = &handle.promise();
+  for (task::promise_type **link = &m_tasks; *link != nullptr;
+       link = &(*link)->next) {
+    if (*link == promise) {
+      *link = promise->next;
+      break;
+    }
+  }
+  m_running--;
+  handle.destroy();
+}
+
+bool scheduler::device_busy(const prdev_t *device) const noexcept {
+  for (const frame_awaiter *f = m_frames; f != nullptr; f = f->m_next) {
+    if (f->m_submitted && f->m_device == device) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void scheduler::submit(frame_awaiter *frame) noexcept {
+  if (frame->m_has_imm) {
+    frame->m_err = prism_submit_opcode_imm(
+        frame->m_device, frame->m_op, frame->m_type, frame->m_arg,
+        frame->m_imm, frame->m_timeout, &frame->m_pending);
+  } else {
+    frame->m_err =
+        prism_submit_opcode(frame->m_device, frame->m_op, frame->m_type,
+                            frame->m_arg, frame->m_timeout, &frame->m_pending);
+  }
+  frame->m_submitted = (frame->m_err == PR_OK);
+}
+
+void scheduler::enqueue(frame_awaiter *frame) noexcept {
+  // Appended, so frames of one device are sent in the order they were awaited
+  frame->m_next = nullptr;
+  frame_awaiter **link = &m_frames;
+  while (*link != nullptr) {
+    link = &(*link)->m_next;
+  }
+  *link = frame;
+}
+
+bool scheduler::poll() noexcept {
+  // Coroutines that were handed a device lock
+  while (m_granted != nullptr) {
+    lock_awaiter *waiter = m_granted;
+    m_granted = waiter->m_next;
+    waiter->m_handle.resume();
+  }
+
+  frame_awaiter **link = &m_frames;
+  while (*link != nullptr) {
+    frame_awaiter *frame = *link;
+    bool done = false;
+
+    if (!frame->m_submitted) {
+      if (device_busy(frame->m_device)) {
+        link = &frame->m_next;
+        continue;
+      }
+      submit(frame);
+      done = (frame->m_err != PR_OK);
+    }
+    if (frame->m_submitted) {
+      frame->m_err = prism_poll(&frame->m_pending, &done);
+    }
+    if (!done) {
+      link = &frame->m_next;
+      continue;
+    }
+
+    // Unlink before resuming, the coroutine may await its next frame at once
+    // or finish and free the awaiter
+    *link = frame->m_next;
+    frame->m_submitted = false;
+    frame->m_handle.resume();
+  }
+
+  return m_running != 0;
+}
+
+void scheduler::run() noexcept {
+  while (poll()) {
+  }
+}
+
+frame_awaiter scheduler::opcode(const prdev_t *device, const uint16_t op,
+                                const ui8 type, const ui8 arg) noexcept {
+  return frame_awaiter(*this, device, op, type, arg, 0, false, m_timeout);
+}
+
+frame_awaiter scheduler::opcode_imm(const prdev_t *device, const uint16_t op,
+                                    const ui8 type, const ui8 arg,
+                                    const ui32 imm) noexcept {
+  return frame_awaiter(*this, device, op, type, arg, imm, true, m_timeout);
+}
+
+frame_awaiter scheduler::op(const prdev_t *device, const uint16_t op,
+                            const ui8 type, const ui8 lanes,
+                            const ui32 arg) noexcept {
+  // The frame prism_op would send
+  ui8 frame_arg = 0;
+  bool has_imm = false;
+  if (_prism_op_arg(op, type, lanes, arg, &frame_arg, &has_imm) != PR_OK) {
+    return frame_awaiter(*this, 0, op, type, 0, 0, false, m_timeout);
+  }
+  return frame_awaiter(*this, device, op, type, frame_arg, arg, has_imm,
+                       m_timeout);
+}
+
+task scheduler::store(const prdev_t *device, const bank_t bank,
+                      const ui32 *src) {
+  if (device == 0 || device->transport == 0 || src == 0) {
+    co_return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank != PRISM_BANK_A && bank != PRISM_BANK_B) {
+    co_return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_err err = PR_OK;
+  uint8_t attempt = 0;
+  do {
+    err = co_await opcode(device, _prism_store_opcode(bank),
+                          PRISM_OPCODE_TYPE_UI32, 255);
+    if (err != PR_OK) {
+      co_return err;
+    }
+
+    err = _prism_write_bank_data(device, src, false);
+    prism_err end =
+        co_await opcode(device, PRISM_OPCODE_END, PRISM_OPCODE_TYPE_UI8, 255);
+    if (err == PR_OK) {
+      err = end; // PR_ERR_LINK if the device saw a damaged block
+    }
+  } while (_prism_link_retry(device, err, attempt++));
+  co_return err;
+}
+
+task scheduler::load(const prdev_t *device, const bank_t bank, ui32 *out) {
+  if (device == 0 || device->transport == 0 || out == 0) {
+    co_return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank >= PRISM_BANK_MAX) {
+    co_return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_err err = PR_OK;
+  uint8_t attempt = 0;
+  do {
+    err = co_await opcode(device, _prism_load_opcode(bank),
+                          PRISM_OPCODE_TYPE_UI8, 255);
+    if (err != PR_OK) {
+      co_return err;
+    }
+
+    err = _prism_read_bank_data(device, out);
+    prism_err end =
+        co_await opcode(device, PRISM_OPCODE_END, PRISM_OPCODE_TYPE_UI32, 255);
+    if (err == PR_OK) {
+      err = end;
+    }
+  } while (_prism_link_retry(device, err, attempt++));
+  co_return err;
+}
+
+lock_awaiter scheduler::lock(const prdev_t *device) noexcept {
+  return lock_awaiter(*this, device);
+}
+
+bool scheduler::try_lock(const prdev_t *device) noexcept {
+  for (uint8_t i = 0; i < PRISM_CORO_MAX_DEVICES; i++) {
+    if (m_locked[i] == device) {
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < PRISM_CORO_MAX_DEVICES; i++) {
+    if (m_locked[i] == 0) {
+      m_locked[i] = device;
+      return true;
+    }
+  }
+  return false; // Table full, wait for a device to be released
+}
+
+void scheduler::wait_lock(lock_awaiter *waiter) noexcept {
+  waiter->m_next = nullptr;
+  lock_awaiter **link = &m_lock_waiters;
+  while (*link != nullptr) {
+    link = &(*link)->m_next;
+  }
+  *link = waiter;
+}
+
+void scheduler::unlock(const prdev_t *device) noexcept {
+  for (uint8_t i = 0; i < PRISM_CORO_MAX_DEVICES; i++) {
+    if (m_locked[i] == device) {
+      m_locked[i] = 0;
+    }
+  }
+
+  // Hand the lock to the first waiter that can take it, resumed by poll()
+  for (lock_awaiter **link = &m_lock_waiters; *link != nullptr;
+       link = &(*link)->m_next) {
+    lock_awaiter *waiter = *link;
+    if (try_lock(waiter->m_device)) {
+      *link = waiter->m_next;
+
+      waiter->m_next = nullptr;
+      lock_awaiter **tail = &m_granted;
+      while (*tail != nullptr) {
+        tail = &(*tail)->m_next;
+      }
+      *tail = waiter;
+      return;
+    }
+  }
+}
+
+} // namespace prism
+
+#endif // PRISM_ENABLE_COROUTINES == 1
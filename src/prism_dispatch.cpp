@@ -0,0 +1,223 @@
+#include "prism/prism_dispatch.h"
+
+#include "Arduino.h"
+
+// Initial guess for the host cost before the first measurement
+#define PRISM_COST_HOST_NS_DEFAULT 2000
+// Lanes and rounds timed per operation while seeding the host cost
+#define PRISM_COST_HOST_PROBE_LANES 16
+#define PRISM_COST_HOST_PROBE_ROUNDS 16
+// Weight of the previous value in the moving average (out of 4)
+#define PRISM_COST_EWMA_KEEP 3
+
+static ui32 __prism_host_op(const uint16_t op, const ui8 type, const ui32 a,
+                            const ui32 b) {
+  const bool is_signed = (type == PRISM_OPCODE_TYPE_SI32);
+
+  switch (op) {
+  case PRISM_OPCODE_ADD_N:
+    return a + b;
+  case PRISM_OPCODE_SUB_N:
+    return a - b;
+  case PRISM_OPCODE_MUL_N:
+    return is_signed ? (ui32)((si32)a * (si32)b) : a * b;
+  case PRISM_OPCODE_DIV_N:
+    if (b == 0) {
+      return 0; // Division by zero yields zero, like the device
+    }
+    return is_signed ? (ui32)((si32)a / (si32)b) : a / b;
+  case PRISM_OPCODE_AND_N:
+    return a & b;
+  case PRISM_OPCODE_NAND_N:
+    return ~(a & b);
+  case PRISM_OPCODE_OR_N:
+    return a | b;
+  case PRISM_OPCODE_XOR_N:
+    return a ^ b;
+  case PRISM_OPCODE_NOR_N:
+    return ~(a | b);
+  default:
+    return 0;
+  }
+}
+
+static void __prism_host_run(const uint16_t op, const ui8 type, const ui32 *a,
+                             const ui32 *b, ui32 *out, const size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = __prism_host_op(op, type, a[i], b[i]);
+  }
+}
+
+static prism_err __prism_device_run(const prdev_t *dev, const uint16_t op,
+                                    const ui8 type, const ui32 *a,
+                                    const ui32 *b, ui32 *out, const size_t n,
+                                    timeout_t timeout) {
+  prism_err err = _prism_send_bank_ptr(dev, &a[0], PRISM_BANK_A, timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+
+  for (size_t i = 0; i < n; i += 8) {
+    err = _prism_send_bank_ptr(dev, &b[i], PRISM_BANK_B, timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+    err = prism_op(dev, op, type, 8, 0, timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+
+    if (i + 8 < n) {
+      // Download this result while the next operand goes up, a single
+      // transfer on full-duplex links
+      err = _prism_exchange_bank_ptr(dev, PRISM_BANK_C, &out[i], PRISM_BANK_A,
+                                     &a[i + 8], timeout);
+    } else {
+      err = _prism_load_bank_ptr(dev, PRISM_BANK_C, &out[i], timeout);
+    }
+    if (err != PR_OK) {
+      return err;
+    }
+  }
+  return PR_OK;
+}
+
+static inline ui32 __prism_ewma(const ui32 old_value, const ui32 sample) {
+  return (ui32)(((uint64_t)old_value * PRISM_COST_EWMA_KEEP + sample) /
+                (PRISM_COST_EWMA_KEEP + 1));
+}
+
+static inline bool __prism_cost_op_valid(const uint16_t op) {
+  return op >= PRISM_OPCODE_ADD_N && op <= PRISM_OPCODE_NOR_N;
+}
+
+prism_err prism_cost_model_init(const prdev_t *dev, prism_cost_model_t *model,
+                                timeout_t timeout) {
+  if (dev == 0 || model == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // 1. Latency of a single command frame: best of three flank reads
+  ui32 latency = UINT32_MAX;
+  for (uint8_t i = 0; i < 3; i++) {
+    unsigned long start = micros();
+    _prism_arch_get_variable(dev, PRISM_OPCODE_ARCH_GET_FLANK);
+    ui32 took = (ui32)(micros() - start);
+    if (took < latency) {
+      latency = took;
+    }
+  }
+  model->link_latency_us = latency;
+
+  // 2. P²Link throughput: a bank D download is two frames plus 32 bytes
+  _v256i probe;
+  unsigned long start = micros();
+  prism_err err = _prism_load_bank_x(dev, PRISM_BANK_D, &probe, timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+  ui32 took = (ui32)(micros() - start);
+  ui32 payload_us = took > 2 * latency ? took - 2 * latency : 1;
+  model->link_bytes_per_s =
+      (ui32)(((uint64_t)sizeof(_v256i) * 1000000UL) / payload_us);
+
+  model->block_us =
+      PRISM_COST_FRAMES_PER_BLOCK * latency +
+      (ui32)(((uint64_t)PRISM_COST_BYTES_PER_BLOCK * 1000000UL) /
+             (model->link_bytes_per_s ? model->link_bytes_per_s : 1));
+
+  // 3. Host cost of every tracked operation
+  ui32 lhs[PRISM_COST_HOST_PROBE_LANES];
+  ui32 rhs[PRISM_COST_HOST_PROBE_LANES];
+  for (size_t i = 0; i < PRISM_COST_HOST_PROBE_LANES; i++) {
+    lhs[i] = (ui32)(i * 2654435761UL);
+    rhs[i] = (ui32)(i | 1);
+  }
+  for (uint16_t op = PRISM_OPCODE_ADD_N; op <= PRISM_OPCODE_NOR_N; op++) {
+    start = micros();
+    for (uint8_t r = 0; r < PRISM_COST_HOST_PROBE_ROUNDS; r++) {
+      __prism_host_run(op, PRISM_OPCODE_TYPE_UI32, lhs, rhs, lhs,
+                       PRISM_COST_HOST_PROBE_LANES);
+    }
+    took = (ui32)(micros() - start);
+    ui32 ns = (ui32)(((uint64_t)took * 1000UL) /
+                     (PRISM_COST_HOST_PROBE_LANES *
+                      PRISM_COST_HOST_PROBE_ROUNDS));
+    model->host_ns_per_lane[op - PRISM_OPCODE_ADD_N] =
+        ns ? ns : PRISM_COST_HOST_NS_DEFAULT;
+  }
+
+  return PR_OK;
+}
+
+prism_exec_t prism_cost_decide(const prism_cost_model_t *model,
+                               const uint16_t op, const size_t n,
+                               size_t *device_lanes) {
+  size_t lanes = 0;
+  prism_exec_t exec = PRISM_EXEC_HOST;
+
+  if (model != 0 && __prism_cost_op_valid(op) && n >= 8) {
+    const uint64_t host_block_ns =
+        (uint64_t)model->host_ns_per_lane[op - PRISM_OPCODE_ADD_N] * 8;
+    const uint64_t device_block_ns = (uint64_t)model->block_us * 1000UL;
+
+    if (device_block_ns < host_block_ns) {
+      // Full blocks go to the device, a ragged tail stays on the host
+      // because a partial block costs as much as a full one on the link.
+      lanes = n & ~(size_t)7;
+      exec = (lanes == n) ? PRISM_EXEC_DEVICE : PRISM_EXEC_SPLIT;
+    }
+  }
+
+  if (device_lanes != 0) {
+    *device_lanes = lanes;
+  }
+  return exec;
+}
+
+prism_err prism_stream_op(const prdev_t *dev, prism_cost_model_t *model,
+                          const uint16_t op, const ui8 type, const ui32 *a,
+                          const ui32 *b, ui32 *out, const size_t n,
+                          timeout_t timeout) {
+  if (dev == 0 || model == 0 || a == 0 || b == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_cost_op_valid(op)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (type != PRISM_OPCODE_TYPE_UI32 && type != PRISM_OPCODE_TYPE_SI32) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  size_t device_lanes = 0;
+  if (prism_device_supports(dev, op, type)) {
+    prism_cost_decide(model, op, n, &device_lanes);
+  }
+
+  if (device_lanes != 0) {
+    unsigned long start = micros();
+    prism_err err =
+        __prism_device_run(dev, op, type, a, b, out, device_lanes, timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+    ui32 took = (ui32)(micros() - start);
+    model->block_us = __prism_ewma(model->block_us, took / (device_lanes / 8));
+  }
+
+  const size_t host_lanes = n - device_lanes;
+  if (host_lanes != 0) {
+    unsigned long start = micros();
+    __prism_host_run(op, type, &a[device_lanes], &b[device_lanes],
+                     &out[device_lanes], host_lanes);
+    ui32 took = (ui32)(micros() - start);
+    // Below 32 lanes the micros() resolution is too coarse to learn from
+    if (host_lanes >= 32) {
+      ui32 *host_ns = &model->host_ns_per_lane[op - PRISM_OPCODE_ADD_N];
+      *host_ns = __prism_ewma(
+          *host_ns, (ui32)(((uint64_t)took * 1000UL) / host_lanes));
+    }
+  }
+
+  return PR_OK;
+}
@@ -0,0 +1,320 @@
+#include "prism/prism_dsp.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+static inline si32 __prism_dsp_saturate(const int64_t value) {
+  if (value > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (value < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (si32)value;
+}
+
+// Rounds to nearest and removes q fraction bits
+static inline si32 __prism_dsp_rescale(int64_t value, const ui8 q) {
+  if (q > 0) {
+    value += (int64_t)1 << (q - 1);
+    value >>= q;
+  }
+  return __prism_dsp_saturate(value);
+}
+
+static inline int64_t __prism_dsp_fold(const _v256i *v) {
+  int64_t sum = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    sum += v->si[i];
+  }
+  return sum;
+}
+
+prism_err prism_fir_init(prism_fir_t *fir, const prdev_t *dev, const si32 *h,
+                         const ui8 taps, const ui8 q, ui32 timeout) {
+  if (fir == 0 || dev == 0 || h == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (taps < 1 || taps > PRISM_FIR_MAX_TAPS || q > 31) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  fir->device = dev;
+  fir->timeout = timeout;
+  fir->taps = taps;
+  fir->blocks = (taps + 7) / 8;
+  fir->q = q;
+
+  // Lane l of block j meets sample x[n - 8 * j - 7 + l], so the coefficients
+  // are stored reversed within every block and the windows stay contiguous
+  memset(fir->coeff, 0, sizeof(fir->coeff));
+  for (uint8_t k = 0; k < taps; k++) {
+    fir->coeff[(k & ~7) + 7 - (k & 7)] = h[k];
+  }
+
+  prism_fir_reset(fir);
+  return PR_OK;
+}
+
+void prism_fir_reset(prism_fir_t *fir) {
+  if (fir == 0) {
+    return;
+  }
+  memset(fir->line, 0, sizeof(fir->line));
+}
+
+// Filters the m samples at line[PRISM_FIR_HISTORY]. Bank B holds one
+// coefficient vector, bank A the window of the current output; the products
+// come down while the next window goes up.
+static prism_err __prism_fir_chunk(prism_fir_t *fir, const size_t m,
+                                   si32 *out) {
+  const prdev_t *dev = fir->device;
+  int64_t acc[PRISM_FIR_CHUNK];
+  _v256i prod;
+
+  memset(acc, 0, sizeof(acc));
+  for (uint8_t j = 0; j < fir->blocks; j++) {
+    const si32 *window = &fir->line[PRISM_FIR_HISTORY - 8 * j - 7];
+
+    PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)&fir->coeff[8 * j],
+                                   PRISM_BANK_B, fir->timeout));
+    PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)window, PRISM_BANK_A,
+                                   fir->timeout));
+
+    for (size_t i = 0; i < m; i++) {
+      PRISM_TRY(prism_op(dev, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_SI32, 8, 0,
+                         fir->timeout));
+      if (i + 1 < m) {
+        PRISM_TRY(_prism_exchange_bank_ptr(dev, PRISM_BANK_C, prod.ui,
+                                           PRISM_BANK_A,
+                                           (const ui32 *)&window[i + 1],
+                                           fir->timeout));
+      } else {
+        PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, prod.ui,
+                                       fir->timeout));
+      }
+      acc[i] += __prism_dsp_fold(&prod);
+    }
+  }
+
+  for (size_t i = 0; i < m; i++) {
+    out[i] = __prism_dsp_rescale(acc[i], fir->q);
+  }
+  return PR_OK;
+}
+
+prism_err prism_fir_process(prism_fir_t *fir, const si32 *in, si32 *out,
+                            const size_t n) {
+  if (fir == 0 || fir->device == 0 || in == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // Bank B keeps the coefficients across the MUL operations
+  PRISM_TRY(_v256_set_ncaop(fir->device, fir->timeout));
+
+  prism_err err = PR_OK;
+  size_t m = 0;
+  for (size_t done = 0; err == PR_OK && done < n; done += m) {
+    m = n - done;
+    if (m > PRISM_FIR_CHUNK) {
+      m = PRISM_FIR_CHUNK;
+    }
+
+    // The chunk is copied before out is written, so out may alias in
+    memcpy(&fir->line[PRISM_FIR_HISTORY], &in[done], m * sizeof(si32));
+    err = __prism_fir_chunk(fir, m, &out[done]);
+    memmove(fir->line, &fir->line[m], PRISM_FIR_HISTORY * sizeof(si32));
+  }
+
+  prism_err restore = _v256_set_caop(fir->device, fir->timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+prism_err prism_dot_si32(const prdev_t *dev, const si32 *a, const si32 *b,
+                         const size_t n, int64_t *result, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || result == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  int64_t sum = 0;
+  size_t i = 0;
+  _v256i prod;
+
+  if (n >= 8) {
+    PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)a, PRISM_BANK_A,
+                                   timeout));
+  }
+  for (; i + 8 <= n; i += 8) {
+    PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)&b[i], PRISM_BANK_B,
+                                   timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_SI32, 8, 0,
+                       timeout));
+    if (i + 16 <= n) {
+      PRISM_TRY(_prism_exchange_bank_ptr(dev, PRISM_BANK_C, prod.ui,
+                                         PRISM_BANK_A,
+                                         (const ui32 *)&a[i + 8], timeout));
+    } else {
+      PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, prod.ui, timeout));
+    }
+    sum += __prism_dsp_fold(&prod);
+  }
+
+  // Ragged tail on the host
+  for (; i < n; i++) {
+    sum += (int64_t)a[i] * b[i];
+  }
+
+  *result = sum;
+  return PR_OK;
+}
+
+prism_err prism_mac_reset(prism_mac_t *ctx, const ui32 init) {
+  if (ctx == 0 || ctx->device == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const prdev_t *dev = ctx->device;
+
+  // Afterwards banks B and C both hold the accumulator, which every MAC step
+  // keeps true
+  PRISM_TRY(_v256_splat_bank_v(dev, PRISM_BANK_A, ctx->type, init,
+                               ctx->timeout));
+  PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_ADD_S, ctx->type, 8, 0,
+                             ctx->timeout));
+  PRISM_TRY(_v256_store_ctob(dev, ctx->timeout));
+  ctx->count = 0;
+  return PR_OK;
+}
+
+prism_err prism_mac_begin(prism_mac_t *ctx, const prdev_t *dev, const ui8 type,
+                          const ui32 init, ui32 timeout) {
+  if (ctx == 0 || dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (type != PRISM_OPCODE_TYPE_UI32 && type != PRISM_OPCODE_TYPE_SI32) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  ctx->device = dev;
+  ctx->type = type;
+  ctx->count = 0;
+  ctx->timeout = timeout;
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = prism_mac_reset(ctx, init);
+  if (err != PR_OK) {
+    _v256_set_caop(dev, timeout);
+  }
+  return err;
+}
+
+prism_err prism_mac_push(prism_mac_t *ctx, const ui32 *x, const ui32 s) {
+  if (ctx == 0 || ctx->device == 0 || x == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const prdev_t *dev = ctx->device;
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, x, PRISM_BANK_A, ctx->timeout));
+  if (s != 1) {
+    PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_MUL_S, ctx->type, 8, s,
+                               ctx->timeout));
+    PRISM_TRY(_v256_store_ctoa(dev, ctx->timeout));
+  }
+  PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, ctx->type, 8, 0, ctx->timeout));
+  PRISM_TRY(_v256_store_ctob(dev, ctx->timeout));
+
+  ctx->count++;
+  return PR_OK;
+}
+
+prism_err prism_mac_apply(prism_mac_t *ctx, const uint16_t op,
+                          const ui32 imm) {
+  if (ctx == 0 || ctx->device == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (op < PRISM_OPCODE_ADD_S || op > PRISM_OPCODE_DIV_S) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const prdev_t *dev = ctx->device;
+
+  PRISM_TRY(_v256_store_ctoa(dev, ctx->timeout));
+  PRISM_TRY(_v256_opN_scalar(dev, op, ctx->type, 8, imm, ctx->timeout));
+  return _v256_store_ctob(dev, ctx->timeout);
+}
+
+prism_err prism_mac_read(prism_mac_t *ctx, ui32 *acc) {
+  if (ctx == 0 || ctx->device == 0 || acc == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return _prism_load_bank_ptr(ctx->device, PRISM_BANK_C, acc, ctx->timeout);
+}
+
+prism_err prism_mac_end(prism_mac_t *ctx, ui32 *acc) {
+  if (ctx == 0 || ctx->device == 0 || acc == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_err err =
+      _prism_load_bank_ptr(ctx->device, PRISM_BANK_C, acc, ctx->timeout);
+  prism_err restore = _v256_set_caop(ctx->device, ctx->timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+// Eight averages starting at x: the window shifted by k is added for every k
+static prism_err __prism_moving_average_block(prism_mac_t *mac, const si32 *x,
+                                              const ui8 window, si32 *out) {
+  PRISM_TRY(prism_mac_reset(mac, 0));
+  for (uint8_t k = 0; k < window; k++) {
+    PRISM_TRY(prism_mac_push(mac, (const ui32 *)&x[k], 1));
+  }
+  if (window > 1) {
+    PRISM_TRY(prism_mac_apply(mac, PRISM_OPCODE_DIV_S, window));
+  }
+  return prism_mac_read(mac, (ui32 *)out);
+}
+
+prism_err prism_moving_average_si32(const prdev_t *dev, const si32 *x,
+                                    const size_t n, const ui8 window,
+                                    si32 *out, ui32 timeout) {
+  if (dev == 0 || x == 0 || out == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (window < 1 || n < window) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const size_t outputs = n - window + 1;
+  size_t i = 0;
+
+  if (outputs >= 8) {
+    prism_mac_t mac;
+    mac.device = dev;
+    mac.type = PRISM_OPCODE_TYPE_SI32;
+    mac.count = 0;
+    mac.timeout = timeout;
+
+    PRISM_TRY(_v256_set_ncaop(dev, timeout));
+    prism_err err = PR_OK;
+    for (; err == PR_OK && i + 8 <= outputs; i += 8) {
+      err = __prism_moving_average_block(&mac, &x[i], window, &out[i]);
+    }
+    prism_err restore = _v256_set_caop(dev, timeout);
+    if (err != PR_OK) {
+      return err;
+    }
+    PRISM_TRY(restore);
+  }
+
+  // Ragged tail on the host, with the same truncating division
+  for (; i < outputs; i++) {
+    si32 sum = 0;
+    for (uint8_t k = 0; k < window; k++) {
+      sum = (si32)((ui32)sum + (ui32)x[i + k]);
+    }
+    out[i] = sum / (si32)window;
+  }
+  return PR_OK;
+}
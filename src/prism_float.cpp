@@ -0,0 +1,93 @@
+#include "prism/prism_float.h"
+
+#ifdef PRISM_ENABLE_IEE754
+
+// Integer-only conversions, the host may have no FPU
+ui16 prism_half_from_float(const float x) {
+  const ui32 bits = _prism_fl_bits(x);
+  const ui16 sign = (ui16)((bits >> 16) & 0x8000);
+  const si16 exp = (si16)((bits >> 23) & 0xFF);
+  ui32 man = bits & 0x7FFFFFUL;
+
+  if (exp == 0xFF) {
+    // Infinity stays infinity, NaN stays a (quiet) NaN
+    return sign | 0x7C00 | ((man != 0) ? (0x200 | (man >> 13)) : 0);
+  }
+
+  const si16 e = exp - 127 + 15;
+  if (e >= 31) {
+    return sign | 0x7C00;
+  }
+  if (e <= 0) {
+    // Below half of the smallest subnormal everything rounds to zero
+    if (e < -10) {
+      return sign;
+    }
+    man |= 0x800000UL;
+    const ui8 shift = (ui8)(14 - e);
+    const ui32 half = 1UL << (shift - 1);
+    const ui32 rem = man & ((1UL << shift) - 1);
+    ui16 h = (ui16)(man >> shift);
+    if (rem > half || (rem == half && (h & 1))) {
+      h++;
+    }
+    return sign | h;
+  }
+
+  // A carry out of the mantissa moves into the exponent, up to infinity
+  ui16 h = (ui16)(((ui16)e << 10) | (man >> 13));
+  const ui32 rem = man & 0x1FFF;
+  if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) {
+    h++;
+  }
+  return sign | h;
+}
+
+float prism_half_to_float(const ui16 h) {
+  const ui32 sign = (ui32)(h & 0x8000) << 16;
+  si16 exp = (h >> 10) & 0x1F;
+  ui32 man = h & 0x3FF;
+  ui32 bits;
+
+  if (exp == 0x1F) {
+    bits = sign | 0x7F800000UL | (man << 13);
+  } else if (exp == 0) {
+    if (man == 0) {
+      bits = sign;
+    } else {
+      // Subnormal halves are normal floats
+      exp = 1;
+      while ((man & 0x400) == 0) {
+        man <<= 1;
+        exp--;
+      }
+      bits = sign | ((ui32)(exp + 112) << 23) | ((man & 0x3FF) << 13);
+    }
+  } else {
+    bits = sign | ((ui32)(exp + 112) << 23) | (man << 13);
+  }
+
+  float x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+void prism_half_from_float_n(const float *src, ui16 *dst, const size_t n) {
+  if (src == 0 || dst == 0) {
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = prism_half_from_float(src[i]);
+  }
+}
+
+void prism_half_to_float_n(const ui16 *src, float *dst, const size_t n) {
+  if (src == 0 || dst == 0) {
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = prism_half_to_float(src[i]);
+  }
+}
+
+#endif // PRISM_ENABLE_IEE754
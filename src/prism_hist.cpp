@@ -0,0 +1,213 @@
+#include "prism/prism_hist.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+// One resident group of bins and the samples counted into it
+typedef struct prism_hist_group {
+  prism_hist_t *hist;
+  ui16 first;   // First bin of the group
+  ui8 size;     // Bins in the group
+  ui8 lanes;    // Bins per vector
+  ui8 op_type;  // Lane type of the device vector
+  ui8 shift;    // Position of the edge in a lane
+  ui32 max;     // Largest count of a lane
+  ui32 pending; // Samples counted since the last upload
+  _v256i edges; // The edges over zero counts
+} prism_hist_group_t;
+
+static inline ui32 __prism_hist_sample(const prism_hist_t *hist,
+                                       const void *samples, const size_t i) {
+  if (hist->type == PRISM_OPCODE_TYPE_UI8) {
+    return ((const ui8 *)samples)[i];
+  }
+  return ((const ui16 *)samples)[i];
+}
+
+// Adds the cumulative counts of the device vector to the bins
+static prism_err __prism_hist_flush(prism_hist_group_t *g) {
+  if (g->pending == 0) {
+    return PR_OK;
+  }
+
+  prism_hist_t *hist = g->hist;
+  _v256i acc;
+  PRISM_TRY(
+      _prism_load_bank_ptr(hist->device, PRISM_BANK_C, acc.ui, hist->timeout));
+
+  ui32 above = 0;
+  for (ui8 j = g->size; j-- > 0;) {
+    const ui32 lane = (g->lanes == 16) ? acc.uix[j] : acc.ui[j];
+    const ui32 cum = lane & g->max;
+    hist->counts[g->first + j] += cum - above;
+    above = cum;
+  }
+  g->pending = 0;
+  return PR_OK;
+}
+
+// Counts the samples in [lo, last] from i on into the group. Expects
+// no-clear-after-op mode, the vector stays in bank A.
+static prism_err __prism_hist_group_run(prism_hist_group_t *g,
+                                        const void *samples, size_t i,
+                                        const size_t n, const ui32 lo,
+                                        const ui32 last) {
+  prism_hist_t *hist = g->hist;
+  const prdev_t *dev = hist->device;
+  const ui32 t = hist->timeout;
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, g->edges.ui, PRISM_BANK_A, t));
+
+  while (i < n) {
+    const ui32 s = __prism_hist_sample(hist, samples, i);
+    if (s < lo || s > last) {
+      i++;
+      continue;
+    }
+
+    ui32 run = 1;
+    while (i + run < n && run < g->max &&
+           __prism_hist_sample(hist, samples, i + run) == s) {
+      run++;
+    }
+    if (g->pending + run > g->max) {
+      PRISM_TRY(__prism_hist_flush(g));
+      PRISM_TRY(_prism_send_bank_ptr(dev, g->edges.ui, PRISM_BANK_A, t));
+    }
+
+    // B = mask of the bins whose edge is not above s, added once per sample
+    PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_CMP_LE_S, g->op_type, 8,
+                               (s << g->shift) | g->max, t));
+    PRISM_TRY(_v256_store_ctob(dev, t));
+    for (ui32 r = 0; r < run; r++) {
+      PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, g->op_type, 8, 0, t));
+      PRISM_TRY(_v256_store_ctoa(dev, t));
+    }
+    g->pending += run;
+    i += run;
+  }
+  return __prism_hist_flush(g);
+}
+
+static prism_err __prism_hist_add(prism_hist_t *hist, const void *samples,
+                                  const size_t n) {
+  prism_hist_group_t g;
+  g.hist = hist;
+  g.pending = 0;
+  if (hist->type == PRISM_OPCODE_TYPE_UI8) {
+    g.lanes = 16;
+    g.op_type = PRISM_OPCODE_TYPE_UI16;
+    g.shift = 8;
+    g.max = 0xFF;
+  } else {
+    g.lanes = 8;
+    g.op_type = PRISM_OPCODE_TYPE_UI32;
+    g.shift = 16;
+    g.max = 0xFFFF;
+  }
+
+  for (g.first = 0; g.first < hist->bins; g.first += g.lanes) {
+    const ui16 left = hist->bins - g.first;
+    g.size = (left < g.lanes) ? (ui8)left : g.lanes;
+    const ui32 lo = hist->edges[g.first];
+    // The largest sample of the type is the largest count of a lane
+    const ui32 last = (g.first + g.size < hist->bins)
+                          ? (ui32)hist->edges[g.first + g.size] - 1
+                          : g.max;
+
+    // Groups without a sample are never sent
+    size_t i = 0;
+    while (i < n) {
+      const ui32 s = __prism_hist_sample(hist, samples, i);
+      if (s >= lo && s <= last) {
+        break;
+      }
+      i++;
+    }
+    if (i == n) {
+      continue;
+    }
+
+    // Unused lanes get the largest edge, they are never read back
+    for (ui8 j = 0; j < g.lanes; j++) {
+      const ui32 edge = (j < g.size) ? hist->edges[g.first + j] : g.max;
+      const ui32 lane = edge << g.shift;
+      if (g.lanes == 16) {
+        g.edges.uix[j] = (ui16)lane;
+      } else {
+        g.edges.ui[j] = lane;
+      }
+    }
+    PRISM_TRY(__prism_hist_group_run(&g, samples, i, n, lo, last));
+  }
+  return PR_OK;
+}
+
+prism_err prism_hist_init(prism_hist_t *hist, const prdev_t *dev,
+                          const ui8 type, const ui16 *edges, const ui16 bins,
+                          ui32 *counts, ui32 timeout) {
+  if (hist == 0 || dev == 0 || edges == 0 || counts == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (type != PRISM_OPCODE_TYPE_UI8 && type != PRISM_OPCODE_TYPE_UI16) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bins == 0 || bins > PRISM_HIST_MAX_BINS) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  for (ui16 j = 0; j < bins; j++) {
+    if (type == PRISM_OPCODE_TYPE_UI8 && edges[j] > 0xFF) {
+      return PR_ERR_INVALID_ARGUMENT;
+    }
+    if (j != 0 && edges[j] <= edges[j - 1]) {
+      return PR_ERR_INVALID_ARGUMENT;
+    }
+  }
+
+  hist->device = dev;
+  hist->edges = edges;
+  hist->counts = counts;
+  hist->bins = bins;
+  hist->type = type;
+  hist->timeout = timeout;
+  prism_hist_reset(hist);
+  return PR_OK;
+}
+
+void prism_hist_edges_uniform(ui16 *edges, const ui16 bins, const ui16 lo,
+                              const ui16 width) {
+  if (edges == 0) {
+    return;
+  }
+  for (ui16 j = 0; j < bins; j++) {
+    edges[j] = (ui16)(lo + (ui32)j * width);
+  }
+}
+
+void prism_hist_reset(prism_hist_t *hist) {
+  if (hist == 0 || hist->counts == 0) {
+    return;
+  }
+  memset(hist->counts, 0, hist->bins * sizeof(ui32));
+  hist->below = 0;
+}
+
+prism_err prism_hist_add(prism_hist_t *hist, const void *samples,
+                         const size_t n) {
+  if (hist == 0 || (samples == 0 && n != 0)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (__prism_hist_sample(hist, samples, i) < hist->edges[0]) {
+      hist->below++;
+    }
+  }
+
+  // The counters need bank A after every compare
+  PRISM_TRY(_v256_set_ncaop(hist->device, hist->timeout));
+  prism_err err = __prism_hist_add(hist, samples, n);
+  prism_err restore = _v256_set_caop(hist->device, hist->timeout);
+  return (err != PR_OK) ? err : restore;
+}
@@ -0,0 +1,449 @@
+#include "prism/prism_image.h"
+
+#include "Arduino.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+// Row sums add two pixels per 16-bit lane and block, so a lane overflows
+// after 128 blocks of 255
+#define __PRISM_IMAGE_SUM_BLOCKS 128
+
+typedef struct prism_image_run prism_image_run_t;
+
+// A kernel: the device sequence for one block and its host reference
+struct prism_image_run {
+  const prdev_t *device;
+  ui32 timeout;
+  const prism_frame_t *a;
+  const prism_frame_t *b; // 0 for kernels with one source
+  const prism_frame_t *out;
+  ui8 block; // Pixels per block, 32 or 16 on 16-bit lanes
+  ui32 param;
+  // Runs the block with bank A loaded, uploads b itself. Leaves the result in
+  // bank C.
+  prism_err (*op)(const prism_image_run_t *run, const ui8 *b);
+  ui8 (*pixel)(const prism_image_run_t *run, const ui8 a, const ui8 b);
+};
+
+static inline ui8 *__prism_image_row(const prism_frame_t *frame,
+                                     const ui16 y) {
+  return frame->pixels + (size_t)y * frame->stride;
+}
+
+static inline prism_err __prism_image_u8(const prdev_t *dev, const uint16_t op,
+                                         ui32 timeout) {
+  return prism_op(dev, op, PRISM_OPCODE_TYPE_UI8, 8, 0, timeout);
+}
+
+static inline prism_err __prism_image_u8_s(const prdev_t *dev,
+                                           const uint16_t op, const ui32 imm,
+                                           ui32 timeout) {
+  return _v256_opN_scalar(dev, op, PRISM_OPCODE_TYPE_UI8, 8, imm, timeout);
+}
+
+static bool __prism_image_frame_valid(const prism_frame_t *frame) {
+  return frame != 0 && frame->pixels != 0 && frame->stride >= frame->width;
+}
+
+static bool __prism_image_same_size(const prism_frame_t *a,
+                                    const prism_frame_t *b) {
+  return a->width == b->width && a->height == b->height;
+}
+
+// Widens 16 pixels to the 16-bit lanes of v
+static void __prism_image_widen(const ui8 *px, _v256i *v) {
+  for (uint8_t i = 0; i < 16; i++) {
+    v->uix[i] = px[i];
+  }
+}
+
+static const ui32 *__prism_image_pack(const prism_image_run_t *run,
+                                      const ui8 *px, _v256i *scratch) {
+  if (run->block == 32) {
+    return (const ui32 *)px; // Bank transfers are byte-wise
+  }
+  __prism_image_widen(px, scratch);
+  return scratch->ui;
+}
+
+static void __prism_image_unpack(const prism_image_run_t *run,
+                                 const _v256i *c, ui8 *px) {
+  if (run->block == 32) {
+    memcpy(px, c->uib, 32);
+    return;
+  }
+  for (uint8_t i = 0; i < 16; i++) {
+    px[i] = (ui8)c->uix[i];
+  }
+}
+
+// Streams every full block of every row, then computes the row tails
+static prism_err __prism_image_stream(const prism_image_run_t *run) {
+  const prdev_t *dev = run->device;
+  const ui16 width = run->a->width;
+  const ui16 height = run->a->height;
+  const ui16 blocks = width / run->block;
+  _v256i upload, c;
+
+  if (blocks != 0 && height != 0) {
+    PRISM_TRY(_prism_send_bank_ptr(
+        dev, __prism_image_pack(run, __prism_image_row(run->a, 0), &upload),
+        PRISM_BANK_A, run->timeout));
+  }
+
+  for (ui16 y = 0; blocks != 0 && y < height; y++) {
+    for (ui16 i = 0; i < blocks; i++) {
+      const size_t x = (size_t)i * run->block;
+      const ui8 *b = run->b ? __prism_image_row(run->b, y) + x : 0;
+      PRISM_TRY(run->op(run, b));
+
+      // The next block is the following one in this row or the first one of
+      // the next row
+      const ui8 *next = 0;
+      if (i + 1 < blocks) {
+        next = __prism_image_row(run->a, y) + x + run->block;
+      } else if (y + 1 < height) {
+        next = __prism_image_row(run->a, y + 1);
+      }
+
+      if (next != 0) {
+        PRISM_TRY(_prism_exchange_bank_ptr(
+            dev, PRISM_BANK_C, c.ui, PRISM_BANK_A,
+            __prism_image_pack(run, next, &upload), run->timeout));
+      } else {
+        PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, c.ui, run->timeout));
+      }
+      __prism_image_unpack(run, &c, __prism_image_row(run->out, y) + x);
+    }
+  }
+
+  for (ui16 y = 0; y < height; y++) {
+    const ui8 *a = __prism_image_row(run->a, y);
+    const ui8 *b = run->b ? __prism_image_row(run->b, y) : 0;
+    ui8 *out = __prism_image_row(run->out, y);
+    for (size_t x = (size_t)blocks * run->block; x < width; x++) {
+      out[x] = run->pixel(run, a[x], b ? b[x] : 0);
+    }
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_image_run(prism_image_run_t *run,
+                                   prism_image_stats_t *stats) {
+  const unsigned long start = micros();
+
+  // The kernels reuse bank A after the first operation
+  PRISM_TRY(_v256_set_ncaop(run->device, run->timeout));
+  prism_err err = __prism_image_stream(run);
+  prism_err restore = _v256_set_caop(run->device, run->timeout);
+  if (err == PR_OK) {
+    err = restore;
+  }
+
+  if (err == PR_OK && stats != 0) {
+    stats->frames++;
+    stats->micros += (ui32)(micros() - start);
+  }
+  return err;
+}
+
+// s = a + k in bank B. The lanes that wrapped (a > s) get the mask
+// -(a > s) = 255 and are forced to 255 by s | mask.
+static prism_err __prism_image_add_op(const prism_image_run_t *run,
+                                      const ui8 *b) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+  (void)b;
+
+  PRISM_TRY(__prism_image_u8_s(dev, PRISM_OPCODE_ADD_S, run->param, t));
+  PRISM_TRY(_v256_store_ctob(dev, t));
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_CMP_GT, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_CPL2, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  return __prism_image_u8(dev, PRISM_OPCODE_OR_N, t);
+}
+
+// s = a - k in bank B. The lanes that did not wrap (a >= s) get the mask
+// -(a >= s) = 255, the others are forced to 0 by s & mask.
+static prism_err __prism_image_sub_op(const prism_image_run_t *run,
+                                      const ui8 *b) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+  (void)b;
+
+  PRISM_TRY(__prism_image_u8_s(dev, PRISM_OPCODE_SUB_S, run->param, t));
+  PRISM_TRY(_v256_store_ctob(dev, t));
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_CMP_GE, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_CPL2, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  return __prism_image_u8(dev, PRISM_OPCODE_AND_N, t);
+}
+
+static ui8 __prism_image_sub_pixel(const prism_image_run_t *run, const ui8 a,
+                                   const ui8 b) {
+  (void)b;
+  return (a > run->param) ? (ui8)(a - run->param) : 0;
+}
+
+static ui8 __prism_image_add_pixel(const prism_image_run_t *run, const ui8 a,
+                                   const ui8 b) {
+  (void)b;
+  return (a + run->param > 255) ? 255 : (ui8)(a + run->param);
+}
+
+prism_err prism_image_offset(const prdev_t *dev, const prism_frame_t *src,
+                             const si16 offset, const prism_frame_t *dst,
+                             prism_image_stats_t *stats, ui32 timeout) {
+  if (dev == 0 || !__prism_image_frame_valid(src) ||
+      !__prism_image_frame_valid(dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_image_same_size(src, dst) || offset < -255 || offset > 255) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_image_run_t run;
+  run.device = dev;
+  run.timeout = timeout;
+  run.a = src;
+  run.b = 0;
+  run.out = dst;
+  run.block = 32;
+  run.param = (ui32)(offset < 0 ? -offset : offset);
+  run.op = (offset < 0) ? __prism_image_sub_op : __prism_image_add_op;
+  run.pixel = (offset < 0) ? __prism_image_sub_pixel : __prism_image_add_pixel;
+  return __prism_image_run(&run, stats);
+}
+
+// C = (a > t) ? 255 : 0
+static prism_err __prism_image_threshold_op(const prism_image_run_t *run,
+                                            const ui8 *b) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+  (void)b;
+
+  PRISM_TRY(__prism_image_u8_s(dev, PRISM_OPCODE_CMP_GT_S, run->param, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  return __prism_image_u8(dev, PRISM_OPCODE_CPL2, t);
+}
+
+static ui8 __prism_image_threshold_pixel(const prism_image_run_t *run,
+                                         const ui8 a, const ui8 b) {
+  (void)b;
+  return (a > run->param) ? 255 : 0;
+}
+
+prism_err prism_image_threshold(const prdev_t *dev, const prism_frame_t *src,
+                                const ui8 threshold, const prism_frame_t *dst,
+                                prism_image_stats_t *stats, ui32 timeout) {
+  if (dev == 0 || !__prism_image_frame_valid(src) ||
+      !__prism_image_frame_valid(dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_image_same_size(src, dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_image_run_t run;
+  run.device = dev;
+  run.timeout = timeout;
+  run.a = src;
+  run.b = 0;
+  run.out = dst;
+  run.block = 32;
+  run.param = threshold;
+  run.op = __prism_image_threshold_op;
+  run.pixel = __prism_image_threshold_pixel;
+  return __prism_image_run(&run, stats);
+}
+
+// d = a - b wraps for a < b. With ge = (a >= d), which is (a >= b) for
+// unsigned lanes, |a - b| = d * (2 * ge - 1) modulo 256
+static prism_err __prism_image_diff_op(const prism_image_run_t *run,
+                                       const ui8 *b) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)b, PRISM_BANK_B, t));
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_SUB_N, t));  // C = d
+  PRISM_TRY(_v256_store_ctob(dev, t));                      // B = d
+  PRISM_TRY(__prism_image_u8(dev, PRISM_OPCODE_CMP_GE, t)); // C = ge
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(__prism_image_u8_s(dev, PRISM_OPCODE_MUL_S, 2, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(__prism_image_u8_s(dev, PRISM_OPCODE_SUB_S, 1, t)); // C = +-1
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  return __prism_image_u8(dev, PRISM_OPCODE_MUL_N, t); // C = |a - b|
+}
+
+static ui8 __prism_image_diff_pixel(const prism_image_run_t *run, const ui8 a,
+                                    const ui8 b) {
+  (void)run;
+  return (a > b) ? (ui8)(a - b) : (ui8)(b - a);
+}
+
+prism_err prism_image_diff(const prdev_t *dev, const prism_frame_t *a,
+                           const prism_frame_t *b, const prism_frame_t *dst,
+                           prism_image_stats_t *stats, ui32 timeout) {
+  if (dev == 0 || !__prism_image_frame_valid(a) ||
+      !__prism_image_frame_valid(b) || !__prism_image_frame_valid(dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_image_same_size(a, b) || !__prism_image_same_size(a, dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_image_run_t run;
+  run.device = dev;
+  run.timeout = timeout;
+  run.a = a;
+  run.b = b;
+  run.out = dst;
+  run.block = 32;
+  run.param = 0;
+  run.op = __prism_image_diff_op;
+  run.pixel = __prism_image_diff_pixel;
+  return __prism_image_run(&run, stats);
+}
+
+// 16 pixels on 16-bit lanes: a * alpha + b * (256 - alpha) + 128 fits
+static prism_err __prism_image_blend_op(const prism_image_run_t *run,
+                                        const ui8 *b) {
+  const prdev_t *dev = run->device;
+  const ui32 t = run->timeout;
+  const ui8 type = PRISM_OPCODE_TYPE_UI16;
+  _v256i wide;
+
+  PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_MUL_S, type, 8, run->param, t));
+  PRISM_TRY(_v256_store_ctob(dev, t)); // B = a * alpha
+  __prism_image_widen(b, &wide);
+  PRISM_TRY(_prism_send_bank_ptr(dev, wide.ui, PRISM_BANK_A, t));
+  PRISM_TRY(
+      _v256_opN_scalar(dev, PRISM_OPCODE_MUL_S, type, 8, 256 - run->param, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, type, 8, 0, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_ADD_S, type, 8, 128, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  return prism_op(dev, PRISM_OPCODE_SHIFT_R, type, 8, 8, t);
+}
+
+static ui8 __prism_image_blend_pixel(const prism_image_run_t *run,
+                                     const ui8 a, const ui8 b) {
+  return (ui8)((a * run->param + b * (256 - run->param) + 128) >> 8);
+}
+
+prism_err prism_image_blend(const prdev_t *dev, const prism_frame_t *a,
+                            const prism_frame_t *b, const ui16 alpha,
+                            const prism_frame_t *dst,
+                            prism_image_stats_t *stats, ui32 timeout) {
+  if (dev == 0 || !__prism_image_frame_valid(a) ||
+      !__prism_image_frame_valid(b) || !__prism_image_frame_valid(dst)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_image_same_size(a, b) || !__prism_image_same_size(a, dst) ||
+      alpha > 256) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_image_run_t run;
+  run.device = dev;
+  run.timeout = timeout;
+  run.a = a;
+  run.b = b;
+  run.out = dst;
+  run.block = 16;
+  run.param = alpha;
+  run.op = __prism_image_blend_op;
+  run.pixel = __prism_image_blend_pixel;
+  return __prism_image_run(&run, stats);
+}
+
+// Adds up to __PRISM_IMAGE_SUM_BLOCKS blocks of 32 pixels. Bank B holds 16
+// lanes of 16 bits, each the sum of its even and odd pixels:
+//   acc + x - 255 * (x >> 8) == acc + (x & 0xFF) + (x >> 8)
+static prism_err __prism_image_sum_blocks(const prdev_t *dev, const ui8 *px,
+                                          const ui16 blocks, ui32 *sum,
+                                          ui32 timeout) {
+  const ui8 type = PRISM_OPCODE_TYPE_UI16;
+  _v256i acc;
+
+  PRISM_TRY(_v256_splat_bank_v(dev, PRISM_BANK_B, type, 0, timeout));
+  for (ui16 i = 0; i < blocks; i++) {
+    PRISM_TRY(_prism_send_bank_ptr(dev, (const ui32 *)(px + 32 * (size_t)i),
+                                   PRISM_BANK_A, timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, type, 8, 0, timeout));
+    PRISM_TRY(_v256_store_ctob(dev, timeout)); // B = acc + x
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_SHIFT_R, type, 8, 8, timeout));
+    PRISM_TRY(_v256_store_ctoa(dev, timeout)); // A = x >> 8
+    PRISM_TRY(_v256_opN_scalar(dev, PRISM_OPCODE_MUL_S, type, 8, 0xFF01,
+                               timeout)); // C = -255 * (x >> 8)
+    PRISM_TRY(_v256_store_ctoa(dev, timeout));
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_ADD_N, type, 8, 0, timeout));
+    PRISM_TRY(_v256_store_ctob(dev, timeout));
+  }
+  PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_B, acc.ui, timeout));
+
+  for (uint8_t l = 0; l < 16; l++) {
+    *sum += acc.uix[l];
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_image_row_sums(const prdev_t *dev,
+                                        const prism_frame_t *src, ui32 *sums,
+                                        ui32 timeout) {
+  const ui16 blocks = src->width / 32;
+
+  for (ui16 y = 0; y < src->height; y++) {
+    const ui8 *row = __prism_image_row(src, y);
+    ui32 sum = 0;
+
+    for (ui16 i = 0; i < blocks; i += __PRISM_IMAGE_SUM_BLOCKS) {
+      const ui16 n = (blocks - i < __PRISM_IMAGE_SUM_BLOCKS)
+                         ? blocks - i
+                         : __PRISM_IMAGE_SUM_BLOCKS;
+      PRISM_TRY(__prism_image_sum_blocks(dev, row + 32 * (size_t)i, n, &sum,
+                                         timeout));
+    }
+    for (size_t x = (size_t)blocks * 32; x < src->width; x++) {
+      sum += row[x];
+    }
+    sums[y] = sum;
+  }
+  return PR_OK;
+}
+
+prism_err prism_image_row_sums(const prdev_t *dev, const prism_frame_t *src,
+                               ui32 *sums, prism_image_stats_t *stats,
+                               ui32 timeout) {
+  if (dev == 0 || !__prism_image_frame_valid(src) || sums == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const unsigned long start = micros();
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  prism_err err = __prism_image_row_sums(dev, src, sums, timeout);
+  prism_err restore = _v256_set_caop(dev, timeout);
+  if (err == PR_OK) {
+    err = restore;
+  }
+
+  if (err == PR_OK && stats != 0) {
+    stats->frames++;
+    stats->micros += (ui32)(micros() - start);
+  }
+  return err;
+}
+
+float prism_image_fps(const prism_image_stats_t *stats) {
+  if (stats == 0 || stats->micros == 0) {
+    return 0.0f;
+  }
+  return (float)stats->frames * 1000000.0f / (float)stats->micros;
+}
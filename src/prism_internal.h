@@ -0,0 +1,75 @@
+/**
+ * @file prism_internal.h
+ * @brief Helpers shared by the Prism library sources. Not installed, not part
+ * of the public API.
+ */
+#pragma once
+
+#ifndef __PRISM_INTERNAL__
+#define __PRISM_INTERNAL__ 1
+
+#include "prism/prism.h"
+
+// Evaluates a prism_err expression and returns from the calling function if
+// it failed. Used for the long command sequences of the composed operations.
+#define PRISM_TRY(expr)                                                        \
+  do {                                                                         \
+    prism_err __prism_try_err = (expr);                                        \
+    if (__prism_try_err != PR_OK) {                                            \
+      return __prism_try_err;                                                  \
+    }                                                                          \
+  } while (0)
+
+// Flipping the sign bit maps signed order onto unsigned order, so signed
+// compares can run on unsigned sequences
+#define PRISM_SIGN_BIAS 0x80000000UL
+
+// Start value of _prism_crc16
+#define PRISM_CRC16_INIT (0xFFFF)
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021) of len bytes, continued from crc.
+// Guards bank data on the link, defined in prism.cpp.
+ui16 _prism_crc16(ui16 crc, const uint8_t *data, size_t len);
+
+// Counts a bank transfer in the link counters of dev. True if it failed its
+// CRC and the attempt, counted from 0, may be followed by another one.
+bool _prism_link_retry(const prdev_t *dev, const prism_err err,
+                       const uint8_t attempt);
+
+// Opcodes that open a bank transfer. The bank must be valid for the direction.
+static inline uint16_t _prism_store_opcode(const bank_t bank) {
+  return (bank == PRISM_BANK_A) ? PRISM_OPCODE_STORE_A : PRISM_OPCODE_STORE_B;
+}
+static inline uint16_t _prism_load_opcode(const bank_t bank) {
+  switch (bank) {
+  case PRISM_BANK_A:
+    return PRISM_OPCODE_LOAD_A;
+  case PRISM_BANK_B:
+    return PRISM_OPCODE_LOAD_B;
+  case PRISM_BANK_C:
+    return PRISM_OPCODE_LOAD_C;
+  default:
+    return PRISM_OPCODE_LOAD_D;
+  }
+}
+
+// The 32 data bytes of a bank transfer whose opcode was sent, followed by
+// their CRC if the link checks blocks. The caller closes the transfer with
+// END and retries with _prism_link_retry. Reading returns PR_ERR_LINK for a
+// damaged block. Defined in prism.cpp, shared with the coroutine scheduler.
+prism_err _prism_write_bank_data(const prdev_t *dev, const ui32 *src,
+                                 const bool pgm);
+prism_err _prism_read_bank_data(const prdev_t *dev, ui32 *out);
+
+// The frame arg of a lane operation as prism_op sends it, and whether the
+// frame carries arg as immediate. PR_ERR_INVALID_ARGUMENT where prism_op
+// rejects the operation. Defined in prism.cpp.
+prism_err _prism_op_arg(const uint16_t op, const ui8 type, const ui8 lanes,
+                        const ui32 arg, ui8 *frame_arg, bool *has_imm);
+
+// Writes one command frame over I²C. Shared by the P²Link and I²C backends,
+// defined in prism_transport_i2c.cpp.
+prism_err _prism_i2c_send_command(const prdev_t *dev, const uint8_t *frame,
+                                  size_t len);
+
+#endif // __PRISM_INTERNAL__
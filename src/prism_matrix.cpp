@@ -0,0 +1,161 @@
+#include "prism/prism_matrix.h"
+#include "prism/prism_dsp.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+static inline bool __prism_matrix_type_valid(const ui8 type) {
+  return type == PRISM_OPCODE_TYPE_SI8 || type == PRISM_OPCODE_TYPE_SI16 ||
+         type == PRISM_OPCODE_TYPE_SI32;
+}
+
+static inline si32 __prism_matrix_at(const void *base, const ui8 type,
+                                     const size_t index) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_SI8:
+    return ((const si8 *)base)[index];
+  case PRISM_OPCODE_TYPE_SI16:
+    return ((const si16 *)base)[index];
+  default:
+    return ((const si32 *)base)[index];
+  }
+}
+
+// Widens up to 8 consecutive elements into 32-bit lanes, zero padded
+static void __prism_matrix_pack(const void *base, const ui8 type,
+                                const size_t first, const size_t count,
+                                _v256i *v) {
+  memset(v, 0, sizeof(_v256i));
+  for (size_t l = 0; l < count && l < 8; l++) {
+    v->si[l] = __prism_matrix_at(base, type, first + l);
+  }
+}
+
+// The int32 elements are uploaded from caller memory, the narrow ones from a
+// widened copy
+static inline const ui32 *__prism_matrix_lanes(const void *base,
+                                               const ui8 type,
+                                               const size_t first,
+                                               const size_t count,
+                                               _v256i *scratch) {
+  if (type == PRISM_OPCODE_TYPE_SI32 && count == 8) {
+    return (const ui32 *)base + first;
+  }
+  __prism_matrix_pack(base, type, first, count, scratch);
+  return scratch->ui;
+}
+
+// One block of 8 columns: x[c0..c0 + 8) stays in bank B, the matching block of
+// every row goes through bank A
+static prism_err __prism_gemv_block(const prdev_t *dev, const ui8 type,
+                                    const void *m, const size_t rows,
+                                    const size_t cols, const size_t c0,
+                                    const void *x, ui32 *acc, ui32 timeout) {
+  const size_t count = (cols - c0 < 8) ? cols - c0 : 8;
+  _v256i xv, row, next, prod;
+
+  PRISM_TRY(_prism_send_bank_ptr(
+      dev, __prism_matrix_lanes(x, type, c0, count, &xv), PRISM_BANK_B,
+      timeout));
+  PRISM_TRY(_prism_send_bank_ptr(
+      dev, __prism_matrix_lanes(m, type, c0, count, &row), PRISM_BANK_A,
+      timeout));
+
+  for (size_t r = 0; r < rows; r++) {
+    PRISM_TRY(prism_op(dev, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_SI32, 8, 0,
+                       timeout));
+    if (r + 1 < rows) {
+      const ui32 *src = __prism_matrix_lanes(m, type, (r + 1) * cols + c0,
+                                             count, &next);
+      PRISM_TRY(_prism_exchange_bank_ptr(dev, PRISM_BANK_C, prod.ui,
+                                         PRISM_BANK_A, src, timeout));
+    } else {
+      PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, prod.ui, timeout));
+    }
+
+    for (uint8_t l = 0; l < count; l++) {
+      acc[r] += prod.ui[l];
+    }
+  }
+  return PR_OK;
+}
+
+prism_err prism_gemv(const prdev_t *dev, const ui8 type, const void *m,
+                     const size_t rows, const size_t cols, const void *x,
+                     si32 *y, ui32 timeout) {
+  if (dev == 0 || m == 0 || x == 0 || y == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_matrix_type_valid(type) || rows == 0 || cols == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // Partial sums wrap like the 32-bit device lanes
+  ui32 *acc = (ui32 *)y;
+  memset(acc, 0, rows * sizeof(ui32));
+
+  // Bank B keeps the block of x across the MUL operations
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+
+  prism_err err = PR_OK;
+  for (size_t c0 = 0; err == PR_OK && c0 < cols; c0 += 8) {
+    err = __prism_gemv_block(dev, type, m, rows, cols, c0, x, acc, timeout);
+  }
+
+  prism_err restore = _v256_set_caop(dev, timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+// c[i][j0..j0 + 8) = sum over p of a[i][p] * b[p][j0..j0 + 8), accumulated on
+// the device
+static prism_err __prism_gemm_tile(prism_mac_t *mac, const ui8 type,
+                                   const void *a, const void *b, si32 *c,
+                                   const size_t i, const size_t j0,
+                                   const size_t k, const size_t n) {
+  const size_t count = (n - j0 < 8) ? n - j0 : 8;
+  _v256i row, tile;
+
+  PRISM_TRY(prism_mac_reset(mac, 0));
+  for (size_t p = 0; p < k; p++) {
+    const si32 s = __prism_matrix_at(a, type, i * k + p);
+    if (s == 0) {
+      continue;
+    }
+    PRISM_TRY(prism_mac_push(
+        mac, __prism_matrix_lanes(b, type, p * n + j0, count, &row),
+        (ui32)s));
+  }
+  if (mac->count == 0) {
+    memset(&c[i * n + j0], 0, count * sizeof(si32));
+    return PR_OK;
+  }
+
+  PRISM_TRY(prism_mac_read(mac, tile.ui));
+  memcpy(&c[i * n + j0], tile.si, count * sizeof(si32));
+  return PR_OK;
+}
+
+prism_err prism_gemm(const prdev_t *dev, const ui8 type, const void *a,
+                     const void *b, si32 *c, const size_t m, const size_t k,
+                     const size_t n, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0 || c == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_matrix_type_valid(type) || m == 0 || k == 0 || n == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_mac_t mac;
+  PRISM_TRY(prism_mac_begin(&mac, dev, PRISM_OPCODE_TYPE_SI32, 0, timeout));
+
+  prism_err err = PR_OK;
+  for (size_t i = 0; err == PR_OK && i < m; i++) {
+    for (size_t j0 = 0; err == PR_OK && j0 < n; j0 += 8) {
+      err = __prism_gemm_tile(&mac, type, a, b, c, i, j0, k, n);
+    }
+  }
+
+  prism_err restore = _v256_set_caop(dev, timeout);
+  return (err != PR_OK) ? err : restore;
+}
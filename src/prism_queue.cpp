@@ -0,0 +1,347 @@
+#include "prism/prism_queue.h"
+
+#if PRISM_ENABLE_THREADS == 1
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <string.h>
+#include <thread>
+
+typedef struct prism_job {
+  uint16_t op;
+  ui8 type;
+  ui8 lanes;
+  _v256i a;
+  _v256i b;
+  prism_job_callback_t callback;
+  void *user;
+  std::promise<prism_job_result_t> *promise; // Set by the future front end
+} prism_job_t;
+
+struct prism_queue {
+  const prdev_t *device;
+  ui32 timeout;
+  size_t capacity;
+
+  std::mutex lock;
+  std::condition_variable has_jobs;
+  std::condition_variable has_space;
+  std::deque<prism_job_t> jobs;
+  bool stopping;
+  // Jobs taken by the worker, kept off the worker stack (3 KB on ESP32)
+  prism_job_t batch[PRISM_QUEUE_BATCH_MAX];
+  prism_queue_stats_t stats;
+
+  std::thread worker;
+};
+
+static inline bool __prism_queue_op_valid(const uint16_t op) {
+  return (op >= PRISM_OPCODE_ADD_N && op <= PRISM_OPCODE_NOR_N) ||
+         (op >= PRISM_OPCODE_CMP_EQ && op <= PRISM_OPCODE_CMP_LE);
+}
+
+static void __prism_queue_complete(prism_job_t *job,
+                                   const prism_job_result_t *result) {
+  if (job->callback != 0) {
+    job->callback(result, job->user);
+  }
+  if (job->promise != 0) {
+    job->promise->set_value(*result);
+    delete job->promise;
+    job->promise = 0;
+  }
+}
+
+// Runs jobs [first, last) as one device operation, their lanes packed back to
+// back. Bank A already holds the packed A operand. The next group's A operand
+// is uploaded while this result is downloaded.
+static prism_err __prism_queue_run_group(prism_queue_t *q, prism_job_t *jobs,
+                                         const size_t first, const size_t last,
+                                         const _v256i *next_a, _v256i *c) {
+  const prdev_t *dev = q->device;
+  _v256i b;
+  ui8 lanes = 0;
+
+  memset(&b, 0, sizeof(_v256i));
+  for (size_t i = first; i < last; i++) {
+    memcpy(&b.ui[lanes], jobs[i].b.ui, jobs[i].lanes * sizeof(ui32));
+    lanes += jobs[i].lanes;
+  }
+
+  prism_err err = _prism_send_bank_ptr(dev, b.ui, PRISM_BANK_B, q->timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+  // The same frame as a direct call, e.g. integer compares cover all lanes
+  err = prism_op(dev, jobs[first].op, jobs[first].type, lanes, 0, q->timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+
+  if (next_a != 0) {
+    return _prism_exchange_bank_ptr(dev, PRISM_BANK_C, c->ui, PRISM_BANK_A,
+                                    next_a->ui, q->timeout);
+  }
+  return _prism_load_bank_ptr(dev, PRISM_BANK_C, c->ui, q->timeout);
+}
+
+// End of the group that starts at first: same op and type, lanes fit into 8
+static size_t __prism_queue_group_end(const prism_job_t *jobs,
+                                      const size_t first, const size_t n) {
+  size_t last = first + 1;
+  ui8 lanes = jobs[first].lanes;
+
+  while (last < n && jobs[last].op == jobs[first].op &&
+         jobs[last].type == jobs[first].type &&
+         lanes + jobs[last].lanes <= 8) {
+    lanes += jobs[last].lanes;
+    last++;
+  }
+  return last;
+}
+
+static void __prism_queue_pack_a(const prism_job_t *jobs, const size_t first,
+                                 const size_t last, _v256i *a) {
+  ui8 lanes = 0;
+
+  memset(a, 0, sizeof(_v256i));
+  for (size_t i = first; i < last; i++) {
+    memcpy(&a->ui[lanes], jobs[i].a.ui, jobs[i].lanes * sizeof(ui32));
+    lanes += jobs[i].lanes;
+  }
+}
+
+static void __prism_queue_run_batch(prism_queue_t *q, prism_job_t *jobs,
+                                    const size_t n) {
+  bool a_loaded = false;
+  _v256i a, next_a, c;
+
+  memset(&next_a, 0, sizeof(_v256i));
+  size_t first = 0;
+  size_t last = __prism_queue_group_end(jobs, 0, n);
+  __prism_queue_pack_a(jobs, first, last, &a);
+
+  while (first < n) {
+    prism_err err = PR_OK;
+    if (!a_loaded) {
+      err = _prism_send_bank_ptr(q->device, a.ui, PRISM_BANK_A, q->timeout);
+    }
+
+    const size_t next_last =
+        (last < n) ? __prism_queue_group_end(jobs, last, n) : n;
+    if (last < n) {
+      __prism_queue_pack_a(jobs, last, next_last, &next_a);
+    }
+
+    const bool ran = (err == PR_OK);
+    if (ran) {
+      err = __prism_queue_run_group(q, jobs, first, last,
+                                    (last < n) ? &next_a : 0, &c);
+    }
+    // A failed step leaves bank A undefined, the next group uploads again
+    a_loaded = (err == PR_OK);
+
+    {
+      // Counted before the results go out: a submitter that has its result
+      // also finds its job in the counters
+      std::lock_guard<std::mutex> guard(q->lock);
+      q->stats.jobs += (ui32)(last - first);
+      q->stats.device_ops += ran ? 1 : 0;
+    }
+
+    ui8 lane = 0;
+    for (size_t i = first; i < last; i++) {
+      prism_job_result_t result;
+      memset(&result, 0, sizeof(prism_job_result_t));
+      result.err = err;
+      if (err == PR_OK) {
+        memcpy(result.value.ui, &c.ui[lane], jobs[i].lanes * sizeof(ui32));
+      }
+      lane += jobs[i].lanes;
+      __prism_queue_complete(&jobs[i], &result);
+    }
+
+    first = last;
+    last = next_last;
+    a = next_a;
+  }
+}
+
+static void __prism_queue_worker(prism_queue_t *q) {
+  prism_job_t *batch = q->batch;
+
+  for (;;) {
+    size_t n = 0;
+    {
+      std::unique_lock<std::mutex> guard(q->lock);
+      q->has_jobs.wait(guard, [q] { return q->stopping || !q->jobs.empty(); });
+      if (q->jobs.empty()) {
+        return; // Stopping and drained
+      }
+
+      while (n < PRISM_QUEUE_BATCH_MAX && !q->jobs.empty()) {
+        batch[n++] = q->jobs.front();
+        q->jobs.pop_front();
+      }
+      q->stats.batches++;
+    }
+    q->has_space.notify_all();
+
+    // The bus is only touched here, outside the lock, so producers never wait
+    // for a device transfer
+    __prism_queue_run_batch(q, batch, n);
+  }
+}
+
+static prism_err __prism_queue_push(prism_queue_t *q, const prism_job_t *job) {
+  {
+    std::unique_lock<std::mutex> guard(q->lock);
+    q->has_space.wait(
+        guard, [q] { return q->stopping || q->jobs.size() < q->capacity; });
+    if (q->stopping) {
+      return PR_ERR_UNSUPPORTED_OPERATION; // Queue is shutting down
+    }
+    q->jobs.push_back(*job);
+  }
+  q->has_jobs.notify_one();
+  return PR_OK;
+}
+
+static prism_err __prism_queue_job(prism_job_t *job, const uint16_t op,
+                                   const ui8 type, const ui8 lanes,
+                                   const _v256i *a, const _v256i *b) {
+  if (a == 0 || b == 0 || type == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_queue_op_valid(op) || lanes < 1 || lanes > 8) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  job->op = op;
+  job->type = type;
+  job->lanes = lanes;
+  job->a = *a;
+  job->b = *b;
+  job->callback = 0;
+  job->user = 0;
+  job->promise = 0;
+  return PR_OK;
+}
+
+prism_err prism_queue_create(const prdev_t *dev, const size_t capacity,
+                             ui32 timeout, prism_queue_t **queue) {
+  if (dev == 0 || queue == 0 || capacity == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_queue_t *q = new (std::nothrow) prism_queue_t();
+  if (q == 0) {
+    return PR_ERR_OUT_OF_MEMORY;
+  }
+  q->device = dev;
+  q->timeout = timeout;
+  q->capacity = capacity;
+  q->stopping = false;
+  memset(&q->stats, 0, sizeof(prism_queue_stats_t));
+
+  // std::thread reports failure with an exception, the rest of the library
+  // does not use them
+#if defined(__cpp_exceptions)
+  try {
+    q->worker = std::thread(__prism_queue_worker, q);
+  } catch (...) {
+    delete q;
+    return PR_ERR_OUT_OF_MEMORY;
+  }
+#else
+  q->worker = std::thread(__prism_queue_worker, q);
+#endif
+
+  *queue = q;
+  return PR_OK;
+}
+
+void prism_queue_destroy(prism_queue_t *q) {
+  if (q == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(q->lock);
+    q->stopping = true;
+  }
+  q->has_jobs.notify_all();
+  q->has_space.notify_all();
+
+  if (q->worker.joinable()) {
+    q->worker.join();
+  }
+  delete q;
+}
+
+prism_err prism_queue_submit(prism_queue_t *q, const uint16_t op,
+                             const ui8 type, const ui8 lanes, const _v256i *a,
+                             const _v256i *b, prism_job_callback_t callback,
+                             void *user) {
+  if (q == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_job_t job;
+  prism_err err = __prism_queue_job(&job, op, type, lanes, a, b);
+  if (err != PR_OK) {
+    return err;
+  }
+  job.callback = callback;
+  job.user = user;
+
+  return __prism_queue_push(q, &job);
+}
+
+prism_err prism_queue_stats(prism_queue_t *q, prism_queue_stats_t *stats) {
+  if (q == 0 || stats == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  std::lock_guard<std::mutex> guard(q->lock);
+  *stats = q->stats;
+  return PR_OK;
+}
+
+std::future<prism_job_result_t>
+prism_queue_submit_future(prism_queue_t *q, const uint16_t op, const ui8 type,
+                          const ui8 lanes, const _v256i *a, const _v256i *b) {
+  std::promise<prism_job_result_t> *promise =
+      new (std::nothrow) std::promise<prism_job_result_t>();
+  if (promise == 0) {
+    std::promise<prism_job_result_t> failed;
+    prism_job_result_t result;
+    memset(&result, 0, sizeof(prism_job_result_t));
+    result.err = PR_ERR_OUT_OF_MEMORY;
+    failed.set_value(result);
+    return failed.get_future();
+  }
+  std::future<prism_job_result_t> future = promise->get_future();
+
+  prism_job_t job;
+  prism_err err = (q == 0) ? PR_ERR_INVALID_ARGUMENT
+                           : __prism_queue_job(&job, op, type, lanes, a, b);
+  if (err == PR_OK) {
+    job.promise = promise;
+    err = __prism_queue_push(q, &job);
+  }
+
+  if (err != PR_OK) {
+    // Never queued, complete the future here
+    prism_job_result_t result;
+    memset(&result, 0, sizeof(prism_job_result_t));
+    result.err = err;
+    promise->set_value(result);
+    delete promise;
+  }
+  return future;
+}
+
+#endif // PRISM_ENABLE_THREADS == 1
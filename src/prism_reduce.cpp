@@ -0,0 +1,202 @@
+#include "prism/prism_reduce.h"
+#include "prism/prism_select.h"
+
+#include "prism_internal.h"
+
+static inline bool __prism_reduce_biased(const prism_reduce_t *ctx) {
+  return ctx->type == PRISM_OPCODE_TYPE_SI32 &&
+         (ctx->op == PRISM_REDUCE_MIN || ctx->op == PRISM_REDUCE_MAX);
+}
+
+static uint16_t __prism_reduce_opcode(const prism_reduce_op_t op) {
+  switch (op) {
+  case PRISM_REDUCE_SUM:
+    return PRISM_OPCODE_ADD_N;
+  case PRISM_REDUCE_AND:
+    return PRISM_OPCODE_AND_N;
+  case PRISM_REDUCE_OR:
+    return PRISM_OPCODE_OR_N;
+  case PRISM_REDUCE_XOR:
+    return PRISM_OPCODE_XOR_N;
+  default:
+    return 0;
+  }
+}
+
+static ui32 __prism_reduce_scalar(const prism_reduce_op_t op, const ui8 type,
+                                  const ui32 a, const ui32 b) {
+  const bool is_signed = (type == PRISM_OPCODE_TYPE_SI32);
+
+  switch (op) {
+  case PRISM_REDUCE_SUM:
+    return a + b;
+  case PRISM_REDUCE_MIN:
+    if (is_signed) {
+      return (si32)a < (si32)b ? a : b;
+    }
+    return a < b ? a : b;
+  case PRISM_REDUCE_MAX:
+    if (is_signed) {
+      return (si32)a > (si32)b ? a : b;
+    }
+    return a > b ? a : b;
+  case PRISM_REDUCE_AND:
+    return a & b;
+  case PRISM_REDUCE_OR:
+    return a | b;
+  case PRISM_REDUCE_XOR:
+    return a ^ b;
+  default:
+    return 0;
+  }
+}
+
+prism_err prism_reduce_begin(prism_reduce_t *ctx, const prdev_t *dev,
+                             const prism_reduce_op_t op, const ui8 type,
+                             const ui32 *first, ui32 timeout) {
+  if (ctx == 0 || dev == 0 || first == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (op > PRISM_REDUCE_XOR) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (type != PRISM_OPCODE_TYPE_UI32 && type != PRISM_OPCODE_TYPE_SI32) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  ctx->device = dev;
+  ctx->op = op;
+  ctx->type = type;
+  ctx->count = 1;
+  ctx->timeout = timeout;
+
+  prism_err err = _v256_set_ncaop(dev, timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+
+  if (__prism_reduce_biased(ctx)) {
+    ui32 biased[8];
+    for (uint8_t i = 0; i < 8; i++) {
+      biased[i] = first[i] ^ PRISM_SIGN_BIAS;
+    }
+    return _prism_send_bank_ptr(dev, biased, PRISM_BANK_A, timeout);
+  }
+  return _prism_send_bank_ptr(dev, first, PRISM_BANK_A, timeout);
+}
+
+prism_err prism_reduce_push(prism_reduce_t *ctx, const ui32 *next) {
+  if (ctx == 0 || ctx->device == 0 || next == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_err err = PR_OK;
+
+  if (ctx->op == PRISM_REDUCE_MIN || ctx->op == PRISM_REDUCE_MAX) {
+    if (__prism_reduce_biased(ctx)) {
+      ui32 biased[8];
+      for (uint8_t i = 0; i < 8; i++) {
+        biased[i] = next[i] ^ PRISM_SIGN_BIAS;
+      }
+      err = _prism_minmax_bank_a(ctx->device, ctx->op == PRISM_REDUCE_MAX,
+                                 biased, ctx->timeout);
+    } else {
+      err = _prism_minmax_bank_a(ctx->device, ctx->op == PRISM_REDUCE_MAX,
+                                 next, ctx->timeout);
+    }
+  } else {
+    const prdev_t *dev = ctx->device;
+
+    err = _prism_send_bank_ptr(dev, next, PRISM_BANK_B, ctx->timeout);
+    if (err == PR_OK) {
+      err = prism_op(dev, __prism_reduce_opcode(ctx->op), ctx->type, 8, 0,
+                     ctx->timeout);
+    }
+    if (err == PR_OK) {
+      err = _v256_store_ctoa(dev, ctx->timeout);
+    }
+  }
+
+  if (err == PR_OK) {
+    ctx->count++;
+  }
+  return err;
+}
+
+prism_err prism_reduce_end(prism_reduce_t *ctx, _v256i *acc) {
+  if (ctx == 0 || ctx->device == 0 || acc == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // Bank A holds the accumulator after every step, also when nothing was
+  // pushed after prism_reduce_begin
+  prism_err err =
+      _prism_load_bank_ptr(ctx->device, PRISM_BANK_A, acc->ui, ctx->timeout);
+  prism_err restore = _v256_set_caop(ctx->device, ctx->timeout);
+  if (err != PR_OK) {
+    return err;
+  }
+
+  if (__prism_reduce_biased(ctx)) {
+    for (uint8_t i = 0; i < 8; i++) {
+      acc->ui[i] ^= PRISM_SIGN_BIAS;
+    }
+  }
+  return restore;
+}
+
+ui32 _v256_fold_ui32(const _v256i *v, const prism_reduce_op_t op,
+                     const ui8 type, const ui8 lanes) {
+  if (v == 0 || lanes < 1 || lanes > 8) {
+    return 0;
+  }
+
+  ui32 result = v->ui[0];
+  for (uint8_t i = 1; i < lanes; i++) {
+    result = __prism_reduce_scalar(op, type, result, v->ui[i]);
+  }
+  return result;
+}
+
+prism_err prism_reduce_ui32(const prdev_t *dev, const prism_reduce_op_t op,
+                            const ui8 type, const ui32 *data, const size_t n,
+                            ui32 *result, ui32 timeout) {
+  if (dev == 0 || data == 0 || result == 0 || n == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (op > PRISM_REDUCE_XOR) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  size_t i = 0;
+  ui32 value = data[0];
+
+  if (n >= 8) {
+    prism_reduce_t ctx;
+    _v256i acc;
+
+    prism_err err = prism_reduce_begin(&ctx, dev, op, type, data, timeout);
+    for (i = 8; err == PR_OK && i + 8 <= n; i += 8) {
+      err = prism_reduce_push(&ctx, &data[i]);
+    }
+    if (err != PR_OK) {
+      _v256_set_caop(dev, timeout);
+      return err;
+    }
+    err = prism_reduce_end(&ctx, &acc);
+    if (err != PR_OK) {
+      return err;
+    }
+    value = _v256_fold_ui32(&acc, op, type, 8);
+  } else {
+    i = 1;
+  }
+
+  // Ragged tail on the host
+  for (; i < n; i++) {
+    value = __prism_reduce_scalar(op, type, value, data[i]);
+  }
+
+  *result = value;
+  return PR_OK;
+}
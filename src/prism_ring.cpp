@@ -0,0 +1,228 @@
+#include "prism/prism_ring.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+#ifdef __AVR__
+#include <util/atomic.h>
+
+// A 16-bit index takes two byte accesses on AVR, and __atomic on it would
+// need libatomic, which avr-libc lacks. An interrupt must not land between the
+// two bytes, so the access runs with interrupts off for a few cycles. The
+// block is also a compiler barrier, which is all a single core needs.
+#define __PRISM_RING_LOAD(index) __prism_ring_load(&(index))
+#define __PRISM_RING_PUBLISH(index, value) __prism_ring_publish(&(index), value)
+
+static inline uint16_t __prism_ring_load(const uint16_t *index) {
+  uint16_t value;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    value = *(const volatile uint16_t *)index;
+  }
+  return value;
+}
+
+static inline void __prism_ring_publish(uint16_t *index,
+                                        const uint16_t value) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *(volatile uint16_t *)index = value; }
+}
+#else
+// The index the other side writes. Acquire pairs with the release store of
+// the writer, so the sample data is visible before the index moves.
+#define __PRISM_RING_LOAD(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define __PRISM_RING_PUBLISH(index, value)                                     \
+  __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#endif // __AVR__
+
+static uint8_t __prism_ring_width(const ui8 type) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_UI32:
+  case PRISM_OPCODE_TYPE_SI32:
+    return 4;
+  case PRISM_OPCODE_TYPE_UI16:
+  case PRISM_OPCODE_TYPE_SI16:
+    return 2;
+  case PRISM_OPCODE_TYPE_UI8:
+  case PRISM_OPCODE_TYPE_SI8:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+prism_err prism_ring_init(prism_ring_t *ring, void *buf, const uint16_t size,
+                          const ui8 type, const prism_ring_policy_t policy) {
+  if (ring == 0 || buf == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (size == 0 || size > PRISM_RING_MAX || (size & (size - 1)) != 0) {
+    return PR_ERR_INVALID_ARGUMENT; // The indices wrap with a mask
+  }
+  const uint8_t width = __prism_ring_width(type);
+  if (width == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  memset(ring, 0, sizeof(prism_ring_t));
+  ring->buf = (uint8_t *)buf;
+  ring->size = size;
+  ring->width = width;
+  ring->type = type;
+  ring->policy = policy;
+  return PR_OK;
+}
+
+prism_err prism_ring_push(prism_ring_t *ring, const ui32 sample) {
+  const uint16_t head = ring->head;
+  uint16_t fill = (uint16_t)(head - __PRISM_RING_LOAD(ring->tail));
+
+  if (fill >= ring->size) {
+    if (ring->policy != PRISM_RING_BLOCK) {
+      ring->overruns++;
+      return PR_ERR_OUT_OF_MEMORY;
+    }
+    ring->waits++;
+    while (fill >= ring->size) {
+      fill = (uint16_t)(head - __PRISM_RING_LOAD(ring->tail));
+    }
+  }
+
+  uint8_t *slot = &ring->buf[(head & (ring->size - 1)) * ring->width];
+  if (ring->width == 4) {
+    memcpy(slot, &sample, sizeof(ui32));
+  } else if (ring->width == 2) {
+    const ui16 value = (ui16)sample;
+    memcpy(slot, &value, sizeof(ui16));
+  } else {
+    *slot = (ui8)sample;
+  }
+
+  ring->pushed++;
+  if (fill + 1 > ring->peak) {
+    ring->peak = fill + 1;
+  }
+  __PRISM_RING_PUBLISH(ring->head, (uint16_t)(head + 1));
+  return PR_OK;
+}
+
+uint16_t prism_ring_count(const prism_ring_t *ring) {
+  return (uint16_t)(__PRISM_RING_LOAD(ring->head) - ring->tail);
+}
+
+uint16_t prism_ring_read(prism_ring_t *ring, void *out, const uint16_t n) {
+  if (ring == 0 || out == 0) {
+    return 0;
+  }
+
+  const uint16_t tail = ring->tail;
+  uint16_t count = prism_ring_count(ring);
+  if (count > n) {
+    count = n;
+  }
+
+  // At most two pieces: up to the end of the buffer and from its start
+  const uint16_t first = tail & (ring->size - 1);
+  uint16_t piece = ring->size - first;
+  if (piece > count) {
+    piece = count;
+  }
+  memcpy(out, &ring->buf[first * ring->width], (size_t)piece * ring->width);
+  memcpy((uint8_t *)out + (size_t)piece * ring->width, ring->buf,
+         (size_t)(count - piece) * ring->width);
+
+  __PRISM_RING_PUBLISH(ring->tail, (uint16_t)(tail + count));
+  return count;
+}
+
+void prism_ring_stats(const prism_ring_t *ring, prism_ring_stats_t *stats) {
+  if (ring == 0 || stats == 0) {
+    return;
+  }
+  stats->fill = prism_ring_count(ring);
+  stats->peak = ring->peak;
+  stats->pushed = ring->pushed;
+  stats->overruns = ring->overruns;
+  stats->waits = ring->waits;
+}
+
+prism_err prism_pipeline_init(prism_pipeline_t *pipeline, prism_ring_t *ring,
+                              const prdev_t *device, const bank_t bank,
+                              const uint16_t high, const uint16_t low,
+                              prism_pipeline_fn process, void *user,
+                              ui32 timeout) {
+  if (pipeline == 0 || ring == 0 || device == 0 || process == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (bank != PRISM_BANK_A && bank != PRISM_BANK_B) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const uint16_t lanes = sizeof(_v256i) / ring->width;
+  if (high < lanes || high > ring->size || low >= high) {
+    return PR_ERR_INVALID_ARGUMENT; // A flush must see at least one window
+  }
+
+  memset(pipeline, 0, sizeof(prism_pipeline_t));
+  pipeline->ring = ring;
+  pipeline->device = device;
+  pipeline->bank = bank;
+  pipeline->lanes = lanes;
+  pipeline->high = high;
+  pipeline->low = low;
+  pipeline->process = process;
+  pipeline->user = user;
+  pipeline->timeout = timeout;
+  return PR_OK;
+}
+
+// Sends the next full window to the bank and runs the callback on it
+static prism_err __prism_pipeline_window(prism_pipeline_t *p) {
+  _v256i window;
+  prism_ring_read(p->ring, window.uib, p->lanes);
+  PRISM_TRY(_prism_send_bank_x(p->device, window, p->bank, p->timeout));
+  p->windows++;
+  return p->process(p->device, &window, p->user);
+}
+
+// Runs windows while enough samples are above the floor, at most one ring
+// capacity of them
+static prism_err __prism_pipeline_drain(prism_pipeline_t *p,
+                                        const uint16_t floor) {
+  uint16_t budget = p->ring->size / p->lanes;
+  uint16_t fill = prism_ring_count(p->ring);
+  while (budget-- > 0 && fill >= p->lanes && fill > floor) {
+    PRISM_TRY(__prism_pipeline_window(p));
+    fill = prism_ring_count(p->ring);
+  }
+  return PR_OK;
+}
+
+prism_err prism_pipeline_pump(prism_pipeline_t *pipeline) {
+  if (pipeline == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  uint16_t fill = prism_ring_count(pipeline->ring);
+  if (!pipeline->flushing && fill >= pipeline->high) {
+    pipeline->flushing = 1;
+  }
+  if (!pipeline->flushing) {
+    return PR_OK;
+  }
+
+  prism_err err = __prism_pipeline_drain(pipeline, pipeline->low);
+  fill = prism_ring_count(pipeline->ring);
+  if (fill <= pipeline->low || fill < pipeline->lanes) {
+    pipeline->flushing = 0;
+  }
+  return err;
+}
+
+prism_err prism_pipeline_flush(prism_pipeline_t *pipeline) {
+  if (pipeline == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  pipeline->flushing = 0;
+  return __prism_pipeline_drain(pipeline, 0);
+}
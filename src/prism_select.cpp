@@ -0,0 +1,167 @@
+#include "prism/prism_select.h"
+
+#include "prism_internal.h"
+
+static inline bool __prism_select_type_valid(const ui8 type) {
+  return type == PRISM_OPCODE_TYPE_UI32 || type == PRISM_OPCODE_TYPE_SI32;
+}
+
+// A = max(A, s) for unsigned lanes, also left in bank C:
+//   d = A - s, ge = (A >= d), max = s + ge * d
+static prism_err __prism_max_scalar(const prdev_t *dev, const ui32 s,
+                                    ui32 timeout) {
+  PRISM_TRY(_v256_sub_scalar_ui32(dev, s, 8, timeout)); // C = d
+  PRISM_TRY(_v256_store_ctob(dev, timeout));            // B = d
+  PRISM_TRY(_v256_cpm_geN_px(dev, 8, timeout));         // C = ge
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));            // A = ge
+  PRISM_TRY(_v256_mul8_ui32(dev, timeout));             // C = ge * d
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_v256_add_scalar_ui32(dev, s, 8, timeout)); // C = s + ge * d
+  return _v256_store_ctoa(dev, timeout);
+}
+
+// A = min(A, s) for unsigned lanes, also left in bank C:
+//   d = A - s, ge = (A >= d), min = s + d - ge * d = -((ge * d - d) - s)
+static prism_err __prism_min_scalar(const prdev_t *dev, const ui32 s,
+                                    ui32 timeout) {
+  PRISM_TRY(_v256_sub_scalar_ui32(dev, s, 8, timeout)); // C = d
+  PRISM_TRY(_v256_store_ctob(dev, timeout));            // B = d
+  PRISM_TRY(_v256_cpm_geN_px(dev, 8, timeout));         // C = ge
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));            // A = ge
+  PRISM_TRY(_v256_mul8_ui32(dev, timeout));             // C = ge * d
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_v256_sub8_ui32(dev, timeout)); // C = ge * d - d
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_v256_sub_scalar_ui32(dev, s, 8, timeout));
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_v256_cpm_cplN_px(dev, 8, timeout)); // C = s + d - ge * d
+  return _v256_store_ctoa(dev, timeout);
+}
+
+prism_err _prism_minmax_bank_a(const prdev_t *dev, const bool is_max,
+                               const ui32 *b, ui32 timeout) {
+  if (dev == 0 || b == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, b, PRISM_BANK_B, timeout));
+  PRISM_TRY(_v256_sub8_ui32(dev, timeout));     // C = d
+  PRISM_TRY(_v256_store_ctob(dev, timeout));    // B = d, A = a
+  PRISM_TRY(_v256_cpm_geN_px(dev, 8, timeout)); // C = ge
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));    // A = ge
+  PRISM_TRY(_v256_mul8_ui32(dev, timeout));     // C = ge * d
+
+  if (!is_max) {
+    PRISM_TRY(_v256_store_ctoa(dev, timeout)); // A = ge * d, B = d
+    PRISM_TRY(_v256_sub8_ui32(dev, timeout));  // C = ge * d - d
+  }
+
+  PRISM_TRY(_v256_store_ctob(dev, timeout));
+  PRISM_TRY(_prism_send_bank_ptr(dev, b, PRISM_BANK_A, timeout));
+  PRISM_TRY(is_max ? _v256_add8_ui32(dev, timeout)
+                   : _v256_sub8_ui32(dev, timeout));
+  return _v256_store_ctoa(dev, timeout);
+}
+
+prism_err _v256_select_v(const prdev_t *dev, const ui8 type, const _v256i *a,
+                         const _v256i *b, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_select_type_valid(type)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  _v256i diff;
+  for (uint8_t i = 0; i < 8; i++) {
+    diff.ui[i] = a->ui[i] ^ b->ui[i];
+  }
+
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));     // A = mask (0/1)
+  PRISM_TRY(_v256_cpm_cplN_px(dev, 8, timeout)); // C = -mask (all-ones)
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_prism_send_bank_ptr(dev, diff.ui, PRISM_BANK_B, timeout));
+  PRISM_TRY(_v256_andN_ui32(dev, type, 8, timeout)); // C = (a ^ b) & mask
+  PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  PRISM_TRY(_prism_send_bank_ptr(dev, b->ui, PRISM_BANK_B, timeout));
+  return _v256_xorN_ui32(dev, type, 8, timeout); // C = mask ? a : b
+}
+
+prism_err _v256_blend_v(const prdev_t *dev, const ui8 type,
+                        const _v256i *mask, const _v256i *a, const _v256i *b,
+                        ui32 timeout) {
+  if (dev == 0 || mask == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, mask->ui, PRISM_BANK_A, timeout));
+  PRISM_TRY(_v256_or_scalar_ui32(dev, 0, 8, timeout)); // C = mask
+  return _v256_select_v(dev, type, a, b, timeout);
+}
+
+prism_err _v256_minmax_v(const prdev_t *dev, const ui8 type, const bool is_max,
+                         const _v256i *a, const _v256i *b, ui32 timeout) {
+  if (dev == 0 || a == 0 || b == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_select_type_valid(type)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const bool biased = (type == PRISM_OPCODE_TYPE_SI32);
+  const ui32 *lhs = a->ui;
+  const ui32 *rhs = b->ui;
+  _v256i biased_a, biased_b;
+
+  if (biased) {
+    for (uint8_t i = 0; i < 8; i++) {
+      biased_a.ui[i] = a->ui[i] ^ PRISM_SIGN_BIAS;
+      biased_b.ui[i] = b->ui[i] ^ PRISM_SIGN_BIAS;
+    }
+    lhs = biased_a.ui;
+    rhs = biased_b.ui;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  PRISM_TRY(_prism_send_bank_ptr(dev, lhs, PRISM_BANK_A, timeout));
+  PRISM_TRY(_prism_minmax_bank_a(dev, is_max, rhs, timeout));
+  if (biased) {
+    PRISM_TRY(_v256_xor_scalar_ui32(dev, PRISM_SIGN_BIAS, 8, timeout));
+  }
+  return _v256_set_caop(dev, timeout);
+}
+
+prism_err _v256_clamp_bank_a(const prdev_t *dev, const ui8 type, const ui32 lo,
+                             const ui32 hi, ui32 timeout) {
+  if (dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!__prism_select_type_valid(type)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const bool biased = (type == PRISM_OPCODE_TYPE_SI32);
+  const ui32 bias = biased ? PRISM_SIGN_BIAS : 0;
+
+  PRISM_TRY(_v256_set_ncaop(dev, timeout));
+  if (biased) {
+    PRISM_TRY(_v256_xor_scalar_ui32(dev, bias, 8, timeout));
+    PRISM_TRY(_v256_store_ctoa(dev, timeout));
+  }
+  PRISM_TRY(__prism_max_scalar(dev, lo ^ bias, timeout));
+  PRISM_TRY(__prism_min_scalar(dev, hi ^ bias, timeout));
+  if (biased) {
+    PRISM_TRY(_v256_xor_scalar_ui32(dev, bias, 8, timeout));
+  }
+  return _v256_set_caop(dev, timeout);
+}
+
+prism_err _v256_clamp_v(const prdev_t *dev, const ui8 type, const _v256i *x,
+                        const ui32 lo, const ui32 hi, ui32 timeout) {
+  if (dev == 0 || x == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, x->ui, PRISM_BANK_A, timeout));
+  return _v256_clamp_bank_a(dev, type, lo, hi, timeout);
+}
@@ -0,0 +1,404 @@
+#include "prism/prism_sort.h"
+
+#include "prism_internal.h"
+
+#include <string.h>
+
+// Comparators of one network stage, staged until the banks are full
+typedef struct prism_sort_net {
+  const prdev_t *device;
+  ui32 timeout;
+  ui8 op_type; // Unsigned lane type of the elements
+  ui8 width;   // Bytes per element
+  ui8 lanes;   // Comparators per device round
+  ui8 pending;
+  ui32 bias; // Sign bit of signed elements, 0 otherwise
+  ui8 *lo[32];
+  ui8 *hi[32];
+  _v256i a, b;
+} prism_sort_net_t;
+
+static bool __prism_sort_net_init(prism_sort_net_t *net, const prdev_t *dev,
+                                  const ui8 type, ui32 timeout) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_UI32:
+  case PRISM_OPCODE_TYPE_SI32:
+    net->op_type = PRISM_OPCODE_TYPE_UI32;
+    net->width = 4;
+    break;
+  case PRISM_OPCODE_TYPE_UI16:
+  case PRISM_OPCODE_TYPE_SI16:
+    net->op_type = PRISM_OPCODE_TYPE_UI16;
+    net->width = 2;
+    break;
+  case PRISM_OPCODE_TYPE_UI8:
+  case PRISM_OPCODE_TYPE_SI8:
+    net->op_type = PRISM_OPCODE_TYPE_UI8;
+    net->width = 1;
+    break;
+  default:
+    return false;
+  }
+
+  const bool is_signed = type == PRISM_OPCODE_TYPE_SI32 ||
+                         type == PRISM_OPCODE_TYPE_SI16 ||
+                         type == PRISM_OPCODE_TYPE_SI8;
+  net->device = dev;
+  net->timeout = timeout;
+  net->lanes = 32 / net->width;
+  net->pending = 0;
+  net->bias = is_signed ? (ui32)1 << (net->width * 8 - 1) : 0;
+  return true;
+}
+
+static inline ui32 __prism_sort_get(const ui8 *p, const ui8 width) {
+  if (width == 1) {
+    return *p;
+  }
+  if (width == 2) {
+    ui16 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  ui32 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void __prism_sort_put(ui8 *p, const ui8 width, const ui32 v) {
+  if (width == 1) {
+    *p = (ui8)v;
+  } else if (width == 2) {
+    const ui16 w = (ui16)v;
+    memcpy(p, &w, sizeof(w));
+  } else {
+    memcpy(p, &v, sizeof(v));
+  }
+}
+
+static inline ui32 __prism_sort_lane(const _v256i *v, const ui8 width,
+                                     const ui8 i) {
+  return width == 1 ? v->uib[i] : width == 2 ? v->uix[i] : v->ui[i];
+}
+
+static inline void __prism_sort_set_lane(_v256i *v, const ui8 width,
+                                         const ui8 i, const ui32 x) {
+  if (width == 1) {
+    v->uib[i] = (ui8)x;
+  } else if (width == 2) {
+    v->uix[i] = (ui16)x;
+  } else {
+    v->ui[i] = x;
+  }
+}
+
+// Key of an element in unsigned order
+static inline ui32 __prism_sort_key(const prism_sort_net_t *net,
+                                    const ui8 *p) {
+  return __prism_sort_get(p, net->width) ^ net->bias;
+}
+
+// Runs the staged comparators. Expects no-clear-after-op mode:
+//   d = a - b, ge = (a >= d), t = ge * d, lo -= t, hi += t
+static prism_err __prism_sort_flush(prism_sort_net_t *net) {
+  if (net->pending == 0) {
+    return PR_OK;
+  }
+
+  const prdev_t *dev = net->device;
+  const ui32 t = net->timeout;
+  _v256i swap;
+
+  PRISM_TRY(_prism_send_bank_ptr(dev, net->a.ui, PRISM_BANK_A, t));
+  PRISM_TRY(_prism_send_bank_ptr(dev, net->b.ui, PRISM_BANK_B, t));
+  PRISM_TRY(prism_op(dev, PRISM_OPCODE_SUB_N, net->op_type, 8, 0, t));
+  PRISM_TRY(_v256_store_ctob(dev, t));
+  PRISM_TRY(prism_op(dev, PRISM_OPCODE_CMP_GE, net->op_type, 8, 0, t));
+  PRISM_TRY(_v256_store_ctoa(dev, t));
+  PRISM_TRY(prism_op(dev, PRISM_OPCODE_MUL_N, net->op_type, 8, 0, t));
+  PRISM_TRY(_prism_load_bank_ptr(dev, PRISM_BANK_C, swap.ui, t));
+
+  const ui8 width = net->width;
+  for (ui8 i = 0; i < net->pending; i++) {
+    const ui32 d = __prism_sort_lane(&swap, width, i);
+    if (d != 0) {
+      __prism_sort_put(net->lo[i], width,
+                       __prism_sort_get(net->lo[i], width) - d);
+      __prism_sort_put(net->hi[i], width,
+                       __prism_sort_get(net->hi[i], width) + d);
+    }
+  }
+  net->pending = 0;
+  return PR_OK;
+}
+
+// Stages a comparator that leaves the smaller element in lo
+static prism_err __prism_sort_cmpxchg(prism_sort_net_t *net, ui8 *lo,
+                                      ui8 *hi) {
+  const ui8 i = net->pending;
+  __prism_sort_set_lane(&net->a, net->width, i, __prism_sort_key(net, lo));
+  __prism_sort_set_lane(&net->b, net->width, i, __prism_sort_key(net, hi));
+  net->lo[i] = lo;
+  net->hi[i] = hi;
+  if (++net->pending == net->lanes) {
+    return __prism_sort_flush(net);
+  }
+  return PR_OK;
+}
+
+// Stages the comparators (i, i ^ mask) of one stage over n elements. Elements
+// past n act as +infinity, so their comparators are skipped.
+static prism_err __prism_sort_stage(prism_sort_net_t *net, ui8 *base,
+                                    const size_t n, const size_t mask) {
+  for (size_t i = 0; i < n; i++) {
+    const size_t l = i ^ mask;
+    if (l > i && l < n) {
+      PRISM_TRY(__prism_sort_cmpxchg(net, base + i * net->width,
+                                     base + l * net->width));
+    }
+  }
+  return PR_OK;
+}
+
+// Bitonic network with ascending comparators: a merge of size k starts with
+// mask k - 1 and halves from k / 4 down to 1. The arrays are stride elements
+// apart, the last one may be shorter than n.
+static prism_err __prism_sort_networks(prism_sort_net_t *net, ui8 *base,
+                                       const size_t count, const size_t n,
+                                       const size_t total) {
+  for (size_t k = 2; k / 2 < n; k <<= 1) {
+    for (size_t mask = k - 1; mask != 0;
+         mask = (mask == k - 1) ? k / 4 : mask / 2) {
+      for (size_t r = 0; r < count; r++) {
+        const size_t first = r * n;
+        const size_t len = (total - first < n) ? total - first : n;
+        PRISM_TRY(
+            __prism_sort_stage(net, base + first * net->width, len, mask));
+      }
+      PRISM_TRY(__prism_sort_flush(net));
+    }
+  }
+  return PR_OK;
+}
+
+// Runs the networks in no-clear-after-op mode, CMP_GE needs bank A
+static prism_err __prism_sort_run(prism_sort_net_t *net, ui8 *base,
+                                  const size_t count, const size_t n,
+                                  const size_t total) {
+  PRISM_TRY(_v256_set_ncaop(net->device, net->timeout));
+  prism_err err = __prism_sort_networks(net, base, count, n, total);
+  prism_err restore = _v256_set_caop(net->device, net->timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+prism_err _v256_sort_v(const prdev_t *dev, const ui8 type, _v256i *v,
+                       ui32 timeout) {
+  if (dev == 0 || v == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, dev, type, timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  return __prism_sort_run(&net, v->uib, 1, net.lanes, net.lanes);
+}
+
+prism_err prism_sort_batch(const prdev_t *dev, const ui8 type, void *data,
+                           const size_t count, const size_t n, ui32 timeout) {
+  if (dev == 0 || (data == 0 && count != 0 && n != 0)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, dev, type, timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (count == 0 || n < 2) {
+    return PR_OK;
+  }
+  return __prism_sort_run(&net, (ui8 *)data, count, n, count * n);
+}
+
+// Merges the sorted runs [0, mid) and [mid, n) of src into dst
+static void __prism_sort_merge(const prism_sort_net_t *net, const ui8 *src,
+                               ui8 *dst, const size_t mid, const size_t n) {
+  const ui8 w = net->width;
+  size_t i = 0, j = mid;
+  for (size_t o = 0; o < n; o++) {
+    const bool left =
+        j >= n || (i < mid && __prism_sort_key(net, src + i * w) <=
+                                  __prism_sort_key(net, src + j * w));
+    const size_t from = left ? i++ : j++;
+    memcpy(dst + o * w, src + from * w, w);
+  }
+}
+
+prism_err prism_sort(const prdev_t *dev, const ui8 type, void *data,
+                     const size_t n, void *scratch, ui32 timeout) {
+  if (dev == 0 || (data == 0 && n != 0)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, dev, type, timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (n > net.lanes && scratch == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (n < 2) {
+    return PR_OK;
+  }
+
+  ui8 *src = (ui8 *)data;
+  const size_t run = net.lanes;
+  PRISM_TRY(__prism_sort_run(&net, src, (n + run - 1) / run, run, n));
+
+  // Bottom-up merge passes, swapping data and scratch
+  ui8 *dst = (ui8 *)scratch;
+  const ui8 w = net.width;
+  for (size_t len = run; len < n; len *= 2) {
+    for (size_t first = 0; first < n; first += 2 * len) {
+      const size_t left = (n - first < len) ? n - first : len;
+      const size_t span = (n - first < 2 * len) ? n - first : 2 * len;
+      __prism_sort_merge(&net, src + first * w, dst + first * w, left, span);
+    }
+    ui8 *swap = src;
+    src = dst;
+    dst = swap;
+  }
+  if (src != (ui8 *)data) {
+    memcpy(data, src, n * w);
+  }
+  return PR_OK;
+}
+
+prism_err prism_topk_init(prism_topk_t *ctx, const prdev_t *dev,
+                          const ui8 type, const ui8 k, ui32 timeout) {
+  if (ctx == 0 || dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, dev, type, timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (k == 0 || k > net.lanes) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  ctx->device = dev;
+  ctx->type = type;
+  ctx->k = k;
+  ctx->timeout = timeout;
+  prism_topk_reset(ctx);
+  return PR_OK;
+}
+
+void prism_topk_reset(prism_topk_t *ctx) {
+  if (ctx == 0) {
+    return;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, ctx->device, ctx->type, ctx->timeout)) {
+    return;
+  }
+
+  // The smallest element of the type, sign bit alone for signed elements
+  for (ui8 i = 0; i < net.lanes; i++) {
+    __prism_sort_set_lane(&ctx->best, net.width, i, net.bias);
+  }
+  ctx->pending = 0;
+  ctx->seen = 0;
+}
+
+// Sorts the candidates, keeps the larger half of best and block as a bitonic
+// sequence in best and sorts it with the half-cleaner stages
+static prism_err __prism_topk_merge(prism_topk_t *ctx,
+                                    prism_sort_net_t *net) {
+  const ui8 lanes = net->lanes;
+  const ui8 w = net->width;
+  ui8 *best = ctx->best.uib;
+  ui8 *block = ctx->block.uib;
+
+  for (ui8 i = ctx->pending; i < lanes; i++) {
+    __prism_sort_set_lane(&ctx->block, w, i, net->bias);
+  }
+
+  PRISM_TRY(__prism_sort_networks(net, block, 1, lanes, lanes));
+  for (ui8 i = 0; i < lanes; i++) {
+    PRISM_TRY(__prism_sort_cmpxchg(net, block + (lanes - 1 - i) * w,
+                                   best + i * w));
+  }
+  PRISM_TRY(__prism_sort_flush(net));
+  for (size_t mask = lanes / 2; mask != 0; mask /= 2) {
+    PRISM_TRY(__prism_sort_stage(net, best, lanes, mask));
+    PRISM_TRY(__prism_sort_flush(net));
+  }
+  ctx->pending = 0;
+  return PR_OK;
+}
+
+static prism_err __prism_topk_flush(prism_topk_t *ctx) {
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, ctx->device, ctx->type, ctx->timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  PRISM_TRY(_v256_set_ncaop(ctx->device, ctx->timeout));
+  prism_err err = __prism_topk_merge(ctx, &net);
+  prism_err restore = _v256_set_caop(ctx->device, ctx->timeout);
+  return (err != PR_OK) ? err : restore;
+}
+
+prism_err prism_topk_push(prism_topk_t *ctx, const void *x, const size_t n) {
+  if (ctx == 0 || (x == 0 && n != 0)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, ctx->device, ctx->type, ctx->timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const ui8 w = net.width;
+  const ui8 *src = (const ui8 *)x;
+  for (size_t i = 0; i < n; i++) {
+    // Candidates not above the k-th largest cannot enter the set
+    const ui8 *kth = ctx->best.uib + (net.lanes - ctx->k) * w;
+    if (__prism_sort_key(&net, src + i * w) <= __prism_sort_key(&net, kth)) {
+      continue;
+    }
+
+    memcpy(ctx->block.uib + ctx->pending * w, src + i * w, w);
+    if (++ctx->pending == net.lanes) {
+      PRISM_TRY(__prism_topk_flush(ctx));
+    }
+  }
+  ctx->seen += n;
+  return PR_OK;
+}
+
+prism_err prism_topk_read(prism_topk_t *ctx, void *out, ui8 *count) {
+  if (ctx == 0 || out == 0 || count == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  if (ctx->pending != 0) {
+    PRISM_TRY(__prism_topk_flush(ctx));
+  }
+
+  prism_sort_net_t net;
+  if (!__prism_sort_net_init(&net, ctx->device, ctx->type, ctx->timeout)) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  const ui8 w = net.width;
+  *count = (ctx->seen < ctx->k) ? (ui8)ctx->seen : ctx->k;
+  for (ui8 i = 0; i < *count; i++) {
+    memcpy((ui8 *)out + i * w, ctx->best.uib + (net.lanes - 1 - i) * w, w);
+  }
+  return PR_OK;
+}
@@ -0,0 +1,110 @@
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
+
+#include "Arduino.h"
+#include <Wire.h>
+
+// Bytes the Wire library buffers per transaction
+#if defined(I2C_BUFFER_LENGTH)
+#define __PRISM_I2C_BUFFER I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define __PRISM_I2C_BUFFER BUFFER_LENGTH
+#else
+#define __PRISM_I2C_BUFFER 32
+#endif
+
+// First byte of every bank data chunk written to the device
+#define __PRISM_I2C_FRAME_DATA (0xDA)
+// Bank data per write, one byte of the buffer holds the frame marker
+#define __PRISM_I2C_CHUNK (__PRISM_I2C_BUFFER - 1)
+
+// Longest wait for a status byte, the fixed wait of the P²Link backend
+#define __PRISM_I2C_STATUS_WAIT_US (50000UL)
+
+prism_err _prism_i2c_send_command(const prdev_t *dev, const uint8_t *frame,
+                                  size_t len) {
+  Wire.beginTransmission(dev->address); // Start Übertragung zum PCF8574
+  Wire.write(frame, len);               // Wert schreiben
+  uint8_t err = Wire.endTransmission(); // End transmission
+
+  if (err != 0) {
+    return PR_ERR_UNKNOWN; // Transmission error
+  }
+  return PR_OK;
+}
+
+// Reads the status byte once without waiting, PRISM_STATUS_BUSY if the device
+// is not done yet
+static prism_err __prism_i2c_poll_status(const prdev_t *dev,
+                                         uint8_t *status) {
+  // The device NACKs or answers busy until the frame is processed
+  *status = PRISM_STATUS_BUSY;
+  if (Wire.requestFrom(dev->address, (uint8_t)1) == 1 &&
+      Wire.available() != 0) {
+    *status = Wire.read();
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_i2c_read_status(const prdev_t *dev,
+                                         uint8_t *status) {
+  // Poll instead of a fixed delay
+  unsigned long start = micros();
+  do {
+    uint8_t value = PRISM_STATUS_BUSY;
+    __prism_i2c_poll_status(dev, &value);
+    if (value != PRISM_STATUS_BUSY) {
+      *status = value;
+      return PR_OK;
+    }
+  } while ((micros() - start) < __PRISM_I2C_STATUS_WAIT_US);
+
+  return PR_ERR_UNKNOWN; // Device not responding
+}
+
+static prism_err __prism_i2c_write_block(const prdev_t *dev,
+                                         const uint8_t *data, size_t len) {
+  for (size_t pos = 0; pos < len; pos += __PRISM_I2C_CHUNK) {
+    size_t chunk = len - pos;
+    if (chunk > __PRISM_I2C_CHUNK) {
+      chunk = __PRISM_I2C_CHUNK;
+    }
+
+    Wire.beginTransmission(dev->address);
+    Wire.write((uint8_t)__PRISM_I2C_FRAME_DATA);
+    Wire.write(&data[pos], chunk);
+    if (Wire.endTransmission() != 0) {
+      return PR_ERR_UNKNOWN; // Transmission error
+    }
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_i2c_read_block(const prdev_t *dev, uint8_t *data,
+                                        size_t len) {
+  for (size_t pos = 0; pos < len; pos += __PRISM_I2C_BUFFER) {
+    size_t chunk = len - pos;
+    if (chunk > __PRISM_I2C_BUFFER) {
+      chunk = __PRISM_I2C_BUFFER;
+    }
+
+    if (Wire.requestFrom(dev->address, (uint8_t)chunk) != chunk) {
+      return PR_ERR_UNKNOWN; // Device not responding
+    }
+    for (size_t i = 0; i < chunk; i++) {
+      data[pos + i] = Wire.read();
+    }
+  }
+  return PR_OK;
+}
+
+const prism_transport_t prism_transport_i2c = {
+    .name = "i2c",
+    .send_command = _prism_i2c_send_command,
+    .read_status = __prism_i2c_read_status,
+    .write_block = __prism_i2c_write_block,
+    .read_block = __prism_i2c_read_block,
+    .exchange_block = 0,
+    .begin = 0,
+    .poll_status = __prism_i2c_poll_status};
@@ -0,0 +1,599 @@
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
+
+#ifdef PRISM_ENABLE_IEE754
+#include "prism/prism_float.h"
+#endif
+
+#include <string.h>
+
+// Marks that no STORE or LOAD is running
+#define __PRISM_LOOPBACK_NO_XFER (0xFF)
+// Marks that the descriptor of PRISM_OPCODE_ARCH_DESCRIBE is being read
+#define __PRISM_LOOPBACK_XFER_DESCRIBE (0xFE)
+
+static prism_loopback_t *__prism_loopback_state(const prdev_t *dev) {
+  return (prism_loopback_t *)dev->transport_ctx;
+}
+
+// Width of one lane in bytes, 0 for types the emulation does not know
+static uint8_t __prism_loopback_width(const ui8 type) {
+  switch (type) {
+  case PRISM_OPCODE_TYPE_UI32:
+  case PRISM_OPCODE_TYPE_SI32:
+    return 4;
+  case PRISM_OPCODE_TYPE_UI16:
+  case PRISM_OPCODE_TYPE_SI16:
+    return 2;
+  case PRISM_OPCODE_TYPE_UI8:
+  case PRISM_OPCODE_TYPE_SI8:
+    return 1;
+#ifdef PRISM_ENABLE_IEE754
+  case PRISM_OPCODE_TYPE_FL:
+    return 4;
+  case PRISM_OPCODE_TYPE_HF:
+    return 2;
+#endif
+  default:
+    return 0;
+  }
+}
+
+static bool __prism_loopback_signed(const ui8 type) {
+  return type == PRISM_OPCODE_TYPE_SI32 || type == PRISM_OPCODE_TYPE_SI16 ||
+         type == PRISM_OPCODE_TYPE_SI8;
+}
+
+static uint32_t __prism_loopback_get(const _v256i *v, const uint8_t width,
+                                     const uint8_t i) {
+  if (width == 4) {
+    return v->ui[i];
+  }
+  if (width == 2) {
+    return v->uix[i];
+  }
+  return v->uib[i];
+}
+
+static void __prism_loopback_put(_v256i *v, const uint8_t width,
+                                 const uint8_t i, const uint32_t value) {
+  if (width == 4) {
+    v->ui[i] = value;
+  } else if (width == 2) {
+    v->uix[i] = (ui16)value;
+  } else {
+    v->uib[i] = (ui8)value;
+  }
+}
+
+// Sign-extends a lane so signed compares and divisions see its real value
+static int32_t __prism_loopback_sext(const uint32_t value,
+                                     const uint8_t width) {
+  if (width == 4) {
+    return (int32_t)value;
+  }
+  if (width == 2) {
+    return (int16_t)value;
+  }
+  return (int8_t)value;
+}
+
+// Computes one lane, returns false for opcodes that are not lane operations
+static bool __prism_loopback_lane(const uint16_t op, const bool is_signed,
+                                  const uint8_t width, const uint32_t a,
+                                  const uint32_t b, uint32_t *c) {
+  const int32_t sa = __prism_loopback_sext(a, width);
+  const int32_t sb = __prism_loopback_sext(b, width);
+
+  switch (op) {
+  case PRISM_OPCODE_ADD_N:
+  case PRISM_OPCODE_ADD_S:
+    *c = a + b;
+    return true;
+  case PRISM_OPCODE_SUB_N:
+  case PRISM_OPCODE_SUB_S:
+    *c = a - b;
+    return true;
+  case PRISM_OPCODE_MUL_N:
+  case PRISM_OPCODE_MUL_S:
+    *c = a * b;
+    return true;
+  case PRISM_OPCODE_DIV_N:
+  case PRISM_OPCODE_DIV_S:
+    if (b == 0) {
+      *c = 0;
+    } else if (is_signed) {
+      *c = (sa == INT32_MIN && sb == -1) ? a : (uint32_t)(sa / sb);
+    } else {
+      *c = a / b;
+    }
+    return true;
+  case PRISM_OPCODE_AND_N:
+  case PRISM_OPCODE_AND_S:
+    *c = a & b;
+    return true;
+  case PRISM_OPCODE_NAND_N:
+  case PRISM_OPCODE_NAND_S:
+    *c = ~(a & b);
+    return true;
+  case PRISM_OPCODE_OR_N:
+  case PRISM_OPCODE_OR_S:
+    *c = a | b;
+    return true;
+  case PRISM_OPCODE_XOR_N:
+  case PRISM_OPCODE_XOR_S:
+    *c = a ^ b;
+    return true;
+  case PRISM_OPCODE_NOR_N:
+  case PRISM_OPCODE_NOR_S:
+    *c = ~(a | b);
+    return true;
+  case PRISM_OPCODE_CMP_EQ:
+  case PRISM_OPCODE_CMP_EQ_S:
+    *c = (a == b);
+    return true;
+  case PRISM_OPCODE_CMP_NE:
+  case PRISM_OPCODE_CMP_NE_S:
+    *c = (a != b);
+    return true;
+  case PRISM_OPCODE_CMP_GT:
+  case PRISM_OPCODE_CMP_GT_S:
+    *c = is_signed ? (sa > sb) : (a > b);
+    return true;
+  case PRISM_OPCODE_CMP_GE:
+  case PRISM_OPCODE_CMP_GE_S:
+    *c = is_signed ? (sa >= sb) : (a >= b);
+    return true;
+  case PRISM_OPCODE_CMP_LT:
+  case PRISM_OPCODE_CMP_LT_S:
+    *c = is_signed ? (sa < sb) : (a < b);
+    return true;
+  case PRISM_OPCODE_CMP_LE:
+  case PRISM_OPCODE_CMP_LE_S:
+    *c = is_signed ? (sa <= sb) : (a <= b);
+    return true;
+  case PRISM_OPCODE_NOT_N:
+    *c = ~a;
+    return true;
+  case PRISM_OPCODE_CPL2:
+    *c = 0 - a;
+    return true;
+  case PRISM_OPCODE_SHIFT_L:
+    *c = (b >= 32) ? 0 : a << b;
+    return true;
+  case PRISM_OPCODE_SHIFT_R:
+    *c = (b >= 32) ? 0 : a >> b;
+    return true;
+  default:
+    return false;
+  }
+}
+
+#ifdef PRISM_ENABLE_IEE754
+static float __prism_loopback_to_float(const ui8 type, const uint32_t bits) {
+  if (type == PRISM_OPCODE_TYPE_HF) {
+    return prism_half_to_float((ui16)bits);
+  }
+  float x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+// Computes one float lane, returns false for opcodes that work on the bits
+static bool __prism_loopback_float_lane(const uint16_t op, const ui8 type,
+                                        const uint32_t a, const uint32_t b,
+                                        uint32_t *c) {
+  const float fa = __prism_loopback_to_float(type, a);
+  const float fb = __prism_loopback_to_float(type, b);
+  float fc;
+
+  switch (op) {
+  case PRISM_OPCODE_ADD_N:
+  case PRISM_OPCODE_ADD_S:
+    fc = fa + fb;
+    break;
+  case PRISM_OPCODE_SUB_N:
+  case PRISM_OPCODE_SUB_S:
+    fc = fa - fb;
+    break;
+  case PRISM_OPCODE_MUL_N:
+  case PRISM_OPCODE_MUL_S:
+    fc = fa * fb;
+    break;
+  case PRISM_OPCODE_DIV_N:
+  case PRISM_OPCODE_DIV_S:
+    fc = fa / fb;
+    break;
+  // Compares write the integer 1, as for integer lanes
+  case PRISM_OPCODE_CMP_EQ:
+  case PRISM_OPCODE_CMP_EQ_S:
+    *c = (fa == fb);
+    return true;
+  case PRISM_OPCODE_CMP_NE:
+  case PRISM_OPCODE_CMP_NE_S:
+    *c = (fa != fb);
+    return true;
+  case PRISM_OPCODE_CMP_GT:
+  case PRISM_OPCODE_CMP_GT_S:
+    *c = (fa > fb);
+    return true;
+  case PRISM_OPCODE_CMP_GE:
+  case PRISM_OPCODE_CMP_GE_S:
+    *c = (fa >= fb);
+    return true;
+  case PRISM_OPCODE_CMP_LT:
+  case PRISM_OPCODE_CMP_LT_S:
+    *c = (fa < fb);
+    return true;
+  case PRISM_OPCODE_CMP_LE:
+  case PRISM_OPCODE_CMP_LE_S:
+    *c = (fa <= fb);
+    return true;
+  default:
+    return false;
+  }
+
+  if (type == PRISM_OPCODE_TYPE_HF) {
+    *c = prism_half_from_float(fc);
+  } else {
+    memcpy(c, &fc, sizeof(fc));
+  }
+  return true;
+}
+#endif // PRISM_ENABLE_IEE754
+
+// Byte i of the descriptor the emulation reports
+static uint8_t __prism_loopback_describe(const uint8_t i) {
+  uint16_t lanes = PRISM_LANES_BASE;
+#ifdef PRISM_ENABLE_IEE754
+  lanes |= PRISM_LANE_FL | PRISM_LANE_HF;
+#endif
+  const uint32_t features = PRISM_FEATURES_BASE | PRISM_FEATURE_SCALAR |
+                            PRISM_FEATURE_SPLAT | PRISM_FEATURE_CRC |
+                            PRISM_FEATURE_PEEK;
+
+  switch (i) {
+  case 0:
+    return PRISM_VERSION_MAJOR;
+  case 1:
+    return PRISM_VERSION_MINOR;
+  case 2:
+    return PRISM_VERSION_PATCH;
+  case 3:
+    return 0; // No parallel bus, no flank
+  case 4:
+    return PRISM_PROTOCOL_VERSION;
+  case 5:
+    return PRISM_BANK_MAX;
+  case 6:
+  case 7:
+    return (uint8_t)(lanes >> ((i - 6) * 8));
+  default:
+    return (uint8_t)(features >> ((i - 8) * 8));
+  }
+}
+
+static bool __prism_loopback_is_scalar(const uint16_t op) {
+  return (op >= PRISM_OPCODE_ADD_S && op <= PRISM_OPCODE_NOR_S) ||
+         (op >= PRISM_OPCODE_CMP_EQ_S && op <= PRISM_OPCODE_CMP_LE_S);
+}
+
+// Runs a lane operation on A and B (or the immediate) into C
+static uint8_t __prism_loopback_execute(prism_loopback_t *lb,
+                                        const uint16_t op, const ui8 type,
+                                        const ui8 arg, const uint32_t imm,
+                                        const bool has_imm) {
+  const uint8_t width = __prism_loopback_width(type);
+  if (width == 0) {
+    return PRISM_STATUS_FAIL;
+  }
+
+  const bool is_signed = __prism_loopback_signed(type);
+  const bool is_shift =
+      (op == PRISM_OPCODE_SHIFT_L || op == PRISM_OPCODE_SHIFT_R);
+  if (__prism_loopback_is_scalar(op) && !has_imm) {
+    return PRISM_STATUS_FAIL;
+  }
+
+  // arg counts 32-bit units, 0 and everything above 8 selects all of them.
+  // Shifts use arg as shift count and always run over the full vector.
+  uint8_t units = (arg == 0 || arg > 8) ? 8 : arg;
+  if (is_shift) {
+    units = 8;
+  }
+  const uint8_t lanes = (uint8_t)(units * 4 / width);
+
+  _v256i result = lb->bank[PRISM_BANK_C];
+  for (uint8_t i = 0; i < lanes; i++) {
+    uint32_t a = __prism_loopback_get(&lb->bank[PRISM_BANK_A], width, i);
+    uint32_t b = __prism_loopback_get(&lb->bank[PRISM_BANK_B], width, i);
+    uint32_t c = 0;
+
+    if (__prism_loopback_is_scalar(op)) {
+      b = imm;
+    } else if (is_shift) {
+      b = arg;
+    }
+    if (width < 4) {
+      b &= (1UL << (width * 8)) - 1; // Immediates are truncated to the lane
+    }
+#ifdef PRISM_ENABLE_IEE754
+    if ((type == PRISM_OPCODE_TYPE_FL || type == PRISM_OPCODE_TYPE_HF) &&
+        __prism_loopback_float_lane(op, type, a, b, &c)) {
+      __prism_loopback_put(&result, width, i, c);
+      continue;
+    }
+#endif
+    if (!__prism_loopback_lane(op, is_signed, width, a, b, &c)) {
+      return PRISM_STATUS_FAIL;
+    }
+    __prism_loopback_put(&result, width, i, c);
+  }
+  lb->bank[PRISM_BANK_C] = result;
+
+  if (lb->clear_after_op) {
+    memset(&lb->bank[PRISM_BANK_A], 0, sizeof(_v256i));
+    memset(&lb->bank[PRISM_BANK_B], 0, sizeof(_v256i));
+  }
+  return PRISM_STATUS_OK;
+}
+
+static uint8_t __prism_loopback_begin(prism_loopback_t *lb,
+                                      const uint8_t bank, const bool store) {
+  lb->xfer_bank = bank;
+  lb->xfer_pos = 0;
+  lb->xfer_store = store;
+  return PRISM_STATUS_OK;
+}
+
+// Bytes of one bank transfer, with the CRC if it is enabled
+static uint8_t __prism_loopback_block_size(const prism_loopback_t *lb) {
+  return (uint8_t)(sizeof(_v256i) + (lb->link_crc ? 2 : 0));
+}
+
+// Writes the data of a STORE to its bank if it arrived intact
+static uint8_t __prism_loopback_commit(prism_loopback_t *lb) {
+  if (lb->link_crc) {
+    const ui16 crc = _prism_crc16(PRISM_CRC16_INIT, lb->rx, sizeof(_v256i));
+    if (lb->rx[sizeof(_v256i)] != (uint8_t)crc ||
+        lb->rx[sizeof(_v256i) + 1] != (uint8_t)(crc >> 8)) {
+      return PRISM_STATUS_CRC; // The bank keeps its old data
+    }
+  }
+  memcpy(&lb->bank[lb->xfer_bank], lb->rx, sizeof(_v256i));
+  return PRISM_STATUS_OK;
+}
+
+// Flips a bit of the first byte of a block while corrupt is set
+static uint8_t __prism_loopback_damage(prism_loopback_t *lb,
+                                       const uint8_t byte) {
+  if (lb->xfer_pos != 0 || lb->corrupt == 0) {
+    return byte;
+  }
+  lb->corrupt--;
+  return byte ^ 0x01;
+}
+
+static uint8_t __prism_loopback_process(prism_loopback_t *lb,
+                                        const uint16_t op, const ui8 type,
+                                        const ui8 arg, const uint32_t imm,
+                                        const bool has_imm) {
+  switch (op) {
+  case PRISM_OPCODE_ARCH_INIT:
+  case PRISM_OPCODE_ARCH_RESET:
+    memset(lb->bank, 0, sizeof(lb->bank));
+    lb->clear_after_op = 1;
+    lb->link_crc = 0;
+    lb->xfer_bank = __PRISM_LOOPBACK_NO_XFER;
+    lb->xfer_store = 0;
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_ARCH_GET_FLANK:
+    return 0; // No parallel bus, no flank
+  case PRISM_OPCODE_ARCH_GET_VERSION_MAJOR:
+    return PRISM_VERSION_MAJOR;
+  case PRISM_OPCODE_ARCH_GET_VERSION_MINOR:
+    return PRISM_VERSION_MINOR;
+  case PRISM_OPCODE_ARCH_GET_VERSION_PATCH:
+    return PRISM_VERSION_PATCH;
+  case PRISM_OPCODE_ARCH_END:
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_ARCH_DESCRIBE:
+    lb->xfer_bank = __PRISM_LOOPBACK_XFER_DESCRIBE;
+    lb->xfer_pos = 0;
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_ARCH_LINK_CRC:
+    lb->link_crc = (arg != 0);
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_ARCH_PEEK: {
+    const uint8_t byte = lb->bank[(arg >> 6) & 3].uib[(arg & 63) / 2];
+    return PRISM_PEEK_TAG | ((byte >> ((arg & 1) * 4)) & 0x0F);
+  }
+
+  case PRISM_OPCODE_STORE_A:
+    return __prism_loopback_begin(lb, PRISM_BANK_A, true);
+  case PRISM_OPCODE_STORE_B:
+    return __prism_loopback_begin(lb, PRISM_BANK_B, true);
+  case PRISM_OPCODE_LOAD_A:
+    return __prism_loopback_begin(lb, PRISM_BANK_A, false);
+  case PRISM_OPCODE_LOAD_B:
+    return __prism_loopback_begin(lb, PRISM_BANK_B, false);
+  case PRISM_OPCODE_LOAD_C:
+    return __prism_loopback_begin(lb, PRISM_BANK_C, false);
+  case PRISM_OPCODE_LOAD_D:
+    return __prism_loopback_begin(lb, PRISM_BANK_D, false);
+  case PRISM_OPCODE_END: {
+    const uint8_t status =
+        lb->xfer_store ? __prism_loopback_commit(lb) : PRISM_STATUS_OK;
+    lb->xfer_bank = __PRISM_LOOPBACK_NO_XFER;
+    lb->xfer_store = 0;
+    return status;
+  }
+
+  case PRISM_OPCODE_NOCLEAR_AFTEROP:
+    lb->clear_after_op = 0;
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CLEAR_AFTEROP:
+    lb->clear_after_op = 1;
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CLEAR_C:
+    memset(&lb->bank[PRISM_BANK_C], 0, sizeof(_v256i));
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CLEAR_D:
+    memset(&lb->bank[PRISM_BANK_D], 0, sizeof(_v256i));
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CLEAR_ALL:
+    memset(lb->bank, 0, sizeof(lb->bank));
+    return PRISM_STATUS_OK;
+
+  case PRISM_OPCODE_NOTC:
+    for (uint8_t i = 0; i < 8; i++) {
+      lb->bank[PRISM_BANK_C].ui[i] = ~lb->bank[PRISM_BANK_C].ui[i];
+    }
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CTOA:
+    lb->bank[PRISM_BANK_A] = lb->bank[PRISM_BANK_C];
+    return PRISM_STATUS_OK;
+  case PRISM_OPCODE_CTOB:
+    lb->bank[PRISM_BANK_B] = lb->bank[PRISM_BANK_C];
+    return PRISM_STATUS_OK;
+
+  case PRISM_OPCODE_SPLAT_A:
+  case PRISM_OPCODE_SPLAT_B: {
+    const uint8_t width = __prism_loopback_width(type);
+    if (!has_imm || width == 0) {
+      return PRISM_STATUS_FAIL;
+    }
+    // The low bits of the immediate go into every lane of the type
+    _v256i *v = &lb->bank[op == PRISM_OPCODE_SPLAT_A ? PRISM_BANK_A
+                                                     : PRISM_BANK_B];
+    for (uint8_t i = 0; i < sizeof(_v256i) / width; i++) {
+      __prism_loopback_put(v, width, i, imm);
+    }
+    return PRISM_STATUS_OK;
+  }
+
+  default:
+    return __prism_loopback_execute(lb, op, type, arg, imm, has_imm);
+  }
+}
+
+static prism_err __prism_loopback_send_command(const prdev_t *dev,
+                                               const uint8_t *frame,
+                                               size_t len) {
+  prism_loopback_t *lb = __prism_loopback_state(dev);
+  if (lb == 0 || frame == 0 || len < 8) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  // Same little-endian layout the device parses: op, arg, type, timeout and
+  // the optional 32-bit immediate
+  const uint16_t op = (uint16_t)(frame[0] | (frame[1] << 8));
+  const ui8 arg = frame[2];
+  const ui8 type = frame[3];
+  const bool has_imm = (len >= 12);
+  uint32_t imm = 0;
+  if (has_imm) {
+    imm = (uint32_t)frame[8] | ((uint32_t)frame[9] << 8) |
+          ((uint32_t)frame[10] << 16) | ((uint32_t)frame[11] << 24);
+  }
+
+  lb->frames++;
+  lb->status = __prism_loopback_process(lb, op, type, arg, imm, has_imm);
+  return PR_OK;
+}
+
+static prism_err __prism_loopback_read_status(const prdev_t *dev,
+                                              uint8_t *status) {
+  prism_loopback_t *lb = __prism_loopback_state(dev);
+  if (lb == 0 || status == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  *status = lb->status;
+  return PR_OK;
+}
+
+static prism_err __prism_loopback_write_block(const prdev_t *dev,
+                                              const uint8_t *data, size_t len) {
+  prism_loopback_t *lb = __prism_loopback_state(dev);
+  if (lb == 0 || data == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (!lb->xfer_store) {
+    return PR_ERR_INVALID_ARGUMENT; // No STORE running
+  }
+
+  const uint8_t size = __prism_loopback_block_size(lb);
+  for (size_t i = 0; i < len && lb->xfer_pos < size; i++) {
+    const uint8_t byte = __prism_loopback_damage(lb, data[i]);
+    lb->rx[lb->xfer_pos++] = byte;
+  }
+  lb->bytes += len;
+  return PR_OK;
+}
+
+static prism_err __prism_loopback_read_block(const prdev_t *dev, uint8_t *data,
+                                             size_t len) {
+  prism_loopback_t *lb = __prism_loopback_state(dev);
+  if (lb == 0 || data == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+  if (lb->xfer_bank == __PRISM_LOOPBACK_XFER_DESCRIBE) {
+    for (size_t i = 0; i < len; i++) {
+      data[i] = (lb->xfer_pos < PRISM_DESCRIBE_SIZE)
+                    ? __prism_loopback_describe(lb->xfer_pos++)
+                    : 0;
+    }
+    if (lb->xfer_pos >= PRISM_DESCRIBE_SIZE) {
+      lb->xfer_bank = __PRISM_LOOPBACK_NO_XFER;
+    }
+    lb->bytes += len;
+    return PR_OK;
+  }
+  if (lb->xfer_bank >= PRISM_BANK_MAX) {
+    return PR_ERR_INVALID_ARGUMENT; // No LOAD running
+  }
+
+  const _v256i *bank = &lb->bank[lb->xfer_bank];
+  const uint8_t size = __prism_loopback_block_size(lb);
+  for (size_t i = 0; i < len; i++) {
+    uint8_t byte = 0;
+    if (lb->xfer_pos < sizeof(_v256i)) {
+      byte = bank->uib[lb->xfer_pos];
+    } else if (lb->xfer_pos < size) {
+      const ui16 crc =
+          _prism_crc16(PRISM_CRC16_INIT, bank->uib, sizeof(_v256i));
+      byte = (uint8_t)(crc >> ((lb->xfer_pos - sizeof(_v256i)) * 8));
+    }
+    data[i] = __prism_loopback_damage(lb, byte);
+    if (lb->xfer_pos < size) {
+      lb->xfer_pos++;
+    }
+  }
+  lb->bytes += len;
+  return PR_OK;
+}
+
+const prism_transport_t prism_transport_loopback = {
+    .name = "loopback",
+    .send_command = __prism_loopback_send_command,
+    .read_status = __prism_loopback_read_status,
+    .write_block = __prism_loopback_write_block,
+    .read_block = __prism_loopback_read_block,
+    .exchange_block = 0,
+    .begin = 0,
+    .poll_status = __prism_loopback_read_status};
+
+prism_err prism_device_create_loopback(prism_loopback_t *state,
+                                       prdev_t *dev) {
+  if (state == 0 || dev == 0) {
+    return PR_ERR_INVALID_ARGUMENT;
+  }
+
+  memset(state, 0, sizeof(prism_loopback_t));
+  state->clear_after_op = 1;
+  state->xfer_bank = __PRISM_LOOPBACK_NO_XFER;
+
+  return prism_device_create_with(0, &prism_transport_loopback, state, dev);
+}
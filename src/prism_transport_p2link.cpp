@@ -0,0 +1,109 @@
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
+
+#include "Arduino.h"
+#include <Wire.h>
+
+static void __prism_send_byte(const prdev_t *dev, uint8_t byte,
+                              bool new_entry) {
+  // CLK auf HIGH (vorbereitend für Fallende Flanke)
+  digitalWrite(dev->config.pin5Time, HIGH);
+  // ENTRY_FLAG (Pin 6)
+  digitalWrite(dev->config.pin6Next, new_entry ? HIGH : LOW);
+
+  // Daten setzen
+  digitalWrite(dev->config.pin1low, byte & 0x01);
+  digitalWrite(dev->config.pin2low, (byte >> 1) & 0x01);
+  digitalWrite(dev->config.pin3low, (byte >> 2) & 0x01);
+  digitalWrite(dev->config.pin4low, (byte >> 3) & 0x01);
+  digitalWrite(dev->config.pin7high, (byte >> 4) & 0x01);
+  digitalWrite(dev->config.pin8high, (byte >> 5) & 0x01);
+  digitalWrite(dev->config.pin9high, (byte >> 6) & 0x01);
+  digitalWrite(dev->config.pin10high, (byte >> 7) & 0x01);
+
+  delayMicroseconds(2);
+
+  // Fallende Flanke erzeugen
+  digitalWrite(dev->config.pin5Time, LOW);
+
+  if (new_entry == true) {
+    // ENTRY_FLAG (Pin 6)
+    digitalWrite(dev->config.pin6Next, LOW);
+  }
+
+  // Hold-Zeit (nach der Flanke)
+  delayMicroseconds(4);
+}
+
+static uint8_t __prism_recv_byte(const prdev_t *dev, bool new_entry) {
+  // ENTRY_FLAG (Pin 6)
+  digitalWrite(dev->config.pin6Next, new_entry ? HIGH : LOW);
+
+  // Takt vorbereiten
+  digitalWrite(dev->config.pin5Time, HIGH);
+  delayMicroseconds(2); // Setup-Zeit für Empfänger
+
+  // Taktflanke erzeugen (Fallend)
+  digitalWrite(dev->config.pin5Time, LOW);
+  delayMicroseconds(2); // Hold-Zeit
+
+  if (new_entry) {
+    digitalWrite(dev->config.pin6Next, LOW);
+  }
+
+  // Daten einlesen (nach der Fallenden Flanke)
+  uint8_t byte = 0;
+  byte |= digitalRead(dev->config.pin1low) << 0;
+  byte |= digitalRead(dev->config.pin2low) << 1;
+  byte |= digitalRead(dev->config.pin3low) << 2;
+  byte |= digitalRead(dev->config.pin4low) << 3;
+  byte |= digitalRead(dev->config.pin7high) << 4;
+  byte |= digitalRead(dev->config.pin8high) << 5;
+  byte |= digitalRead(dev->config.pin9high) << 6;
+  byte |= digitalRead(dev->config.pin10high) << 7;
+
+  return byte;
+}
+
+static prism_err __prism_p2link_read_status(const prdev_t *dev,
+                                            uint8_t *status) {
+  delay(50); // Wait for the dev to process the command
+
+  Wire.requestFrom(dev->address,
+                   sizeof(uint8_t)); // Request 1 byte from the dev
+  if (Wire.available() == 0) {
+    return PR_ERR_UNKNOWN; // Device not responding
+  }
+  *status = Wire.read(); // Read the response byte
+  return PR_OK;
+}
+
+static prism_err __prism_p2link_write_block(const prdev_t *dev,
+                                            const uint8_t *data, size_t len) {
+  // Every 32-bit entry starts with the entry flag set on its first byte
+  for (size_t i = 0; i < len; i++) {
+    __prism_send_byte(dev, data[i], (i % sizeof(ui32)) == 0);
+  }
+  return PR_OK;
+}
+
+static prism_err __prism_p2link_read_block(const prdev_t *dev, uint8_t *data,
+                                           size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    data[i] = __prism_recv_byte(dev, (i % sizeof(ui32)) == 0);
+  }
+  return PR_OK;
+}
+
+const prism_transport_t prism_transport_p2link = {
+    .name = "p2link",
+    .send_command = _prism_i2c_send_command,
+    .read_status = __prism_p2link_read_status,
+    .write_block = __prism_p2link_write_block,
+    .read_block = __prism_p2link_read_block,
+    .exchange_block = 0,
+    .begin = 0,
+    // P²Link firmware never answers busy, and the status is only valid after
+    // the processing delay of read_status: prism_poll has to wait for it
+    .poll_status = 0};
@@ -0,0 +1,111 @@
+#include "prism/prism_transport.h"
+
+#include "Arduino.h"
+#include <SPI.h>
+
+// First byte of every SPI transaction, lets the device resynchronize after a
+// lost frame
+#define __PRISM_SPI_FRAME_COMMAND (0xC5)
+#define __PRISM_SPI_FRAME_STATUS (0x5A)
+#define __PRISM_SPI_FRAME_DATA (0xDA)
+
+// Longest wait for a status byte, the fixed wait of the I²C link
+#define __PRISM_SPI_STATUS_WAIT_US (50000UL)
+
+static void __prism_spi_select(const prdev_t *dev, const uint8_t frame) {
+  SPI.beginTransaction(
+      SPISettings(dev->config.spiClock, MSBFIRST, SPI_MODE0));
+  digitalWrite(dev->config.spiCs, LOW);
+  SPI.transfer(frame);
+}
+
+static void __prism_spi_release(const prdev_t *dev) {
+  digitalWrite(dev->config.spiCs, HIGH);
+  SPI.endTransaction();
+}
+
+static prism_err __prism_spi_begin(const prdev_t *dev) {
+  pinMode(dev->config.spiCs, OUTPUT);
+  digitalWrite(dev->config.spiCs, HIGH);
+  SPI.begin();
+  return PR_OK;
+}
+
+static prism_err __prism_spi_send_command(const prdev_t *dev,
+                                          const uint8_t *frame, size_t len) {
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_COMMAND);
+  for (size_t i = 0; i < len; i++) {
+    SPI.transfer(frame[i]);
+  }
+  __prism_spi_release(dev);
+  return PR_OK;
+}
+
+static prism_err __prism_spi_read_status(const prdev_t *dev,
+                                         uint8_t *status) {
+  // Poll instead of a fixed delay, the device answers as soon as it is done
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_STATUS);
+  unsigned long start = micros();
+  uint8_t value = PRISM_STATUS_BUSY;
+  while (value == PRISM_STATUS_BUSY &&
+         (micros() - start) < __PRISM_SPI_STATUS_WAIT_US) {
+    value = SPI.transfer(0x00);
+  }
+  __prism_spi_release(dev);
+
+  if (value == PRISM_STATUS_BUSY) {
+    return PR_ERR_UNKNOWN; // Device not responding
+  }
+  *status = value;
+  return PR_OK;
+}
+
+static prism_err __prism_spi_poll_status(const prdev_t *dev,
+                                         uint8_t *status) {
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_STATUS);
+  *status = SPI.transfer(0x00);
+  __prism_spi_release(dev);
+  return PR_OK;
+}
+
+static prism_err __prism_spi_write_block(const prdev_t *dev,
+                                         const uint8_t *data, size_t len) {
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_DATA);
+  for (size_t i = 0; i < len; i++) {
+    SPI.transfer(data[i]);
+  }
+  __prism_spi_release(dev);
+  return PR_OK;
+}
+
+static prism_err __prism_spi_read_block(const prdev_t *dev, uint8_t *data,
+                                        size_t len) {
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_DATA);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = SPI.transfer(0x00);
+  }
+  __prism_spi_release(dev);
+  return PR_OK;
+}
+
+static prism_err __prism_spi_exchange_block(const prdev_t *dev,
+                                            const uint8_t *out, uint8_t *in,
+                                            size_t len) {
+  // MOSI carries the next operand while MISO returns the result
+  __prism_spi_select(dev, __PRISM_SPI_FRAME_DATA);
+  for (size_t i = 0; i < len; i++) {
+    in[i] = SPI.transfer(out[i]);
+  }
+  __prism_spi_release(dev);
+  return PR_OK;
+}
+
+const prism_transport_t prism_transport_spi = {
+    .name = "spi",
+    .send_command = __prism_spi_send_command,
+    .read_status = __prism_spi_read_status,
+    .write_block = __prism_spi_write_block,
+    .read_block = __prism_spi_read_block,
+    .exchange_block = __prism_spi_exchange_block,
+    .begin = __prism_spi_begin,
+    .poll_status = __prism_spi_poll_status};
@@ -0,0 +1,19 @@
+// Checks for the host tests. Every test is one executable whose main runs a
+// few test functions and returns PRISM_TEST_RESULT().
+#pragma once
+
+#include <stdio.h>
+
+static int __prism_test_failures = 0;
+
+#define PRISM_CHECK(cond)                                                      \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);          \
+      __prism_test_failures++;                                                 \
+    }                                                                          \
+  } while (0)
+
+#define PRISM_CHECK_OK(expr) PRISM_CHECK((expr) == PR_OK)
+
+#define PRISM_TEST_RESULT() (__prism_test_failures == 0 ? 0 : 1)
@@ -0,0 +1,27 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+
+#include <chrono>
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+static const auto __prism_stub_start = std::chrono::steady_clock::now();
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return LOW; }
+
+// Time only moves on its own, the library never waits for real hardware here
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned int) {}
+
+unsigned long micros(void) {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - __prism_stub_start)
+      .count();
+}
+
+unsigned long millis(void) { return micros() / 1000; }
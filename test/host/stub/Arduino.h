@@ -0,0 +1,38 @@
+// Just enough of the Arduino core to build the library on a host
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define SS 10
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long micros(void);
+unsigned long millis(void);
+
+#ifdef __cplusplus
+// Output is dropped, the tests report through stdout themselves
+struct HardwareSerial {
+  void begin(unsigned long) {}
+  size_t print(const char *) { return 0; }
+  size_t print(unsigned long, int = 10) { return 0; }
+  size_t println(const char * = "") { return 0; }
+  size_t println(unsigned long, int = 10) { return 0; }
+};
+extern HardwareSerial Serial;
+#endif // __cplusplus
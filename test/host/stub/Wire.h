@@ -0,0 +1,22 @@
+// I2C bus without devices: no address acknowledges, reads return nothing
+#pragma once
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+struct TwoWire {
+  void begin() {}
+  void setClock(uint32_t hz) { clock = hz; }
+  void beginTransmission(uint8_t) {}
+  uint8_t endTransmission(bool = true) { return 2; } // NACK on address
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t *, size_t len) { return len; }
+  uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+  uint8_t requestFrom(int, int) { return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+
+  uint32_t clock = 0; // Last setClock, 0 if never called
+};
+extern TwoWire Wire;
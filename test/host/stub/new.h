@@ -0,0 +1,4 @@
+// new.h of the Arduino core, included by prism.h
+#pragma once
+
+#include <new>
@@ -0,0 +1,136 @@
+// Wide add, sub, compare and shifts against limb-by-limb host references
+#include "prism/prism_bigint.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+#define COUNT 5
+#define LIMBS (COUNT * 8)
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static ui32 a[LIMBS], b[LIMBS];
+
+static ui8 add_ref(const ui32 *x, const ui32 *y, ui32 *out, const int w,
+                   const bool sub) {
+  uint64_t carry = 0;
+  for (int l = 0; l < w; l++) {
+    const uint64_t v = sub ? (uint64_t)x[l] - y[l] - carry
+                           : (uint64_t)x[l] + y[l] + carry;
+    out[l] = (ui32)v;
+    carry = (v >> 32) ? 1 : 0;
+  }
+  return (ui8)carry;
+}
+
+static si8 cmp_ref(const ui32 *x, const ui32 *y, const int w) {
+  for (int l = w - 1; l >= 0; l--) {
+    if (x[l] != y[l]) {
+      return (x[l] < y[l]) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+static void shift_ref(const ui32 *x, const int shift, ui32 *out, const int w,
+                      const bool left) {
+  for (int l = 0; l < w; l++) {
+    ui32 v = 0;
+    for (int bit = 0; bit < 32; bit++) {
+      const int from = l * 32 + bit + (left ? -shift : shift);
+      if (from >= 0 && from < 32 * w && ((x[from / 32] >> (from % 32)) & 1)) {
+        v |= (ui32)1 << bit;
+      }
+    }
+    out[l] = v;
+  }
+}
+
+static void check_width(const prism_bigint_width_t w, const char *features) {
+  ui32 out[LIMBS], ref[COUNT * 8];
+  ui8 carry[COUNT];
+  si8 order[COUNT];
+
+  PRISM_CHECK_OK(prism_bigint_add(&dev, w, a, b, out, COUNT, carry, 10));
+  for (int i = 0; i < COUNT; i++) {
+    const ui8 c = add_ref(&a[i * w], &b[i * w], ref, w, false);
+    if (carry[i] != c || memcmp(&out[i * w], ref, w * sizeof(ui32)) != 0) {
+      printf("%s: add width %d value %d\n", features, (int)w, i);
+      PRISM_CHECK(carry[i] == c);
+    }
+  }
+
+  PRISM_CHECK_OK(prism_bigint_sub(&dev, w, a, b, out, COUNT, carry, 10));
+  for (int i = 0; i < COUNT; i++) {
+    const ui8 c = add_ref(&a[i * w], &b[i * w], ref, w, true);
+    if (carry[i] != c || memcmp(&out[i * w], ref, w * sizeof(ui32)) != 0) {
+      printf("%s: sub width %d value %d\n", features, (int)w, i);
+      PRISM_CHECK(carry[i] == c);
+    }
+  }
+
+  PRISM_CHECK_OK(prism_bigint_cmp(&dev, w, a, b, order, COUNT, 10));
+  for (int i = 0; i < COUNT; i++) {
+    PRISM_CHECK(order[i] == cmp_ref(&a[i * w], &b[i * w], w));
+  }
+
+  const int shifts[] = {0, 1, 31, 32, 45, 32 * (int)w - 1, 32 * (int)w};
+  for (const int s : shifts) {
+    for (int left = 0; left < 2; left++) {
+      if (left) {
+        PRISM_CHECK_OK(prism_bigint_shl(&dev, w, a, s, out, COUNT, 10));
+      } else {
+        PRISM_CHECK_OK(prism_bigint_shr(&dev, w, a, s, out, COUNT, 10));
+      }
+      for (int i = 0; i < COUNT; i++) {
+        shift_ref(&a[i * w], s, ref, w, left);
+        if (memcmp(&out[i * w], ref, w * sizeof(ui32)) != 0) {
+          printf("%s: %s %d width %d value %d\n", features,
+                 left ? "shl" : "shr", s, (int)w, i);
+          PRISM_CHECK(memcmp(&out[i * w], ref, w * sizeof(ui32)) == 0);
+        }
+      }
+    }
+  }
+}
+
+static void check_all(const char *features) {
+  check_width(PRISM_BIGINT_64, features);
+  check_width(PRISM_BIGINT_128, features);
+  check_width(PRISM_BIGINT_256, features);
+}
+
+static void test_in_place(void) {
+  ui32 x[4] = {0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0};
+  const ui32 one[4] = {1, 0, 0, 0};
+  ui8 carry = 0;
+
+  // The carry runs through every limb
+  PRISM_CHECK_OK(
+      prism_bigint_add(&dev, PRISM_BIGINT_128, x, one, x, 1, &carry, 10));
+  PRISM_CHECK(x[0] == 0 && x[1] == 0 && x[2] == 0 && x[3] == 1);
+  PRISM_CHECK(carry == 0);
+  PRISM_CHECK_OK(prism_bigint_shl(&dev, PRISM_BIGINT_128, x, 31, x, 1, 10));
+  PRISM_CHECK(x[3] == 0x80000000UL && x[2] == 0);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < LIMBS; i++) {
+    a[i] = (i % 5 == 0) ? 0xFFFFFFFFUL : 0x9E3779B9UL * (i + 1);
+    b[i] = (i % 7 == 0) ? 0xFFFFFFFFUL : 0x7F4A7C15UL * (i + 3);
+  }
+  // Equal values, and values differing only in the lowest limb
+  memcpy(&b[8], &a[8], 8 * sizeof(ui32));
+  memcpy(&b[16], &a[16], 8 * sizeof(ui32));
+  b[16]++;
+
+  check_all("reported features");
+  test_in_place();
+
+  dev.features = PRISM_FEATURES_BASE;
+  check_all("base features");
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,111 @@
+// Set operations bit by bit, with all-zero blocks and a partial last block
+#include "prism/prism_bitset.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+#define BITS 700
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static ui32 wa[PRISM_BITSET_WORDS(BITS)], wb[PRISM_BITSET_WORDS(BITS)];
+static ui32 wout[PRISM_BITSET_WORDS(BITS)];
+static prism_bitset_t a, b, out;
+
+static bool expected(const int op, const size_t i) {
+  const bool x = prism_bitset_test(&a, i), y = prism_bitset_test(&b, i);
+  switch (op) {
+  case PRISM_BITSET_UNION:
+    return x || y;
+  case PRISM_BITSET_INTERSECT:
+    return x && y;
+  case PRISM_BITSET_DIFFERENCE:
+    return x && !y;
+  default:
+    return x != y;
+  }
+}
+
+static void check_ops(const char *features) {
+  for (int op = PRISM_BITSET_UNION; op <= PRISM_BITSET_SYMDIFF; op++) {
+    PRISM_CHECK_OK(
+        prism_bitset_op(&dev, (prism_bitset_op_t)op, &a, &b, &out, 10));
+    size_t count = 0;
+    for (size_t i = 0; i < BITS; i++) {
+      if (prism_bitset_test(&out, i) != expected(op, i)) {
+        printf("%s: op %d bit %lu\n", features, op, (unsigned long)i);
+        PRISM_CHECK(prism_bitset_test(&out, i) == expected(op, i));
+      }
+      count += expected(op, i);
+    }
+    PRISM_CHECK(prism_bitset_count(&out) == count);
+  }
+
+  PRISM_CHECK_OK(prism_bitset_complement(&dev, &a, &out, 10));
+  for (size_t i = 0; i < BITS; i++) {
+    PRISM_CHECK(prism_bitset_test(&out, i) != prism_bitset_test(&a, i));
+  }
+  // Bits past the end stay clear
+  PRISM_CHECK((wout[PRISM_BITSET_WORDS(BITS) - 1] >> (BITS % 32)) == 0);
+}
+
+static void test_in_place(void) {
+  ui32 saved[PRISM_BITSET_WORDS(BITS)];
+  memcpy(saved, wa, sizeof(saved));
+
+  PRISM_CHECK_OK(prism_bitset_union(&dev, &a, &b, &a, 10));
+  for (size_t i = 0; i < BITS; i++) {
+    PRISM_CHECK(prism_bitset_test(&a, i) ==
+                (((saved[i / 32] >> (i % 32)) & 1) ||
+                 prism_bitset_test(&b, i)));
+  }
+  memcpy(wa, saved, sizeof(saved));
+}
+
+static void test_queries(void) {
+  prism_bitset_init(&out, wout, BITS);
+  PRISM_CHECK(!prism_bitset_any(&out));
+  PRISM_CHECK(!prism_bitset_all(&out));
+  prism_bitset_set(&out, BITS - 1);
+  PRISM_CHECK(prism_bitset_any(&out));
+  PRISM_CHECK(prism_bitset_count(&out) == 1);
+  prism_bitset_clear(&out, BITS - 1);
+  prism_bitset_set(&out, BITS);
+  PRISM_CHECK(prism_bitset_count(&out) == 0);
+
+  PRISM_CHECK_OK(prism_bitset_complement(&dev, &out, &out, 10));
+  PRISM_CHECK(prism_bitset_all(&out));
+  PRISM_CHECK(prism_bitset_count(&out) == BITS);
+
+  ui32 small[1];
+  prism_bitset_t other;
+  prism_bitset_init(&other, small, 20);
+  PRISM_CHECK(prism_bitset_union(&dev, &a, &other, &out, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  prism_bitset_init(&a, wa, BITS);
+  prism_bitset_init(&b, wb, BITS);
+  prism_bitset_init(&out, wout, BITS);
+  for (size_t i = 0; i < BITS; i++) {
+    // The second block of a and the third of b stay empty
+    if ((i * 7) % 5 < 2 && (i < 256 || i >= 512)) {
+      prism_bitset_set(&a, i);
+    }
+    if ((i * 3) % 4 == 1 && i < 512) {
+      prism_bitset_set(&b, i);
+    }
+  }
+
+  check_ops("reported features");
+  test_in_place();
+  test_queries();
+
+  dev.features = PRISM_FEATURES_BASE;
+  check_ops("base features");
+  return PRISM_TEST_RESULT();
+}
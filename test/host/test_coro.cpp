@@ -0,0 +1,131 @@
+// Coroutines sharing one loopback device through the scheduler
+#include "prism/prism_coro.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#define TASKS 5
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+// (a + b) << shift, then times 3 through an immediate
+static prism::task add_shift_scale(prism::scheduler &s, const ui32 *a,
+                                   const ui32 *b, const ui8 shift, ui32 *out) {
+  prism::device_guard guard = co_await s.lock(&dev);
+  prism_err err = co_await s.store(&dev, PRISM_BANK_A, a);
+  if (err == PR_OK) {
+    err = co_await s.store(&dev, PRISM_BANK_B, b);
+  }
+  if (err == PR_OK) {
+    err = co_await s.op(&dev, PRISM_OPCODE_ADD_N, PRISM_OPCODE_TYPE_UI32, 8);
+  }
+  if (err == PR_OK) {
+    err = co_await s.load(&dev, PRISM_BANK_C, out);
+  }
+  if (err == PR_OK) {
+    err = co_await s.store(&dev, PRISM_BANK_A, out);
+  }
+  if (err == PR_OK) {
+    err = co_await s.op(&dev, PRISM_OPCODE_SHIFT_L, PRISM_OPCODE_TYPE_UI32, 8,
+                        shift);
+  }
+  if (err == PR_OK) {
+    err = co_await s.load(&dev, PRISM_BANK_C, out);
+  }
+  if (err == PR_OK) {
+    err = co_await s.store(&dev, PRISM_BANK_A, out);
+  }
+  if (err == PR_OK) {
+    err = co_await s.op(&dev, PRISM_OPCODE_MUL_S, PRISM_OPCODE_TYPE_UI32, 8, 3);
+  }
+  if (err == PR_OK) {
+    err = co_await s.load(&dev, PRISM_BANK_C, out);
+  }
+  co_return err;
+}
+
+static prism::task run_checked(prism::task t, prism_err *result) {
+  *result = co_await t;
+  co_return *result;
+}
+
+static void test_locked_tasks(void) {
+  static ui32 a[TASKS][8], b[TASKS][8], out[TASKS][8];
+  prism_err results[TASKS];
+  prism::scheduler sched(10);
+
+  for (int t = 0; t < TASKS; t++) {
+    results[t] = PR_ERR_UNKNOWN;
+    for (int i = 0; i < 8; i++) {
+      a[t][i] = t * 1000 + i;
+      b[t][i] = 7 * i + t;
+    }
+    PRISM_CHECK_OK(sched.spawn(run_checked(
+        add_shift_scale(sched, a[t], b[t], (ui8)t, out[t]), &results[t])));
+  }
+  sched.run();
+  PRISM_CHECK(sched.running() == 0);
+
+  for (int t = 0; t < TASKS; t++) {
+    PRISM_CHECK_OK(results[t]);
+    for (int i = 0; i < 8; i++) {
+      PRISM_CHECK(out[t][i] == ((a[t][i] + b[t][i]) << t) * 3);
+    }
+  }
+}
+
+// Operations prism_op rejects fail the same way when awaited
+static prism::task rejected(prism::scheduler &s, prism_err *result) {
+  *result = co_await s.op(&dev, PRISM_OPCODE_ADD_N, PRISM_OPCODE_TYPE_UI32, 9);
+  co_return *result;
+}
+
+static void test_rejected(void) {
+  prism_err result = PR_OK;
+  prism::scheduler sched(10);
+  PRISM_CHECK_OK(sched.spawn(rejected(sched, &result)));
+  sched.run();
+  PRISM_CHECK(result == PR_ERR_INVALID_ARGUMENT);
+}
+
+// Damaged blocks are sent again like with the blocking transfers
+static prism::task round_trip(prism::scheduler &s, const ui32 *src, ui32 *out,
+                              prism_err *result) {
+  *result = co_await s.store(&dev, PRISM_BANK_B, src);
+  if (*result == PR_OK) {
+    *result = co_await s.load(&dev, PRISM_BANK_B, out);
+  }
+  co_return *result;
+}
+
+static void test_link_crc(void) {
+  ui32 src[8], out[8];
+  prism_err result = PR_ERR_UNKNOWN;
+  prism_link_stats_t stats;
+  prism::scheduler sched(10);
+
+  for (int i = 0; i < 8; i++) {
+    src[i] = 0xC0DE0000UL + i;
+  }
+  emu.corrupt = 2; // The store and then the load
+  prism_link_stats_reset(&dev);
+  PRISM_CHECK_OK(sched.spawn(round_trip(sched, src, out, &result)));
+  sched.run();
+  emu.corrupt = 0;
+
+  PRISM_CHECK_OK(result);
+  for (int i = 0; i < 8; i++) {
+    PRISM_CHECK(out[i] == src[i]);
+  }
+  prism_link_stats(&dev, &stats);
+  PRISM_CHECK(stats.crc_errors == 2 && stats.retries == 2);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_locked_tasks();
+  test_rejected();
+  test_link_crc();
+  return PRISM_TEST_RESULT();
+}
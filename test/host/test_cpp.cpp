@@ -0,0 +1,38 @@
+// The prism.hpp front end on the loopback, including its header example
+#include "prism/prism.hpp"
+
+#include "prism_test.h"
+
+static prism_loopback_t emu;
+
+static void test_header_example(prism::device &dev) {
+  prism::vec<si16> a = prism::vec<si16>::splat(3), b;
+  for (ui8 i = 0; i < b.lanes; i++) {
+    b[i] = (si16)(i - 4);
+  }
+  prism::result<prism::vec<si16> > prod = dev.eval(a * b);
+  PRISM_CHECK(prod.ok());
+  if (prod) {
+    prism::result<prism::vec<si16> > sum = dev.eval(*prod + 1);
+    PRISM_CHECK(sum.ok());
+    for (ui8 i = 0; sum && i < b.lanes; i++) {
+      PRISM_CHECK((*sum)[i] == 3 * (i - 4) + 1);
+    }
+  }
+}
+
+static void test_store_load(prism::device &dev) {
+  prism::vec<ui32, 3> v = prism::vec<ui32, 3>::splat(0xDEADBEEFUL);
+  PRISM_CHECK(dev.store(PRISM_BANK_B, v).ok());
+  prism::result<prism::vec<ui32, 3> > r = dev.load<ui32, 3>(PRISM_BANK_B);
+  PRISM_CHECK(r.ok() && (*r)[0] == 0xDEADBEEFUL && (*r)[2] == 0xDEADBEEFUL);
+}
+
+int main(void) {
+  prism::device dev;
+  PRISM_CHECK(dev.open_loopback(&emu).ok());
+  test_header_example(dev);
+  test_store_load(dev);
+  PRISM_CHECK(dev.close().ok());
+  return PRISM_TEST_RESULT();
+}
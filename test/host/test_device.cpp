@@ -0,0 +1,60 @@
+// prism_device_create on a bus without a device
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <Wire.h>
+#include <string.h>
+
+static void test_config_default(void) {
+  prism_dev_config_t config;
+  memset(&config, 0xAB, sizeof(config));
+  prism_dev_config_default(&config);
+  PRISM_CHECK(config.mode == PRISM_MODE_P2LINK);
+  PRISM_CHECK(config.pin5Time == PRISM_PIN_CLK_DEFAULT);
+  PRISM_CHECK(config.spiClock == PRISM_SPI_CLOCK_DEFAULT);
+  PRISM_CHECK(config.i2cClock == 0);
+}
+
+static void test_unset_mode(void) {
+  // A sketch from before the mode field, with the rest left on the stack
+  prism_dev_config_t config;
+  memset(&config, 0xAB, sizeof(config));
+  config.pin5Time = PRISM_PIN_CLK_DEFAULT;
+
+  prdev_t dev;
+  prism_device_create(0x42, false, &config, &dev);
+  PRISM_CHECK(dev.transport == &prism_transport_p2link);
+  PRISM_CHECK(dev.config.mode == PRISM_MODE_P2LINK);
+}
+
+static void test_i2c_clock(void) {
+  prism_dev_config_t config;
+  prdev_t dev;
+
+  // A clock left unset on the stack is not applied
+  prism_dev_config_default(&config);
+  config.i2cClock = 123456;
+  Wire.clock = 0;
+  prism_device_create(0x42, false, &config, &dev);
+  PRISM_CHECK(Wire.clock == 0);
+
+  config.i2cClock = PRISM_I2C_CLOCK_FAST;
+  prism_device_create(0x42, false, &config, &dev);
+  PRISM_CHECK(Wire.clock == PRISM_I2C_CLOCK_FAST);
+}
+
+static void test_no_device(void) {
+  // Nothing acknowledges on the stubbed bus, so the init frame fails
+  prdev_t dev;
+  PRISM_CHECK(prism_device_create(0x42, false, 0, &dev) != PR_OK);
+}
+
+int main(void) {
+  test_config_default();
+  test_unset_mode();
+  test_i2c_clock();
+  test_no_device();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,93 @@
+// Host/device dispatch: both paths give the same results
+#include "prism/prism_dispatch.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+#define N 21
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static ui32 a[N], b[N], out[N];
+
+static void test_decide(void) {
+  prism_cost_model_t model;
+  size_t lanes = 0;
+  memset(&model, 0, sizeof(model));
+
+  // The device is free: full blocks go there, the tail stays on the host
+  model.host_ns_per_lane[0] = 1000;
+  PRISM_CHECK(prism_cost_decide(&model, PRISM_OPCODE_ADD_N, 16, &lanes) ==
+                  PRISM_EXEC_DEVICE &&
+              lanes == 16);
+  PRISM_CHECK(prism_cost_decide(&model, PRISM_OPCODE_ADD_N, N, &lanes) ==
+                  PRISM_EXEC_SPLIT &&
+              lanes == 16);
+  PRISM_CHECK(prism_cost_decide(&model, PRISM_OPCODE_ADD_N, 7, &lanes) ==
+                  PRISM_EXEC_HOST &&
+              lanes == 0);
+
+  // The link is slower than the host
+  model.block_us = 1000;
+  PRISM_CHECK(prism_cost_decide(&model, PRISM_OPCODE_ADD_N, 16, &lanes) ==
+              PRISM_EXEC_HOST);
+}
+
+static void check_sub(const char *path) {
+  for (int i = 0; i < N; i++) {
+    if (out[i] != a[i] - b[i]) {
+      printf("%s: lane %d is %lu\n", path, i, (unsigned long)out[i]);
+      PRISM_CHECK(out[i] == a[i] - b[i]);
+      return;
+    }
+  }
+}
+
+static void test_paths(void) {
+  prism_cost_model_t model;
+  memset(&model, 0, sizeof(model));
+  for (int op = 0; op < PRISM_COST_OP_COUNT; op++) {
+    model.host_ns_per_lane[op] = 1000000;
+  }
+
+  uint32_t frames = emu.frames;
+  PRISM_CHECK_OK(prism_stream_op(&dev, &model, PRISM_OPCODE_SUB_N,
+                                 PRISM_OPCODE_TYPE_UI32, a, b, out, N, 10));
+  PRISM_CHECK(emu.frames > frames);
+  check_sub("split");
+
+  model.block_us = UINT32_MAX / 1000;
+  memset(out, 0, sizeof(out));
+  frames = emu.frames;
+  PRISM_CHECK_OK(prism_stream_op(&dev, &model, PRISM_OPCODE_SUB_N,
+                                 PRISM_OPCODE_TYPE_UI32, a, b, out, N, 10));
+  PRISM_CHECK(emu.frames == frames);
+  check_sub("host");
+
+  PRISM_CHECK(prism_stream_op(&dev, &model, PRISM_OPCODE_CMP_GT,
+                              PRISM_OPCODE_TYPE_UI32, a, b, out, N,
+                              10) == PR_ERR_INVALID_ARGUMENT);
+}
+
+static void test_model_init(void) {
+  prism_cost_model_t model;
+  PRISM_CHECK_OK(prism_cost_model_init(&dev, &model, 10));
+  PRISM_CHECK(model.link_bytes_per_s != 0);
+  for (int op = 0; op < PRISM_COST_OP_COUNT; op++) {
+    PRISM_CHECK(model.host_ns_per_lane[op] != 0);
+  }
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < N; i++) {
+    a[i] = 0x10000000UL + i * 12345;
+    b[i] = i * 777 + 3;
+  }
+  test_decide();
+  test_paths();
+  test_model_init();
+  return PRISM_TEST_RESULT();
+}
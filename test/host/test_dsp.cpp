@@ -0,0 +1,146 @@
+// FIR, dot product, MAC and moving average against host references
+#include "prism/prism_dsp.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+#define N 40
+#define TAPS 11
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static si32 x[N];
+static si32 h[TAPS];
+
+static si32 fir_expected(const int n, const ui8 q) {
+  int64_t acc = 0;
+  for (int k = 0; k < TAPS && k <= n; k++) {
+    acc += (int64_t)h[k] * x[n - k];
+  }
+  if (q > 0) {
+    acc += (int64_t)1 << (q - 1);
+    acc >>= q;
+  }
+  return (si32)acc;
+}
+
+static void test_fir(const char *features) {
+  prism_fir_t fir;
+  si32 out[N];
+
+  PRISM_CHECK_OK(prism_fir_init(&fir, &dev, h, TAPS, 4, 10));
+  // Two blocks of uneven size, the history carries over
+  PRISM_CHECK_OK(prism_fir_process(&fir, x, out, 7));
+  PRISM_CHECK_OK(prism_fir_process(&fir, &x[7], &out[7], N - 7));
+  for (int n = 0; n < N; n++) {
+    if (out[n] != fir_expected(n, 4)) {
+      printf("%s: fir[%d] = %ld\n", features, n, (long)out[n]);
+      PRISM_CHECK(out[n] == fir_expected(n, 4));
+    }
+  }
+
+  // After a reset the filter starts from silence again, in place
+  prism_fir_reset(&fir);
+  memcpy(out, x, sizeof(out));
+  PRISM_CHECK_OK(prism_fir_process(&fir, out, out, N));
+  PRISM_CHECK(out[0] == fir_expected(0, 4));
+  PRISM_CHECK(out[N - 1] == fir_expected(N - 1, 4));
+
+  PRISM_CHECK(prism_fir_init(&fir, &dev, h, 0, 0, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+  PRISM_CHECK(prism_fir_init(&fir, &dev, h, PRISM_FIR_MAX_TAPS + 1, 0, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+static void test_dot(const char *features) {
+  int64_t expected = 0;
+  for (int i = 0; i < N - 3; i++) {
+    expected += (int64_t)x[i] * h[i % TAPS];
+  }
+
+  si32 b[N];
+  for (int i = 0; i < N; i++) {
+    b[i] = h[i % TAPS];
+  }
+
+  int64_t r = 0;
+  PRISM_CHECK_OK(prism_dot_si32(&dev, x, b, N - 3, &r, 10));
+  if (r != expected) {
+    printf("%s: dot = %lld\n", features, (long long)r);
+    PRISM_CHECK(r == expected);
+  }
+}
+
+static void test_mac(void) {
+  prism_mac_t mac;
+  si32 acc[8];
+
+  // acc = 3 + x[0..7] * 2 - x[8..15]
+  PRISM_CHECK_OK(prism_mac_begin_si32(&mac, &dev, 3, 10));
+  PRISM_CHECK_OK(prism_mac_push_si32(&mac, x, 2));
+  PRISM_CHECK_OK(prism_mac_push_si32(&mac, &x[8], -1));
+  PRISM_CHECK(mac.count == 2);
+  PRISM_CHECK_OK(prism_mac_read(&mac, (ui32 *)acc));
+  for (int l = 0; l < 8; l++) {
+    PRISM_CHECK(acc[l] == 3 + x[l] * 2 - x[8 + l]);
+  }
+
+  // Unscaled push, then a device side scale
+  PRISM_CHECK_OK(prism_mac_reset(&mac, 0));
+  PRISM_CHECK_OK(prism_mac_push_si32(&mac, &x[16], 1));
+  PRISM_CHECK_OK(prism_mac_apply(&mac, PRISM_OPCODE_MUL_S, 5));
+  PRISM_CHECK_OK(prism_mac_end_si32(&mac, acc));
+  for (int l = 0; l < 8; l++) {
+    PRISM_CHECK(acc[l] == x[16 + l] * 5);
+  }
+
+  PRISM_CHECK(prism_mac_apply(&mac, PRISM_OPCODE_ADD_N, 0) ==
+              PR_ERR_INVALID_ARGUMENT);
+  PRISM_CHECK(prism_mac_begin(&mac, &dev, PRISM_OPCODE_TYPE_UI8, 0, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+static void test_moving_average(const char *features) {
+  const ui8 window = 5;
+  si32 out[N];
+
+  PRISM_CHECK_OK(prism_moving_average_si32(&dev, x, N, window, out, 10));
+  for (int i = 0; i + window <= N; i++) {
+    int64_t sum = 0;
+    for (int k = 0; k < window; k++) {
+      sum += x[i + k];
+    }
+    // The device division truncates toward zero
+    if (out[i] != (si32)(sum / window)) {
+      printf("%s: average[%d] = %ld\n", features, i, (long)out[i]);
+      PRISM_CHECK(out[i] == (si32)(sum / window));
+    }
+  }
+
+  PRISM_CHECK(prism_moving_average_si32(&dev, x, 3, window, out, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < N; i++) {
+    // Q15 samples of both signs
+    x[i] = (i * 7919) % 32768 - 16384;
+  }
+  for (int k = 0; k < TAPS; k++) {
+    h[k] = (k % 2) ? 2000 - k * 300 : 4000 + k * 100;
+  }
+
+  test_fir("reported features");
+  test_dot("reported features");
+  test_mac();
+  test_moving_average("reported features");
+
+  dev.features = PRISM_FEATURES_BASE;
+  test_fir("base features");
+  test_dot("base features");
+  test_moving_average("base features");
+  return PRISM_TEST_RESULT();
+}
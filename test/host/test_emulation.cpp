@@ -0,0 +1,66 @@
+// Kernels on a device without PRISM_FEATURE_SCALAR and PRISM_FEATURE_SPLAT,
+// where the library uploads the immediates itself
+#include "prism/prism_dsp.h"
+#include "prism/prism_image.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+static void test_mac(void) {
+  ui32 x[8], acc[8];
+  for (int i = 0; i < 8; i++) {
+    x[i] = i + 1;
+  }
+
+  // The accumulator lives in bank B while MUL_S runs
+  prism_mac_t mac;
+  PRISM_CHECK_OK(prism_mac_begin(&mac, &dev, PRISM_OPCODE_TYPE_UI32, 0, 10));
+  PRISM_CHECK_OK(prism_mac_push(&mac, x, 3));
+  PRISM_CHECK_OK(prism_mac_push(&mac, x, 5));
+  PRISM_CHECK_OK(prism_mac_end(&mac, acc));
+  for (int i = 0; i < 8; i++) {
+    PRISM_CHECK(acc[i] == 8 * x[i]);
+  }
+}
+
+static void test_image(void) {
+  ui8 a[64], b[64], out[64];
+  ui32 sums[2];
+  for (int i = 0; i < 64; i++) {
+    a[i] = (ui8)(i * 3);
+    b[i] = (ui8)(255 - i);
+  }
+  prism_frame_t fa = {a, 32, 2, 32};
+  prism_frame_t fb = {b, 32, 2, 32};
+  prism_frame_t fo = {out, 32, 2, 32};
+
+  PRISM_CHECK_OK(prism_image_blend(&dev, &fa, &fb, 64, &fo, 0, 10));
+  for (int i = 0; i < 64; i++) {
+    PRISM_CHECK(out[i] == (ui8)((a[i] * 64 + b[i] * 192 + 128) >> 8));
+  }
+
+  PRISM_CHECK_OK(prism_image_row_sums(&dev, &fa, sums, 0, 10));
+  for (int y = 0; y < 2; y++) {
+    ui32 sum = 0;
+    for (int i = 0; i < 32; i++) {
+      sum += a[y * 32 + i];
+    }
+    PRISM_CHECK(sums[y] == sum);
+  }
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  // What firmware without the describe query is assumed to have
+  dev.features = PRISM_FEATURES_BASE;
+  PRISM_CHECK(!prism_device_supports(&dev, PRISM_OPCODE_MUL_S,
+                                     PRISM_OPCODE_TYPE_UI32));
+  PRISM_CHECK(!prism_device_supports(&dev, PRISM_OPCODE_SPLAT_B,
+                                     PRISM_OPCODE_TYPE_UI16));
+  test_mac();
+  test_image();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,101 @@
+// Half float conversion and half float lanes on the loopback device
+#include "prism/prism_float.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+static float from_bits(const ui32 bits) {
+  float x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+static void test_round_trip(void) {
+  // Every half value survives float and back, NaN stays NaN
+  for (ui32 h = 0; h <= 0xFFFF; h++) {
+    const float x = prism_half_to_float((ui16)h);
+    const ui16 back = prism_half_from_float(x);
+    if ((h & 0x7C00) == 0x7C00 && (h & 0x3FF) != 0) {
+      PRISM_CHECK(x != x);
+      PRISM_CHECK((back & 0x7C00) == 0x7C00 && (back & 0x3FF) != 0);
+    } else if (back != h) {
+      printf("half 0x%04lx came back as 0x%04x\n", (unsigned long)h, back);
+      PRISM_CHECK(back == h);
+    }
+  }
+}
+
+static void test_values(void) {
+  PRISM_CHECK(prism_half_from_float(1.0f) == 0x3C00);
+  PRISM_CHECK(prism_half_from_float(-2.0f) == 0xC000);
+  PRISM_CHECK(prism_half_from_float(-0.0f) == 0x8000);
+  PRISM_CHECK(prism_half_from_float(65504.0f) == 0x7BFF);
+  // Half way to the next step above the largest half rounds to infinity
+  PRISM_CHECK(prism_half_from_float(65520.0f) == 0x7C00);
+  PRISM_CHECK(prism_half_from_float(1e10f) == 0x7C00);
+  PRISM_CHECK(prism_half_from_float(-1e10f) == 0xFC00);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x7F800000UL)) == 0x7C00);
+
+  // Subnormals, and ties to even below the smallest subnormal
+  PRISM_CHECK(prism_half_from_float(from_bits(0x33800000UL)) == 0x0001);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x33000000UL)) == 0x0000);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x33C00000UL)) == 0x0002);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x38800000UL)) == 0x0400);
+  PRISM_CHECK(prism_half_from_float(1e-10f) == 0x0000);
+
+  // 1 + 2^-11 ties to 1, 1 + 3 * 2^-11 ties up to 1 + 2^-9
+  PRISM_CHECK(prism_half_from_float(from_bits(0x3F801000UL)) == 0x3C00);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x3F803000UL)) == 0x3C02);
+  PRISM_CHECK(prism_half_from_float(from_bits(0x3F801001UL)) == 0x3C01);
+
+  PRISM_CHECK(prism_half_to_float(0x3555) == from_bits(0x3EAAA000UL));
+  PRISM_CHECK(prism_half_to_float(0x0001) == from_bits(0x33800000UL));
+
+  float in[5] = {0.5f, -3.25f, 1000.0f, 0.1f, -0.0f}, out[5];
+  ui16 h[5];
+  prism_half_from_float_n(in, h, 5);
+  prism_half_to_float_n(h, out, 5);
+  for (int i = 0; i < 5; i++) {
+    PRISM_CHECK(h[i] == prism_half_from_float(in[i]));
+    PRISM_CHECK(out[i] == prism_half_to_float(h[i]));
+  }
+}
+
+static void test_lanes(void) {
+  float x[16], y[16], sum[16];
+  for (int i = 0; i < 16; i++) {
+    x[i] = 0.25f * i - 1.5f;
+    y[i] = 8.0f - i;
+  }
+
+  _v256i a = _v256_set_hfv_p(x), b = _v256_set_hfv_p(y), c;
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, b.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK_OK(_v256_add16_hf(&dev, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  _v256_get_hfv_p(&c, sum);
+  for (int i = 0; i < 16; i++) {
+    PRISM_CHECK(sum[i] == x[i] + y[i]);
+  }
+
+  // The sign mask covers both halves of every 32-bit unit
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_v256_neg16_hf(&dev, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  for (int i = 0; i < 16; i++) {
+    PRISM_CHECK(_v256_extract_hf(c, i) == -x[i]);
+  }
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_round_trip();
+  test_values();
+  test_lanes();
+  return PRISM_TEST_RESULT();
+}
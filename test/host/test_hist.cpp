@@ -0,0 +1,110 @@
+// Histograms against host counts, with counters past the packed lane width
+#include "prism/prism_hist.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#define N 1000
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+// Bin of a sample, -1 below the first edge
+static int bin_of(const ui16 *edges, const ui16 bins, const ui16 s) {
+  int j = -1;
+  for (int i = 0; i < bins && edges[i] <= s; i++) {
+    j = i;
+  }
+  return j;
+}
+
+static void test_u8(const char *features) {
+  // 20 bins of width 10 from 30 on span two groups of 16
+  ui16 edges[20];
+  ui32 counts[20], expected[20] = {0};
+  ui8 samples[N];
+  ui32 below = 0;
+
+  prism_hist_edges_uniform(edges, 20, 30, 10);
+  for (int i = 0; i < N; i++) {
+    // A long run of one value overflows an 8-bit lane counter
+    samples[i] = (i >= 200 && i < 600) ? 77 : (ui8)((i * 97) % 256);
+    const int j = bin_of(edges, 20, samples[i]);
+    if (j < 0) {
+      below++;
+    } else {
+      expected[j]++;
+    }
+  }
+
+  prism_hist_t hist;
+  PRISM_CHECK_OK(prism_hist_init(&hist, &dev, PRISM_OPCODE_TYPE_UI8, edges,
+                                 20, counts, 10));
+  PRISM_CHECK_OK(prism_hist_add(&hist, samples, 450));
+  PRISM_CHECK_OK(prism_hist_add(&hist, &samples[450], N - 450));
+  PRISM_CHECK(hist.below == below);
+  for (int j = 0; j < 20; j++) {
+    if (counts[j] != expected[j]) {
+      printf("%s: u8 bin %d = %lu, expected %lu\n", features, j,
+             (unsigned long)counts[j], (unsigned long)expected[j]);
+      PRISM_CHECK(counts[j] == expected[j]);
+    }
+  }
+
+  prism_hist_reset(&hist);
+  PRISM_CHECK(hist.below == 0 && counts[4] == 0);
+}
+
+static void test_u16(const char *features) {
+  static const ui16 edges[11] = {100,  200,   1000,  1001,  5000, 9000,
+                                 9001, 20000, 40000, 60000, 65535};
+  ui32 counts[11], expected[11] = {0};
+  ui16 samples[N];
+  ui32 below = 0;
+
+  for (int i = 0; i < N; i++) {
+    samples[i] = (i % 9 == 0) ? 65535 : (ui16)(i * 40503);
+    const int j = bin_of(edges, 11, samples[i]);
+    if (j < 0) {
+      below++;
+    } else {
+      expected[j]++;
+    }
+  }
+
+  prism_hist_t hist;
+  PRISM_CHECK_OK(prism_hist_init(&hist, &dev, PRISM_OPCODE_TYPE_UI16, edges,
+                                 11, counts, 10));
+  PRISM_CHECK_OK(prism_hist_add(&hist, samples, N));
+  PRISM_CHECK(hist.below == below);
+  for (int j = 0; j < 11; j++) {
+    if (counts[j] != expected[j]) {
+      printf("%s: u16 bin %d = %lu, expected %lu\n", features, j,
+             (unsigned long)counts[j], (unsigned long)expected[j]);
+      PRISM_CHECK(counts[j] == expected[j]);
+    }
+  }
+}
+
+static void test_invalid(void) {
+  static const ui16 unordered[3] = {10, 10, 20};
+  static const ui16 wide[2] = {10, 300};
+  ui32 counts[3];
+  prism_hist_t hist;
+  PRISM_CHECK(prism_hist_init(&hist, &dev, PRISM_OPCODE_TYPE_UI16, unordered,
+                              3, counts, 10) == PR_ERR_INVALID_ARGUMENT);
+  PRISM_CHECK(prism_hist_init(&hist, &dev, PRISM_OPCODE_TYPE_UI8, wide, 2,
+                              counts, 10) == PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_u8("reported features");
+  test_u16("reported features");
+  test_invalid();
+
+  dev.features = PRISM_FEATURES_BASE;
+  test_u8("base features");
+  test_u16("base features");
+  return PRISM_TEST_RESULT();
+}
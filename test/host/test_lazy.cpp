@@ -0,0 +1,140 @@
+// Lazy bank loads: nothing moves before the first access, and a bank that
+// is written first turns the load stale
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static _v256i a, b;
+
+static void add_ab(void) {
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, b.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK_OK(_v256_add8_ui32(&dev, 10));
+}
+
+static void test_bank_mode(void) {
+  prism_lazy_t sum;
+  ui32 v = 0;
+  add_ab();
+
+  uint32_t frames = emu.frames;
+  PRISM_CHECK_OK(_v256_load_bank_lazy_c(&dev, &sum, 10));
+  PRISM_CHECK(emu.frames == frames);
+
+  PRISM_CHECK_OK(_v256_lazy_ui32(&sum, 3, &v));
+  PRISM_CHECK(v == a.ui[3] + b.ui[3]);
+  PRISM_CHECK(emu.frames > frames);
+
+  frames = emu.frames;
+  PRISM_CHECK_OK(_v256_lazy_ui32(&sum, 5, &v));
+  PRISM_CHECK(v == a.ui[5] + b.ui[5] && emu.frames == frames);
+  PRISM_CHECK(!_prism_lazy_cancelled(&sum));
+}
+
+static void test_lane_mode(void) {
+  prism_lazy_t lane;
+  _v256i c;
+  ui8 x = 0;
+  ui16 h = 0;
+  add_ab();
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+
+  PRISM_CHECK_OK(_v256_load_bank_lazy(&dev, PRISM_BANK_C, &lane,
+                                      PRISM_LAZY_LANE, 10));
+  uint32_t frames = emu.frames;
+  PRISM_CHECK_OK(_v256_lazy_ui8(&lane, 13, &x));
+  PRISM_CHECK(x == c.uib[13] && emu.frames - frames == 2);
+
+  // Byte 13 is already here, only byte 12 is read
+  frames = emu.frames;
+  PRISM_CHECK_OK(_v256_lazy_ui16(&lane, 6, &h));
+  PRISM_CHECK(h == c.uix[6] && emu.frames - frames == 2);
+}
+
+static void test_stale(void) {
+  prism_lazy_t late, lane;
+  ui32 v = 0;
+  ui8 x = 0;
+  add_ab();
+
+  PRISM_CHECK_OK(_v256_load_bank_lazy_c(&dev, &late, 10));
+  PRISM_CHECK_OK(_v256_load_bank_lazy(&dev, PRISM_BANK_C, &lane,
+                                      PRISM_LAZY_LANE, 10));
+  PRISM_CHECK_OK(_v256_lazy_ui8(&lane, 0, &x));
+  add_ab();
+
+  PRISM_CHECK(_prism_lazy_cancelled(&late));
+  PRISM_CHECK(_v256_lazy_ui32(&late, 0, &v) == PR_ERR_STALE);
+  PRISM_CHECK(_prism_lazy_cancelled(&lane));
+  PRISM_CHECK_OK(_v256_lazy_ui8(&lane, 0, &x)); // Read before the write
+  PRISM_CHECK(_v256_lazy_ui8(&lane, 1, &x) == PR_ERR_STALE);
+}
+
+static void test_clear_mode(void) {
+  prism_lazy_t op;
+  ui32 v = 0;
+
+  // Lane operations clear A and B, so they cancel a lazy load of A
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_v256_load_bank_lazy_a(&dev, &op, 10));
+  PRISM_CHECK_OK(_v256_add8_ui32(&dev, 10));
+  PRISM_CHECK(_prism_lazy_cancelled(&op));
+
+  // Unless the device keeps them
+  PRISM_CHECK_OK(_v256_set_ncaop(&dev, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_v256_load_bank_lazy_a(&dev, &op, 10));
+  PRISM_CHECK_OK(_v256_add8_ui32(&dev, 10));
+  PRISM_CHECK(!_prism_lazy_cancelled(&op));
+  PRISM_CHECK_OK(_v256_lazy_ui32(&op, 2, &v));
+  PRISM_CHECK(v == a.ui[2]);
+  PRISM_CHECK_OK(_v256_set_caop(&dev, 10));
+}
+
+static void test_without_peek(void) {
+  prism_lazy_t lane;
+  ui8 x = 0;
+  ui32 v = 0;
+
+  dev.features &= ~PRISM_FEATURE_PEEK;
+  PRISM_CHECK_OK(_v256_load_bank_lazy(&dev, PRISM_BANK_A, &lane,
+                                      PRISM_LAZY_LANE, 10));
+  PRISM_CHECK_OK(_v256_lazy_ui8(&lane, 0, &x));
+  PRISM_CHECK(lane.valid == 0xFFFFFFFFUL); // The whole bank was read
+  PRISM_CHECK(_prism_lazy_read(&lane, 30, 4, &v) == PR_ERR_INVALID_ARGUMENT);
+  dev.features |= PRISM_FEATURE_PEEK;
+}
+
+// A transport that can only wait for the status, like P²Link
+static void test_without_poll(void) {
+  prism_transport_t waiting = prism_transport_loopback;
+  const prism_transport_t *transport = dev.transport;
+  prism_lazy_t lane;
+  ui8 x = 0;
+
+  waiting.poll_status = 0;
+  dev.transport = &waiting;
+  PRISM_CHECK_OK(_v256_load_bank_lazy(&dev, PRISM_BANK_A, &lane,
+                                      PRISM_LAZY_LANE, 10));
+  PRISM_CHECK_OK(_v256_lazy_ui8(&lane, 0, &x));
+  PRISM_CHECK(lane.valid == 0xFFFFFFFFUL); // The whole bank was read
+  dev.transport = transport;
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = i * 1000 + 7;
+    b.ui[i] = 0xABCD0000UL + i * 3;
+  }
+  test_bank_mode();
+  test_lane_mode();
+  test_stale();
+  test_clear_mode();
+  test_without_peek();
+  test_without_poll();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,103 @@
+// CRC-16 of bank transfers: damaged blocks are detected and sent again
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
+#include "prism_test.h"
+
+#include <string.h>
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+static void test_crc16(void) {
+  // CRC-16/CCITT-FALSE check value
+  PRISM_CHECK(_prism_crc16(PRISM_CRC16_INIT, (const uint8_t *)"123456789",
+                           9) == 0x29B1);
+}
+
+static void test_clean_link(void) {
+  _v256i a, c;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = i * 77 + 1;
+  }
+  PRISM_CHECK(dev.link_crc == 1 && emu.link_crc == 1);
+
+  prism_link_stats_reset(&dev);
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_A, c.ui, 10));
+  PRISM_CHECK(memcmp(&a, &c, sizeof(_v256i)) == 0);
+
+  prism_link_stats_t stats;
+  prism_link_stats(&dev, &stats);
+  PRISM_CHECK(stats.blocks == 2 && stats.crc_errors == 0);
+}
+
+static void test_retries(void) {
+  _v256i a, c;
+  prism_link_stats_t stats;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = 0xDEAD0000UL + i;
+  }
+
+  // A damaged store is rejected by the device and sent once more
+  emu.corrupt = 1;
+  prism_link_stats_reset(&dev);
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK(emu.bank[PRISM_BANK_B].ui[0] == a.ui[0]);
+  prism_link_stats(&dev, &stats);
+  PRISM_CHECK(stats.blocks == 2 && stats.crc_errors == 1);
+  PRISM_CHECK(stats.retries == 1 && stats.failures == 0);
+
+  // A damaged load is caught by the host
+  emu.corrupt = 2;
+  prism_link_stats_reset(&dev);
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_B, c.ui, 10));
+  PRISM_CHECK(memcmp(&a, &c, sizeof(_v256i)) == 0);
+  prism_link_stats(&dev, &stats);
+  PRISM_CHECK(stats.blocks == 3 && stats.crc_errors == 2);
+
+  // A link that stays bad fails after PRISM_LINK_RETRIES
+  emu.corrupt = 100;
+  prism_link_stats_reset(&dev);
+  PRISM_CHECK(_prism_load_bank_ptr(&dev, PRISM_BANK_B, c.ui, 10) ==
+              PR_ERR_LINK);
+  prism_link_stats(&dev, &stats);
+  PRISM_CHECK(stats.blocks == PRISM_LINK_RETRIES + 1 && stats.failures == 1);
+  emu.corrupt = 0;
+}
+
+static void test_disable(void) {
+  _v256i a;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = 0x100 + i;
+  }
+
+  // Without the CRC the damage goes through unnoticed
+  PRISM_CHECK_OK(prism_link_crc(&dev, false, 10));
+  PRISM_CHECK(emu.link_crc == 0);
+  emu.corrupt = 1;
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK(emu.bank[PRISM_BANK_A].ui[0] == (a.ui[0] ^ 1));
+
+  // The setting survives a reset of the device
+  PRISM_CHECK_OK(prism_device_reset(&dev));
+  PRISM_CHECK(emu.link_crc == 0);
+  PRISM_CHECK_OK(prism_link_crc(&dev, true, 10));
+  PRISM_CHECK_OK(prism_device_reset(&dev));
+  PRISM_CHECK(emu.link_crc == 1);
+
+  dev.features &= ~PRISM_FEATURE_CRC;
+  PRISM_CHECK(prism_link_crc(&dev, true, 10) ==
+              PR_ERR_UNSUPPORTED_OPERATION);
+  dev.features |= PRISM_FEATURE_CRC;
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_crc16();
+  test_clean_link();
+  test_retries();
+  test_disable();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+// Lane operations of the loopback emulation against host arithmetic
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+static void test_describe(void) {
+  PRISM_CHECK(dev.protocol == PRISM_PROTOCOL_VERSION);
+#ifdef PRISM_ENABLE_IEE754
+  PRISM_CHECK(dev.lane_types ==
+              (PRISM_LANES_BASE | PRISM_LANE_FL | PRISM_LANE_HF));
+#else
+  PRISM_CHECK(dev.lane_types == PRISM_LANES_BASE);
+#endif
+  PRISM_CHECK(prism_device_supports(&dev, PRISM_OPCODE_ADD_S,
+                                    PRISM_OPCODE_TYPE_UI32));
+  PRISM_CHECK(prism_device_supports(&dev, PRISM_OPCODE_SPLAT_A,
+                                    PRISM_OPCODE_TYPE_UI16));
+  PRISM_CHECK(dev.features & PRISM_FEATURE_CRC);
+}
+
+static void test_add_ui32(void) {
+  _v256i a, b, c;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = 0x01020304UL * (i + 1);
+    b.ui[i] = 0xFFFFFFF0UL + i;
+  }
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, b.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK_OK(_v256_add8_ui32(&dev, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  for (int i = 0; i < 8; i++) {
+    PRISM_CHECK(c.ui[i] == (ui32)(a.ui[i] + b.ui[i]));
+  }
+
+  // Clear-after-op is the default: the operands are gone
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_A, c.ui, 10));
+  PRISM_CHECK(c.ui[0] == 0 && c.ui[7] == 0);
+}
+
+static void test_mul_si16(void) {
+  _v256i a, b, c;
+  for (int i = 0; i < 16; i++) {
+    a.six[i] = (si16)(i * 37 - 300);
+    b.six[i] = (si16)(7 - i);
+  }
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, b.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK_OK(prism_op(&dev, PRISM_OPCODE_MUL_N, PRISM_OPCODE_TYPE_SI16, 8,
+                          0, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  for (int i = 0; i < 16; i++) {
+    PRISM_CHECK(c.six[i] == (si16)(a.six[i] * b.six[i]));
+  }
+}
+
+static void test_scalar_and_splat(void) {
+  _v256i a, c;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = i * 10;
+  }
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  const uint32_t frames = emu.frames;
+  PRISM_CHECK_OK(_v256_add_scalar_ui32(&dev, 5, 8, 10));
+  PRISM_CHECK(emu.frames == frames + 1); // The immediate rides in the frame
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  for (int i = 0; i < 8; i++) {
+    PRISM_CHECK(c.ui[i] == a.ui[i] + 5);
+  }
+
+  PRISM_CHECK_OK(
+      _v256_splat_bank_v(&dev, PRISM_BANK_B, PRISM_OPCODE_TYPE_UI8, 0x7F, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_B, c.ui, 10));
+  for (int i = 0; i < 32; i++) {
+    PRISM_CHECK(c.uib[i] == 0x7F);
+  }
+}
+
+static void test_partial_lanes(void) {
+  _v256i a, b, c;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = 100 + i;
+    b.ui[i] = i;
+  }
+  PRISM_CHECK_OK(_v256_run_clear_c(&dev, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, a.ui, PRISM_BANK_A, 10));
+  PRISM_CHECK_OK(_prism_send_bank_ptr(&dev, b.ui, PRISM_BANK_B, 10));
+  PRISM_CHECK_OK(_v256_sub3_ui32(&dev, 10));
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  PRISM_CHECK(c.ui[0] == 100 && c.ui[2] == 100);
+  PRISM_CHECK(c.ui[3] == 0 && c.ui[7] == 0); // Lanes past the count stay
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_describe();
+  test_add_ui32();
+  test_mul_si16();
+  test_scalar_and_splat();
+  test_partial_lanes();
+  return PRISM_TEST_RESULT();
+}
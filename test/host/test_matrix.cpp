@@ -0,0 +1,105 @@
+// GEMV and GEMM for every element type against host products
+#include "prism/prism_matrix.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#define ROWS 5
+#define COLS 19
+#define INNER 11
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static si32 m32[ROWS * COLS], x32[COLS];
+static si16 m16[ROWS * COLS], x16[COLS];
+static si8 m8[ROWS * COLS], x8[COLS];
+static si32 a32[ROWS * INNER], b32[INNER * COLS];
+static si16 a16[ROWS * INNER], b16[INNER * COLS];
+static si8 a8[ROWS * INNER], b8[INNER * COLS];
+
+static void test_gemv(const char *features) {
+  si32 y32[ROWS], y16[ROWS], y8[ROWS];
+
+  PRISM_CHECK_OK(prism_gemv_si32(&dev, m32, ROWS, COLS, x32, y32, 10));
+  PRISM_CHECK_OK(prism_gemv_si16(&dev, m16, ROWS, COLS, x16, y16, 10));
+  PRISM_CHECK_OK(prism_gemv_si8(&dev, m8, ROWS, COLS, x8, y8, 10));
+  for (int r = 0; r < ROWS; r++) {
+    si32 e32 = 0, e16 = 0, e8 = 0;
+    for (int c = 0; c < COLS; c++) {
+      e32 += m32[r * COLS + c] * x32[c];
+      e16 += m16[r * COLS + c] * x16[c];
+      e8 += m8[r * COLS + c] * x8[c];
+    }
+    if (y32[r] != e32 || y16[r] != e16 || y8[r] != e8) {
+      printf("%s: gemv row %d: %ld %ld %ld\n", features, r, (long)y32[r],
+             (long)y16[r], (long)y8[r]);
+      PRISM_CHECK(y32[r] == e32 && y16[r] == e16 && y8[r] == e8);
+    }
+  }
+}
+
+static void test_gemm(const char *features) {
+  si32 c32[ROWS * COLS], c16[ROWS * COLS], c8[ROWS * COLS];
+
+  PRISM_CHECK_OK(prism_gemm_si32(&dev, a32, b32, c32, ROWS, INNER, COLS, 10));
+  PRISM_CHECK_OK(prism_gemm_si16(&dev, a16, b16, c16, ROWS, INNER, COLS, 10));
+  PRISM_CHECK_OK(prism_gemm_si8(&dev, a8, b8, c8, ROWS, INNER, COLS, 10));
+  for (int i = 0; i < ROWS; i++) {
+    for (int j = 0; j < COLS; j++) {
+      si32 e32 = 0, e16 = 0, e8 = 0;
+      for (int k = 0; k < INNER; k++) {
+        e32 += a32[i * INNER + k] * b32[k * COLS + j];
+        e16 += a16[i * INNER + k] * b16[k * COLS + j];
+        e8 += a8[i * INNER + k] * b8[k * COLS + j];
+      }
+      const int at = i * COLS + j;
+      if (c32[at] != e32 || c16[at] != e16 || c8[at] != e8) {
+        printf("%s: gemm (%d, %d): %ld %ld %ld\n", features, i, j,
+               (long)c32[at], (long)c16[at], (long)c8[at]);
+        PRISM_CHECK(c32[at] == e32 && c16[at] == e16 && c8[at] == e8);
+      }
+    }
+  }
+}
+
+static void test_invalid(void) {
+  si32 y[ROWS];
+  PRISM_CHECK(prism_gemv(&dev, PRISM_OPCODE_TYPE_UI32, m32, ROWS, COLS, x32,
+                         y, 10) == PR_ERR_INVALID_ARGUMENT);
+  PRISM_CHECK(prism_gemv(&dev, PRISM_OPCODE_TYPE_SI32, 0, ROWS, COLS, x32, y,
+                         10) == PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < ROWS * COLS; i++) {
+    // Mixed signs, with a few zero elements
+    m32[i] = (i % 7 == 0) ? 0 : (i * 37) % 2001 - 1000;
+    m16[i] = (si16)((i * 53) % 401 - 200);
+    m8[i] = (si8)((i * 29) % 255 - 127);
+  }
+  for (int c = 0; c < COLS; c++) {
+    x32[c] = c * 13 - 100;
+    x16[c] = (si16)(150 - c * 11);
+    x8[c] = (si8)(c * 9 - 90);
+  }
+  for (int i = 0; i < ROWS * INNER; i++) {
+    a32[i] = (i % 4 == 0) ? 0 : (i * 41) % 601 - 300;
+    a16[i] = (si16)((i * 17) % 301 - 150);
+    a8[i] = (si8)((i * 23) % 255 - 127);
+  }
+  for (int i = 0; i < INNER * COLS; i++) {
+    b32[i] = (i * 31) % 901 - 450;
+    b16[i] = (si16)((i * 19) % 201 - 100);
+    b8[i] = (si8)((i * 11) % 255 - 127);
+  }
+
+  test_gemv("reported features");
+  test_gemm("reported features");
+  test_invalid();
+
+  dev.features = PRISM_FEATURES_BASE;
+  test_gemv("base features");
+  test_gemm("base features");
+  return PRISM_TEST_RESULT();
+}
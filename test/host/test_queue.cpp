@@ -0,0 +1,100 @@
+// Command queue shared by several std::threads on the loopback backend
+#include "prism/prism_queue.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define THREADS 6
+#define JOBS_PER_THREAD 300
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+// Every thread submits adds of 1 to 8 lanes and checks its own results
+static void test_mixed_widths(void) {
+  prism_queue_t *queue = 0;
+  PRISM_CHECK_OK(prism_queue_create(&dev, 16, 10, &queue));
+  if (queue == 0) {
+    return;
+  }
+
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&, t] {
+      for (int k = 0; k < JOBS_PER_THREAD; k++) {
+        _v256i a, b;
+        const ui8 lanes = (ui8)(1 + (k + t) % 8);
+        for (int i = 0; i < 8; i++) {
+          a.ui[i] = t * 100000 + k * 8 + i;
+          b.ui[i] = i * 3 + t;
+        }
+        prism_job_result_t r =
+            prism_queue_submit_future(queue, PRISM_OPCODE_ADD_N,
+                                      PRISM_OPCODE_TYPE_UI32, lanes, &a, &b)
+                .get();
+        if (r.err != PR_OK) {
+          wrong++;
+          continue;
+        }
+        for (int i = 0; i < lanes; i++) {
+          if (r.value.ui[i] != a.ui[i] + b.ui[i]) {
+            wrong++;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  prism_queue_stats_t stats;
+  PRISM_CHECK_OK(prism_queue_stats(queue, &stats));
+  prism_queue_destroy(queue);
+
+  PRISM_CHECK(wrong == 0);
+  PRISM_CHECK(stats.jobs == THREADS * JOBS_PER_THREAD);
+  // Packing depends on how the threads interleave, never more than one
+  // operation per job
+  PRISM_CHECK(stats.device_ops > 0 && stats.device_ops <= stats.jobs);
+  printf("%u jobs, %u batches, %u device operations\n",
+         (unsigned)stats.jobs, (unsigned)stats.batches,
+         (unsigned)stats.device_ops);
+}
+
+// Compares are queued like the arithmetic
+static void test_compare(void) {
+  prism_queue_t *queue = 0;
+  PRISM_CHECK_OK(prism_queue_create(&dev, 4, 10, &queue));
+  if (queue == 0) {
+    return;
+  }
+
+  _v256i a, b;
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = i;
+    b.ui[i] = 3;
+  }
+  prism_job_result_t r =
+      prism_queue_submit_future(queue, PRISM_OPCODE_CMP_GT,
+                                PRISM_OPCODE_TYPE_UI32, 6, &a, &b)
+          .get();
+  prism_queue_destroy(queue);
+
+  PRISM_CHECK_OK(r.err);
+  for (int i = 0; i < 6; i++) {
+    PRISM_CHECK(r.value.ui[i] == (i > 3 ? 1U : 0U));
+  }
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_mixed_widths();
+  test_compare();
+  return PRISM_TEST_RESULT();
+}
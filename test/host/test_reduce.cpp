@@ -0,0 +1,83 @@
+// Device reductions against a host fold, with a ragged tail
+#include "prism/prism_reduce.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#define N 45
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static ui32 data[N];
+
+static ui32 expected(const prism_reduce_op_t op, const bool is_signed) {
+  ui32 r = data[0];
+  for (int i = 1; i < N; i++) {
+    const ui32 x = data[i];
+    switch (op) {
+    case PRISM_REDUCE_SUM:
+      r += x;
+      break;
+    case PRISM_REDUCE_MIN:
+      if (is_signed ? (si32)x < (si32)r : x < r) {
+        r = x;
+      }
+      break;
+    case PRISM_REDUCE_MAX:
+      if (is_signed ? (si32)x > (si32)r : x > r) {
+        r = x;
+      }
+      break;
+    case PRISM_REDUCE_AND:
+      r &= x;
+      break;
+    case PRISM_REDUCE_OR:
+      r |= x;
+      break;
+    default:
+      r ^= x;
+      break;
+    }
+  }
+  return r;
+}
+
+static void check_all(const char *features) {
+  for (int op = PRISM_REDUCE_SUM; op <= PRISM_REDUCE_XOR; op++) {
+    for (int s = 0; s < 2; s++) {
+      const ui8 type = s ? PRISM_OPCODE_TYPE_SI32 : PRISM_OPCODE_TYPE_UI32;
+      ui32 r = 0;
+      PRISM_CHECK_OK(prism_reduce_ui32(&dev, (prism_reduce_op_t)op, type,
+                                       data, N, &r, 10));
+      if (r != expected((prism_reduce_op_t)op, s)) {
+        printf("%s: op %d type %d gave %lu\n", features, op, type,
+               (unsigned long)r);
+        PRISM_CHECK(r == expected((prism_reduce_op_t)op, s));
+      }
+    }
+  }
+}
+
+static void test_short(void) {
+  ui32 r = 0;
+  PRISM_CHECK_OK(prism_reduce_max_si32(&dev, data, 5, &r, 10));
+  PRISM_CHECK(r == 0x7000000FUL);
+  PRISM_CHECK(prism_reduce_ui32(&dev, PRISM_REDUCE_SUM,
+                                PRISM_OPCODE_TYPE_UI32, data, 0, &r,
+                                10) == PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  for (int i = 0; i < N; i++) {
+    // Negative and positive signed values, large and small unsigned ones
+    data[i] = (i % 3 == 0) ? 0x80000000UL + i * 101 : 0x70000000UL + i * 3;
+  }
+  data[0] = 0x7000000FUL;
+  check_all("reported features");
+
+  dev.features = PRISM_FEATURES_BASE;
+  check_all("base features");
+  test_short();
+  return PRISM_TEST_RESULT();
+}
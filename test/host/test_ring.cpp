@@ -0,0 +1,132 @@
+// Sample ring and pipeline watermarks, and the ring between two threads
+#include "prism/prism_ring.h"
+#include "prism/prism_transport.h"
+
+#include "prism_internal.h"
+#include "prism_test.h"
+
+#include <thread>
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+struct window_check {
+  uint32_t samples;
+  ui16 next;
+  bool in_order;
+};
+
+// Every window must arrive in bank A and continue the sample sequence
+static prism_err check_window(const prdev_t *device, const _v256i *window,
+                              void *user) {
+  window_check *check = (window_check *)user;
+  _v256i bank;
+  PRISM_TRY(_prism_load_bank_ptr(device, PRISM_BANK_A, bank.ui, 10));
+  for (int i = 0; i < 16; i++) {
+    if (bank.uix[i] != window->uix[i] || bank.uix[i] != check->next) {
+      check->in_order = false;
+    }
+    check->next = (ui16)(bank.uix[i] + 1);
+    check->samples++;
+  }
+  return PR_OK;
+}
+
+static void test_init(void) {
+  ui16 buf[64];
+  prism_ring_t ring;
+  prism_pipeline_t pipeline;
+
+  PRISM_CHECK(prism_ring_init(&ring, buf, 48, PRISM_OPCODE_TYPE_UI16,
+                              PRISM_RING_DROP) == PR_ERR_INVALID_ARGUMENT);
+  PRISM_CHECK_OK(prism_ring_init(&ring, buf, 64, PRISM_OPCODE_TYPE_UI16,
+                                 PRISM_RING_DROP));
+  // high must hold at least one window
+  PRISM_CHECK(prism_pipeline_init(&pipeline, &ring, &dev, PRISM_BANK_A, 8, 0,
+                                  check_window, 0,
+                                  10) == PR_ERR_INVALID_ARGUMENT);
+}
+
+static void test_watermarks(void) {
+  ui16 buf[64];
+  prism_ring_t ring;
+  prism_pipeline_t pipeline;
+  window_check check = {0, 0, true};
+
+  PRISM_CHECK_OK(prism_ring_init(&ring, buf, 64, PRISM_OPCODE_TYPE_UI16,
+                                 PRISM_RING_DROP));
+  PRISM_CHECK_OK(prism_pipeline_init(&pipeline, &ring, &dev, PRISM_BANK_A, 48,
+                                     16, check_window, &check, 10));
+
+  for (int i = 0; i < 47; i++) {
+    prism_ring_push(&ring, i);
+  }
+  PRISM_CHECK_OK(prism_pipeline_pump(&pipeline));
+  PRISM_CHECK(pipeline.windows == 0); // Below the high watermark
+
+  prism_ring_push(&ring, 47);
+  PRISM_CHECK_OK(prism_pipeline_pump(&pipeline));
+  PRISM_CHECK(pipeline.windows == 2 && prism_ring_count(&ring) == 16);
+
+  for (int i = 48; i < 70; i++) {
+    prism_ring_push(&ring, i);
+  }
+  PRISM_CHECK_OK(prism_pipeline_pump(&pipeline));
+  PRISM_CHECK(pipeline.windows == 2); // Flush ended at the low watermark
+
+  PRISM_CHECK_OK(prism_pipeline_flush(&pipeline));
+  PRISM_CHECK(pipeline.windows == 4 && prism_ring_count(&ring) == 6);
+  PRISM_CHECK(check.samples == 64 && check.in_order);
+
+  // A full ring drops and counts
+  for (int i = 70; i < 200; i++) {
+    prism_ring_push(&ring, i);
+  }
+  prism_ring_stats_t stats;
+  prism_ring_stats(&ring, &stats);
+  PRISM_CHECK(stats.fill == 64 && stats.peak == 64);
+  PRISM_CHECK(stats.overruns == 200 - 70 - 58);
+
+  ui16 out[64];
+  PRISM_CHECK(prism_ring_read(&ring, out, 64) == 64);
+  PRISM_CHECK(out[0] == 64 && out[63] == 127); // Across the wrap
+}
+
+static void test_threads(void) {
+  const int total = 2000;
+  ui8 buf[32];
+  prism_ring_t ring;
+  PRISM_CHECK_OK(prism_ring_init(&ring, buf, 32, PRISM_OPCODE_TYPE_UI8,
+                                 PRISM_RING_BLOCK));
+
+  std::thread producer([&ring] {
+    for (int i = 0; i < total; i++) {
+      prism_ring_push(&ring, (ui8)i);
+    }
+  });
+
+  int received = 0;
+  bool in_order = true;
+  while (received < total) {
+    ui8 chunk[7];
+    const uint16_t n = prism_ring_read(&ring, chunk, sizeof(chunk));
+    for (uint16_t k = 0; k < n; k++) {
+      in_order &= (chunk[k] == (ui8)(received + k));
+    }
+    received += n;
+  }
+  producer.join();
+
+  prism_ring_stats_t stats;
+  prism_ring_stats(&ring, &stats);
+  PRISM_CHECK(in_order);
+  PRISM_CHECK(stats.pushed == (uint32_t)total && stats.overruns == 0);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_init();
+  test_watermarks();
+  test_threads();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,76 @@
+// prism_bus_scan reads the descriptor over the transport it is given
+#include "prism/prism.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <string.h>
+
+static prism_loopback_t emu;
+
+static void test_loopback_scan(void) {
+  prism_bus_entry_t found[2];
+  uint8_t count = 0;
+
+  // The emulation answers at every address, max ends the scan
+  memset(&emu, 0, sizeof(emu));
+  PRISM_CHECK_OK(prism_bus_scan_with(&prism_transport_loopback, &emu, 0x10,
+                                     0x13, found, 2, &count));
+  PRISM_CHECK(count == 2);
+  PRISM_CHECK(found[0].address == 0x10 && found[1].address == 0x11);
+  PRISM_CHECK(found[0].describe.protocol == PRISM_PROTOCOL_VERSION);
+  PRISM_CHECK(found[0].describe.major == PRISM_VERSION_MAJOR);
+  PRISM_CHECK(found[0].describe.features & PRISM_FEATURE_CRC);
+}
+
+// The loopback as firmware from before PRISM_OPCODE_ARCH_DESCRIBE
+static uint16_t last_op;
+
+static prism_err legacy_send_command(const prdev_t *dev, const uint8_t *frame,
+                                     size_t len) {
+  memcpy(&last_op, frame, sizeof(last_op));
+  return prism_transport_loopback.send_command(dev, frame, len);
+}
+
+static prism_err legacy_read_status(const prdev_t *dev, uint8_t *status) {
+  prism_err err = prism_transport_loopback.read_status(dev, status);
+  if (err == PR_OK && last_op == PRISM_OPCODE_ARCH_DESCRIBE) {
+    *status = PRISM_STATUS_FAIL;
+  }
+  return err;
+}
+
+static void test_legacy_scan(void) {
+  prism_transport_t legacy = prism_transport_loopback;
+  legacy.send_command = legacy_send_command;
+  legacy.read_status = legacy_read_status;
+  legacy.poll_status = 0;
+
+  prism_bus_entry_t found[1];
+  uint8_t count = 0;
+  memset(&emu, 0, sizeof(emu));
+  PRISM_CHECK_OK(
+      prism_bus_scan_with(&legacy, &emu, 0x20, 0x20, found, 1, &count));
+  PRISM_CHECK(count == 1 && found[0].address == 0x20);
+  PRISM_CHECK(found[0].describe.protocol == 0);
+  PRISM_CHECK(found[0].describe.major == PRISM_VERSION_MAJOR);
+  PRISM_CHECK(found[0].describe.features == PRISM_FEATURES_BASE);
+}
+
+static void test_nothing_on_i2c(void) {
+  // The stubbed bus acknowledges no address
+  prism_bus_entry_t found[1];
+  uint8_t count = 1;
+  PRISM_CHECK_OK(prism_bus_scan(PRISM_BUS_FIRST, PRISM_BUS_LAST, found, 1,
+                                &count));
+  PRISM_CHECK(count == 0);
+  PRISM_CHECK(prism_bus_scan_with(0, 0, 1, 2, found, 1, &count) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  test_loopback_scan();
+  test_legacy_scan();
+  test_nothing_on_i2c();
+  return PRISM_TEST_RESULT();
+}
@@ -0,0 +1,88 @@
+// Blend, min/max and clamp on the device against host results
+#include "prism/prism_select.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+static prism_loopback_t emu;
+static prdev_t dev;
+static _v256i a, b;
+
+static void check_c(const char *what, const ui32 *want) {
+  _v256i c;
+  PRISM_CHECK_OK(_prism_load_bank_ptr(&dev, PRISM_BANK_C, c.ui, 10));
+  for (int i = 0; i < 8; i++) {
+    if (c.ui[i] != want[i]) {
+      printf("%s: lane %d is %08lx, not %08lx\n", what, i,
+             (unsigned long)c.ui[i], (unsigned long)want[i]);
+      PRISM_CHECK(c.ui[i] == want[i]);
+      return;
+    }
+  }
+}
+
+static void test_blend(void) {
+  _v256i mask;
+  ui32 want[8];
+  for (int i = 0; i < 8; i++) {
+    mask.ui[i] = i & 1;
+    want[i] = mask.ui[i] ? a.ui[i] : b.ui[i];
+  }
+  PRISM_CHECK_OK(_v256_blend_ui32(&dev, &mask, &a, &b, 10));
+  check_c("blend", want);
+}
+
+static void test_minmax(void) {
+  ui32 want[8];
+  for (int i = 0; i < 8; i++) {
+    want[i] = a.ui[i] < b.ui[i] ? a.ui[i] : b.ui[i];
+  }
+  PRISM_CHECK_OK(_v256_min8_ui32(&dev, &a, &b, 10));
+  check_c("min ui32", want);
+
+  for (int i = 0; i < 8; i++) {
+    want[i] = a.si[i] > b.si[i] ? a.ui[i] : b.ui[i];
+  }
+  PRISM_CHECK_OK(_v256_max8_si32(&dev, &a, &b, 10));
+  check_c("max si32", want);
+}
+
+static void test_clamp(void) {
+  ui32 want[8];
+  for (int i = 0; i < 8; i++) {
+    const ui32 x = a.ui[i];
+    want[i] = x < 100 ? 100 : (x > 0x70000000UL ? 0x70000000UL : x);
+  }
+  PRISM_CHECK_OK(_v256_clamp8_ui32(&dev, &a, 100, 0x70000000UL, 10));
+  check_c("clamp ui32", want);
+
+  for (int i = 0; i < 8; i++) {
+    const si32 x = a.si[i];
+    want[i] = (ui32)(x < -5 ? -5 : (x > 1000 ? 1000 : x));
+  }
+  PRISM_CHECK_OK(_v256_clamp8_si32(&dev, &a, -5, 1000, 10));
+  check_c("clamp si32", want);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  const ui32 av[8] = {0,          7,           0x80000000UL, 0xFFFFFFFFUL,
+                      0x7FFFFFFF, 0x12345678UL, 500,          0xFFFFFFF0UL};
+  const ui32 bv[8] = {1,    7,           0x7FFFFFFFUL, 0,
+                      0x80, 0x87654321UL, 499,          0xFFFFFFF1UL};
+  for (int i = 0; i < 8; i++) {
+    a.ui[i] = av[i];
+    b.ui[i] = bv[i];
+  }
+
+  test_blend();
+  test_minmax();
+  test_clamp();
+
+  // Devices without immediates run the same kernels with emulated scalars
+  dev.features = PRISM_FEATURES_BASE;
+  test_blend();
+  test_minmax();
+  test_clamp();
+  return PRISM_TEST_RESULT();
+}
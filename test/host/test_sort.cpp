@@ -0,0 +1,130 @@
+// Sorting networks, array and batch sort, and top-k against qsort
+#include "prism/prism_sort.h"
+#include "prism/prism_transport.h"
+
+#include "prism_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define N 45
+
+static prism_loopback_t emu;
+static prdev_t dev;
+
+template <typename T> static int ascending(const void *x, const void *y) {
+  const T a = *(const T *)x, b = *(const T *)y;
+  return (a > b) - (a < b);
+}
+
+template <typename T>
+static bool sorted_like(const T *got, const T *in, const size_t n) {
+  T ref[64];
+  memcpy(ref, in, n * sizeof(T));
+  qsort(ref, n, sizeof(T), ascending<T>);
+  return memcmp(ref, got, n * sizeof(T)) == 0;
+}
+
+static void test_networks(const char *features) {
+  _v256i v, in;
+  for (int i = 0; i < 8; i++) {
+    in.si[i] = (i * 1103515245 + 12345) ^ (i << 29);
+  }
+  v = in;
+  PRISM_CHECK_OK(_v256_sort8_si32(&dev, &v, 10));
+  PRISM_CHECK(sorted_like(v.si, in.si, 8));
+  v = in;
+  PRISM_CHECK_OK(_v256_sort8_ui32(&dev, &v, 10));
+  PRISM_CHECK(sorted_like(v.ui, in.ui, 8));
+  v = in;
+  PRISM_CHECK_OK(_v256_sort16_si16(&dev, &v, 10));
+  PRISM_CHECK(sorted_like(v.six, in.six, 16));
+  v = in;
+  PRISM_CHECK_OK(_v256_sort32_ui8(&dev, &v, 10));
+  PRISM_CHECK(sorted_like(v.uib, in.uib, 32));
+  v = in;
+  PRISM_CHECK_OK(_v256_sort32_si8(&dev, &v, 10));
+  if (!sorted_like(v.sib, in.sib, 32)) {
+    printf("%s: sort32_si8\n", features);
+    PRISM_CHECK(sorted_like(v.sib, in.sib, 32));
+  }
+}
+
+static void test_arrays(const char *features) {
+  si32 in[N], data[N], scratch[N];
+  for (int i = 0; i < N; i++) {
+    in[i] = (i % 4 == 0) ? -i * 1000 : (i * 7919) % 501;
+  }
+  memcpy(data, in, sizeof(data));
+  PRISM_CHECK_OK(prism_sort_si32(&dev, data, N, scratch, 10));
+  if (!sorted_like(data, in, N)) {
+    printf("%s: sort_si32\n", features);
+    PRISM_CHECK(sorted_like(data, in, N));
+  }
+
+  ui16 in16[37], data16[37], scratch16[37];
+  for (int i = 0; i < 37; i++) {
+    in16[i] = (ui16)(i * 40503);
+  }
+  memcpy(data16, in16, sizeof(data16));
+  PRISM_CHECK_OK(prism_sort_ui16(&dev, data16, 37, scratch16, 10));
+  PRISM_CHECK(sorted_like(data16, in16, 37));
+
+  // Three arrays of 10 elements sorted independently
+  si8 batch[30], ref[30];
+  for (int i = 0; i < 30; i++) {
+    batch[i] = ref[i] = (si8)(i * 77 - 100);
+  }
+  PRISM_CHECK_OK(
+      prism_sort_batch(&dev, PRISM_OPCODE_TYPE_SI8, batch, 3, 10, 10));
+  for (int j = 0; j < 3; j++) {
+    PRISM_CHECK(sorted_like(&batch[10 * j], &ref[10 * j], 10));
+  }
+}
+
+static void test_topk(const char *features) {
+  si32 x[N], ref[N], out[8];
+  ui8 count = 0;
+  for (int i = 0; i < N; i++) {
+    x[i] = ref[i] = (i * 7919) % 1009 - 500;
+  }
+  qsort(ref, N, sizeof(si32), ascending<si32>);
+
+  prism_topk_t topk;
+  PRISM_CHECK_OK(prism_topk_init(&topk, &dev, PRISM_OPCODE_TYPE_SI32, 5, 10));
+
+  // Fewer elements than k so far
+  PRISM_CHECK_OK(prism_topk_push(&topk, x, 3));
+  PRISM_CHECK_OK(prism_topk_read(&topk, out, &count));
+  PRISM_CHECK(count == 3);
+
+  PRISM_CHECK_OK(prism_topk_push(&topk, &x[3], 20));
+  PRISM_CHECK_OK(prism_topk_push(&topk, &x[23], N - 23));
+  PRISM_CHECK_OK(prism_topk_read(&topk, out, &count));
+  PRISM_CHECK(count == 5);
+  for (int i = 0; i < 5; i++) {
+    if (out[i] != ref[N - 1 - i]) {
+      printf("%s: top[%d] = %ld\n", features, i, (long)out[i]);
+      PRISM_CHECK(out[i] == ref[N - 1 - i]);
+    }
+  }
+
+  prism_topk_reset(&topk);
+  PRISM_CHECK_OK(prism_topk_read(&topk, out, &count));
+  PRISM_CHECK(count == 0);
+  PRISM_CHECK(prism_topk_init(&topk, &dev, PRISM_OPCODE_TYPE_SI32, 9, 10) ==
+              PR_ERR_INVALID_ARGUMENT);
+}
+
+int main(void) {
+  PRISM_CHECK_OK(prism_device_create_loopback(&emu, &dev));
+  test_networks("reported features");
+  test_arrays("reported features");
+  test_topk("reported features");
+
+  dev.features = PRISM_FEATURES_BASE;
+  test_networks("base features");
+  test_arrays("base features");
+  test_topk("base features");
+  return PRISM_TEST_RESULT();
+}